@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "bench.h"
+#include "time.h"
+
+bench_node* bench_list;
+
+void (*setup_fn)() = nullptr;
+
+volatile u64 bench_sink = 0;
+
+double bench_seconds() {
+    return double(clock()) / CLOCKS_PER_SEC;
+}
+
+void report(const char* what, u64 count, const char* unit, double seconds) {
+    double rate = seconds > 0 ? count / seconds : 0;
+    println("    ", what, ": ", count, " ", unit, " in ", seconds * 1000, " ms (", 
+        u64(rate), " ", unit, "/s)");
+}
+
+int main(int argc, char** argv) {
+    if (setup_fn) setup_fn();
+
+    bench_node* list = nullptr; // benchmarks are registered in reverse, so flip them back
+    while (bench_list) {
+        bench_node* next = bench_list->next;
+        bench_list->next = list;
+        list = bench_list;
+        bench_list = next;
+    }
+
+    println("---------------- ", (const char*)argv[0], " ----------------");
+    for (bench_node* node = list; node; node = node->next) {
+        println("Running benchmark '", node->name, "'...");
+        node->callback();
+    }
+    println("---------------- ", (const char*)argv[0], " ----------------");
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef BASIL_BENCH_H
+#define BASIL_BENCH_H
+
+#include "util/defs.h"
+#include "util/io.h"
+#include "util/ustr.h"
+
+struct bench_node {
+    ustring name;
+    void(*callback)();
+    bench_node* next;
+};
+
+extern bench_node* bench_list;
+extern void (*setup_fn)();
+
+// Results are accumulated here, so the compiler can't throw away the work being measured.
+extern volatile u64 bench_sink;
+
+int main(int argc, char** argv);
+
+// Returns the processor time used so far, in seconds.
+double bench_seconds();
+
+// Prints how long it took to process 'count' of something, and the resulting rate.
+void report(const char* what, u64 count, const char* unit, double seconds);
+
+#define BENCH(name) void __bench_##name(); \
+    auto __dummy_##name = (bench_list = new bench_node{#name, __bench_##name, bench_list}); \
+    void __bench_##name()
+
+#define SETUP void __setup_fn(); auto __setup_dummy = (setup_fn = __setup_fn); void __setup_fn() 
+
+#endif
@@ -0,0 +1,104 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "driver.h"
+#include "eval.h"
+#include "env.h"
+#include "type.h"
+#include "bench.h"
+
+using namespace basil;
+
+SETUP {
+    init();
+}
+
+// These exercise the compiler phases that lean hardest on hashing: symbol interning,
+// type interning, and evaluation, which looks up every name through its environments.
+
+BENCH(intern_symbols) {
+    static const u32 N = 1 << 17;
+    vector<ustring> names;
+    for (u32 i = 0; i < N; i ++) names.push(format<ustring>("name-", i * 2654435761u));
+
+    double start = bench_seconds();
+    for (u32 i = 0; i < N; i ++) bench_sink += symbol_from(names[i]).id;
+    report("new symbols", N, "symbols", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u32 r = 0; r < 8; r ++) for (u32 i = 0; i < N; i ++) bench_sink += symbol_from(names[i]).id;
+    report("existing symbols", 8 * N, "symbols", bench_seconds() - start);
+}
+
+BENCH(intern_types) {
+    static const u32 N = 1 << 12;
+    Type bases[] = { T_INT, T_FLOAT, T_DOUBLE, T_BOOL, T_CHAR, T_STRING, T_SYMBOL, T_VOID };
+
+    double start = bench_seconds();
+    u64 count = 0;
+    for (u32 r = 0; r < 16; r ++) for (u32 i = 0; i < N; i ++) {
+        Type a = bases[i % 8], b = bases[i / 8 % 8], c = bases[i / 64 % 8];
+        Type t = t_func(t_tuple(a, b, t_list(c)), t_array(a, i / 512 + 1));
+        bench_sink += t.id;
+        count ++;
+    }
+    report("compound types", count, "types", bench_seconds() - start);
+}
+
+BENCH(lex_parse_eval) {
+    buffer b; // a long chain of definitions, each using the ones before it
+    writeln(b, "do:");
+    for (u32 i = 0; i < 2000; i ++) {
+        if (i < 2) writeln(b, "    def bench-", i, " = ", i);
+        else writeln(b, "    def bench-", i, " = bench-", i - 1, " + bench-", i - 2, " - bench-", i - 1);
+    }
+    writeln(b, "    bench-1999");
+    rc<Source> src = ref<Source>(b);
+
+    double lex_secs = 0, parse_secs = 0, eval_secs = 0;
+    u64 terms = 0;
+    for (u32 r = 0; r < 16; r ++) {
+        double start = bench_seconds();
+        vector<Token> tokens = lex_step(src);
+        double lexed = bench_seconds();
+        Value program = parse_step(tokens);
+        double parsed = bench_seconds();
+        rc<Env> env = extend(root_env());
+        resolve_form(env, program);
+        bench_sink += eval(env, program).data.i;
+        double evaluated = bench_seconds();
+        lex_secs += lexed - start, parse_secs += parsed - lexed, eval_secs += evaluated - parsed;
+        terms += 2000;
+    }
+    report("lex", terms, "defs", lex_secs);
+    report("parse", terms, "defs", parse_secs);
+    report("eval", terms, "defs", eval_secs);
+}
+
+BENCH(value_table) {
+    // compile-time dicts and match dispatch key maps on values, whose hashes mix word-sized
+    // fields like kinds, ids and integers
+    static const u32 N = 1 << 16;
+    vector<Value> keys;
+    for (u32 i = 0; i < N; i ++) {
+        if (i % 2) keys.push(v_int({}, i * 2654435761u));
+        else keys.push(v_symbol({}, symbol_from(format<ustring>("key-", i))));
+    }
+
+    map<Value, u64> m;
+    double start = bench_seconds();
+    for (u32 i = 0; i < N; i ++) m.put(keys[i], i);
+    report("insert", N, "keys", bench_seconds() - start);
+
+    u64 found = 0;
+    start = bench_seconds();
+    for (u32 r = 0; r < 8; r ++) for (u32 i = 0; i < N; i ++) found += m.find(keys[i])->second;
+    report("find", 8 * N, "keys", bench_seconds() - start);
+    bench_sink += found;
+}
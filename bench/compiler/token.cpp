@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "token.h"
+#include "source.h"
+#include "driver.h"
+#include "bench.h"
+
+using namespace basil;
+
+SETUP {
+    init();
+}
+
+static const char* EXAMPLES[] = {
+    "example/assoc.bl", "example/branch.bl", "example/expr.bl", "example/factorial.bl", 
+    "example/fib.bl", "example/list.bl", "example/macro.bl", "example/match.bl", 
+    "example/modules.bl", "example/mutual.bl", "example/named.bl", "example/rational.bl", 
+    "example/sieve.bl", "example/test.bl", "example/union.bl", "example/variadic.bl"
+};
+
+static u64 source_bytes(const Source& src) {
+    u64 bytes = 0;
+    for (u32 i = 0; i < src.size(); i ++) bytes += src[i].bytes();
+    return bytes;
+}
+
+// Lexes the whole source 'reps' times, and reports the token and byte throughput.
+static void lex_repeatedly(const char* what, const Source& src, u32 reps) {
+    u64 tokens = 0;
+    double start = bench_seconds();
+    for (u32 r = 0; r < reps; r ++) {
+        Source::View view(src);
+        tokens += lex_all(view).size();
+    }
+    double secs = bench_seconds() - start;
+    report(what, tokens, "tokens", secs);
+    println("        (", u64(source_bytes(src) * reps / secs / (1 << 20)), " MB/s)");
+}
+
+BENCH(lex_examples) {
+    buffer b; // lex all the examples as one source, so small files don't dominate with setup
+    for (const char* path : EXAMPLES) {
+        Source src(path);
+        for (u32 i = 0; i < src.size(); i ++) write(b, src[i]);
+        write(b, '\n');
+    }
+    Source all(b);
+    lex_repeatedly("example/", all, 500);
+}
+
+BENCH(lex_synthetic) {
+    buffer b; // about a megabyte of typical code, with a few non-ASCII identifiers mixed in
+    for (u32 i = 0; i < 16384; i ++) {
+        writeln(b, "def (fn-", i, " x? y?) = x * ", i, " + (y length) - 3.25 # comment ", i);
+        writeln(b, "    if [x y] == (list 'a' \"str-", i, "\" :sym) then λ-", i, " else x.y");
+    }
+    Source src(b);
+    lex_repeatedly("synthetic", src, 4);
+}
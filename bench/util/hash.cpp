@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "util/hash.h"
+#include "util/vec.h"
+#include "bench.h"
+
+static const u64 N = 1 << 20;
+
+// Spreads out consecutive integers, so keys don't arrive in hash order.
+static u64 scramble(u64 i) {
+    return i * 0x9e3779b97f4a7c15ul ^ i >> 7;
+}
+
+BENCH(set_u64) {
+    set<u64> s;
+    double start = bench_seconds();
+    for (u64 i = 0; i < N; i ++) s.insert(scramble(i));
+    report("insert", N, "keys", bench_seconds() - start);
+
+    u64 found = 0;
+    start = bench_seconds();
+    for (u64 i = 0; i < N; i ++) found += s.contains(scramble(i));
+    report("find (present)", N, "keys", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u64 i = N; i < 2 * N; i ++) found += s.contains(scramble(i));
+    report("find (absent)", N, "keys", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u64 i = 0; i < N; i += 2) s.erase(scramble(i));
+    report("erase", N / 2, "keys", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u64 i = 0; i < N; i ++) found += s.contains(scramble(i)); // probes past deleted slots
+    report("find (after erase)", N, "keys", bench_seconds() - start);
+    bench_sink += found;
+}
+
+BENCH(map_ustring) {
+    static const u64 M = N / 8;
+    vector<ustring> keys;
+    for (u64 i = 0; i < M; i ++) keys.push(format<ustring>("symbol-", scramble(i) % 1000000007));
+
+    map<ustring, u64> m;
+    double start = bench_seconds();
+    for (u64 i = 0; i < M; i ++) m.put(keys[i], i);
+    report("insert", M, "keys", bench_seconds() - start);
+
+    u64 found = 0;
+    start = bench_seconds();
+    for (u32 r = 0; r < 8; r ++) for (u64 i = 0; i < M; i ++) found += m.find(keys[i])->second;
+    report("find", 8 * M, "keys", bench_seconds() - start);
+    bench_sink += found;
+}
+
+BENCH(map_copy) {
+    // maps are copied whenever environments and tables are, so this matters too
+    map<u64, u64> m;
+    for (u64 i = 0; i < N / 16; i ++) m.put(scramble(i), i);
+    double start = bench_seconds();
+    for (u32 r = 0; r < 64; r ++) {
+        map<u64, u64> copy = m;
+        bench_sink += copy.size();
+    }
+    report("copy", 64 * (N / 16), "entries", bench_seconds() - start);
+}
+
+BENCH(raw_hash) {
+    static u8 bytes[4096];
+    for (u32 i = 0; i < sizeof(bytes); i ++) bytes[i] = scramble(i);
+    u32 sizes[] = { 4, 8, 16, 64, 4096 };
+    for (u32 size : sizes) {
+        u64 h = 0, total = 0;
+        u64 reps = (64ul << 20) / size; // hash about 64MB of input at each size
+        double start = bench_seconds();
+        for (u64 i = 0; i < reps; i ++) {
+            bytes[0] = i; // keep the input changing between calls
+            h ^= raw_hash(bytes, size);
+            total += size;
+        }
+        double secs = bench_seconds() - start;
+        bench_sink += h;
+        println("    ", size, "-byte inputs: ", reps, " hashes in ", secs * 1000, " ms (", 
+            u64(total / secs / (1 << 20)), " MB/s)");
+    }
+}
+
+BENCH(hash_words) {
+    // hash<u64> and hash<u32> are the identity, so measure the word_hash fast path that
+    // raw_hash takes for word-sized values, against hashing the same bytes in general
+    u64 h = 0;
+    double start = bench_seconds();
+    for (u64 i = 0; i < 16 * N; i ++) h ^= raw_hash(i);
+    report("u64", 16 * N, "hashes", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u64 i = 0; i < 16 * N; i ++) h ^= raw_hash(&i, sizeof(i));
+    report("u64 as bytes", 16 * N, "hashes", bench_seconds() - start);
+
+    start = bench_seconds();
+    for (u32 i = 0; i < 16 * N; i ++) h ^= raw_hash(i);
+    report("u32", 16 * N, "hashes", bench_seconds() - start);
+    bench_sink += h;
+}
@@ -72,7 +72,7 @@ for ar in SUPPORTED_ARCHIVERS:
 
 # Finally, we'll parse the program arguments, overriding our defaults if specified.
 
-PRODUCTS = ["basil-release", "basil-debug", "librt-static", "librt-dynamic", "jasmine-release", "jasmine-debug", "test"]
+PRODUCTS = ["basil-release", "basil-debug", "librt-static", "librt-dynamic", "jasmine-release", "jasmine-debug", "test", "bench"]
 
 import argparse
 parser = argparse.ArgumentParser(description="Build an artifact from the Basil or Jasmine projects.")
@@ -155,6 +155,8 @@ if CXXTYPE in {"clang", "gcc", "intel"}:
         CXXFLAGS += ["-fno-unwind-tables", "-fno-asynchronous-unwind-tables", "-Os", "-DBASIL_RELEASE"]
     elif "debug" in TARGET:
         CXXFLAGS += ["-g3", "-O0"]
+    elif TARGET == "bench":
+        CXXFLAGS += ["-O2", "-DBASIL_RELEASE", "-Ibench"]
     elif "librt" in TARGET:
         CXXFLAGS += ["-nostdlib", "-fno-builtin", "-fno-unwind-tables", "-fno-asynchronous-unwind-tables", "-Os", "-DBASIL_RELEASE"]
     if TARGET == "librt-dynamic":
@@ -169,6 +171,8 @@ elif CXXTYPE == "msvc":
         CXXFLAGS += ["/Os", "/Oy", "/O1", "/DBASIL_RELEASE"]
     elif "debug" in TARGET:
         CXXFLAGS += ["/Z7", "/Od"]
+    elif TARGET == "bench":
+        CXXFLAGS += ["/O2", "/DBASIL_RELEASE", "/I bench"]
     if TARGET == "librt-dynamic":
         LDFLAGS.append("/Ld")
 
@@ -234,6 +238,7 @@ RUNTIME_SRCS = glob.glob("runtime/*.cpp")
 # We compute object file names for each C++ source.
 
 OBJ_EXT = ".obj" if CXXTYPE == "msvc" else ".o"
+if TARGET == "bench": OBJ_EXT = ".bench" + OBJ_EXT # benchmarks are optimized, so keep their objects separate
 
 COMPILER_OBJS = {src : os.path.splitext(src)[0] + OBJ_EXT for src in COMPILER_SRCS}
 JASMINE_OBJS = {src : os.path.splitext(src)[0] + OBJ_EXT for src in JASMINE_SRCS}
@@ -286,10 +291,12 @@ PRODUCTS_BY_TARGET = {
         "MSYS": "bin/basil.exe",
         "MinGW": "bin/basil.exe"
     }[OS],
-    "test": "" # tests use different targets
+    "test": "", # tests use different targets
+    "bench": "" # ...as do benchmarks
 }
 
 TEST_PRODUCTS = [os.path.splitext(test)[0] + ".test" for test in glob.glob("test/**/*.cpp")]
+BENCH_PRODUCTS = [os.path.splitext(bench)[0] + ".bench" for bench in glob.glob("bench/**/*.cpp")]
 
 # This table defines which objects we need to build our desired target.
 
@@ -308,7 +315,8 @@ OBJS_BY_TARGET = {
     "jasmine-release": [JASMINE_SRCS, UTIL_OBJS],
     "basil-debug": [COMPILER_OBJS, JASMINE_OBJS, RUNTIME_OBJS, UTIL_OBJS],
     "basil-release": [COMPILER_OBJS, JASMINE_OBJS, RUNTIME_OBJS, UTIL_OBJS],
-    "test": [COMPILER_OBJS, JASMINE_OBJS, RUNTIME_OBJS, UTIL_OBJS]
+    "test": [COMPILER_OBJS, JASMINE_OBJS, RUNTIME_OBJS, UTIL_OBJS],
+    "bench": [COMPILER_OBJS, JASMINE_OBJS, RUNTIME_OBJS, UTIL_OBJS]
 }
 
 # Now that we've computed all the object and target names, let's clean up any existing ones
@@ -335,6 +343,10 @@ if CLEAN:
         if os.path.exists(test): 
             if VERBOSE: print("Removing '" + test + "'.")
             os.remove(test)
+    for bench in BENCH_PRODUCTS: 
+        if os.path.exists(bench): 
+            if VERBOSE: print("Removing '" + bench + "'.")
+            os.remove(bench)
     shutil.rmtree("bin/")
 
 # We determine which objects are needed by our target...
@@ -370,7 +382,7 @@ if os.path.isfile("bin"):
 TASKS = []
 PRODUCT = PRODUCTS_BY_TARGET[TARGET]
 
-if TARGET in {"librt-static", "librt-dynamic", "basil-debug", "jasmine-debug", "test"}:
+if TARGET in {"librt-static", "librt-dynamic", "basil-debug", "jasmine-debug", "test", "bench"}:
     for src in RECOMPILED_OBJS:
         TASKS.append(cxx_compile_object_cmd(src, RECOMPILED_OBJS[src]))
 
@@ -395,6 +407,15 @@ if TARGET in {"test"}:
     for test_exec in TEST_PRODUCTS:
         TASKS.append(test_exec)
 
+if TARGET in {"bench"}:
+    for bench_exec in BENCH_PRODUCTS:
+        srcs = {os.path.splitext(bench_exec)[0] + ".cpp", "bench/bench.cpp"}
+        srcs = srcs.union(OBJS.values())
+        if not os.path.exists(bench_exec) or len(RECOMPILED_OBJS) > 0: 
+            TASKS.append(cxx_compile_all_cmd(srcs, bench_exec))
+    for bench_exec in BENCH_PRODUCTS:
+        TASKS.append(bench_exec)
+
 errors = 0
 for task in TASKS:
     if VERBOSE: print(task)
@@ -60,7 +60,7 @@ namespace basil {
                 if (t.of(K_INTERSECT)) {
                     vector<Type> valid;
                     for (Type t : t_intersect_members(t)) valid.push(t);
-                    auto resolved = resolve_call(env, valid, args_type);
+                    auto resolved = resolve_call(env, t, valid, args_type);
                     if (resolved.is_right() && resolved.right().ambiguous) {
                         t_unbind(args_type);
                         if (!t_is_concrete(args_type)) {
@@ -401,7 +401,7 @@ namespace basil {
 
         IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
             auto val = env->find(name);
-            if (val) {
+            if (val && val->type.of(K_RUNTIME)) {
                 auto ast = val->data.rt->ast;
                 if (ast->kind() == AST_FUNCTION || ast->kind() == AST_FUNCTION_STUB) 
                     return ast->gen_ssa(env, func);
@@ -1180,9 +1180,8 @@ namespace basil {
                 ir_func = ref<IRFunction>(name, type(outer_env));
                 for (u32 i = 0; i < args.size(); i ++) {
                     IRParam dst = ir_var(ir_func, args[i]);
-                    ir_func->add_insn(
-                        ir_arg(ir_func, env->find(args[i])->data.rt->ast->type(outer_env), dst, i)
-                    );
+                    rc<AST> arg = env->find(args[i])->data.rt->ast;
+                    ir_func->add_insn(ir_arg(ir_func, arg->type(outer_env), dst, i));
                 }
                 IRParam returned = operand()->gen_ssa(env, ir_func);
                 ir_func->finish(operand()->type(env), returned);
@@ -1272,6 +1271,425 @@ namespace basil {
         return ref<ASTOverload>(pos, type, cases);
     }
 
+    // Arrays
+
+    struct ASTArray : public AST {
+        vector<rc<AST>> child;
+
+        ASTArray(Source::Pos pos, Type type, const vector<rc<AST>>& elements):
+            AST(pos, AST_ARRAY, type), child(elements) {}
+
+        const rc<AST>* begin() const override {
+            return child.begin();
+        }
+
+        const rc<AST>* end() const override {
+            return child.end();
+        }
+
+        void format(stream& io) const override {
+            write(io, "(array");
+            for (const rc<AST>& expr : child) write(io, " ", expr);
+            write(io, ")");
+        }
+
+        rc<AST> clone() const override {
+            vector<rc<AST>> cloned_elements;
+            for (const rc<AST>& expr : child) cloned_elements.push(expr->clone());
+            return ref<ASTArray>(pos, t, cloned_elements);
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                // elements take the type of the first, or the declared type if there are none
+                Type elt = child.size() ? child[0]->type(env) : t_array_element(t);
+                for (rc<AST> expr : child) {
+                    Type expr_type = expr->type(env);
+                    if (expr_type == T_ERROR) return cached_type = T_ERROR;
+                    if (!expr_type.coerces_to(elt)) {
+                        err(expr->pos, "Array element of type '", expr_type, "' is incompatible with ",
+                            "element type '", elt, "'.");
+                        return cached_type = T_ERROR;
+                    }
+                }
+                cached_type = t_array(elt);
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            Type elt = t_array_element(type(env));
+            IRParam array = func->add_insn(ir_new_array(func, type(env), ir_int(child.size())));
+            for (u32 i = 0; i < child.size(); i ++)
+                func->add_insn(ir_store_index(func, elt, array, ir_int(i), child[i]->gen_ssa(env, func)));
+            return array;
+        }
+    };
+
+    rc<AST> ast_array(Source::Pos pos, Type type, const vector<rc<AST>>& elements) {
+        return ref<ASTArray>(pos, type, elements);
+    }
+
+    // Reports an error and returns false if the provided type isn't a runtime array.
+    static bool expect_array(Source::Pos pos, Type type) {
+        if (type == T_ERROR) return false;
+        if (!type.of(K_ARRAY)) {
+            err(pos, "Expected runtime array, found value of type '", type, "'.");
+            return false;
+        }
+        return true;
+    }
+
+    // Reports an error and returns false if the provided type can't be used as an array index.
+    static bool expect_index(Source::Pos pos, Type type) {
+        if (type == T_ERROR) return false;
+        if (!type.coerces_to(T_INT)) {
+            err(pos, "Expected integer array index, found value of type '", type, "'.");
+            return false;
+        }
+        return true;
+    }
+
+    struct ASTArrayAt : public ASTBinary {
+        ASTArrayAt(Source::Pos pos, rc<AST> array, rc<AST> index):
+            ASTBinary(pos, AST_ARRAY_AT, T_ANY, array, index) {}
+
+        void format(stream& io) const override {
+            write(io, "(at ", left(), " ", right(), ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTArrayAt>(pos, left()->clone(), right()->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                Type array = left()->type(env);
+                if (!expect_array(left()->pos, array) || !expect_index(right()->pos, right()->type(env)))
+                    cached_type = T_ERROR;
+                else cached_type = t_array_element(array);
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            return func->add_insn(ir_load_index(func, type(env), left()->gen_ssa(env, func), 
+                right()->gen_ssa(env, func)));
+        }
+    };
+
+    rc<AST> ast_array_at(Source::Pos pos, rc<AST> array, rc<AST> index) {
+        return ref<ASTArrayAt>(pos, array, index);
+    }
+
+    struct ASTArrayLength : public ASTUnary {
+        ASTArrayLength(Source::Pos pos, rc<AST> array):
+            ASTUnary(pos, AST_ARRAY_LENGTH, T_INT, array) {}
+
+        void format(stream& io) const override {
+            write(io, "(length ", operand(), ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTArrayLength>(pos, operand()->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+                cached_type = expect_array(operand()->pos, operand()->type(env)) ? T_INT : T_ERROR;
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            return func->add_insn(ir_array_length(func, operand()->gen_ssa(env, func)));
+        }
+    };
+
+    rc<AST> ast_array_length(Source::Pos pos, rc<AST> array) {
+        return ref<ASTArrayLength>(pos, array);
+    }
+
+    struct ASTArrayStore : public AST {
+        rc<AST> child[3];
+
+        ASTArrayStore(Source::Pos pos, rc<AST> array, rc<AST> index, rc<AST> value):
+            AST(pos, AST_ARRAY_STORE, T_VOID) {
+            child[0] = array;
+            child[1] = index;
+            child[2] = value;
+        }
+
+        const rc<AST>* begin() const override {
+            return child;
+        }
+
+        const rc<AST>* end() const override {
+            return begin() + 3;
+        }
+
+        void format(stream& io) const override {
+            write(io, "(= (at ", child[0], " ", child[1], ") ", child[2], ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTArrayStore>(pos, child[0]->clone(), child[1]->clone(), child[2]->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                Type array = child[0]->type(env), value = child[2]->type(env);
+                if (!expect_array(child[0]->pos, array) || !expect_index(child[1]->pos, child[1]->type(env))
+                    || value == T_ERROR) return cached_type = T_ERROR;
+                if (!value.coerces_to(t_array_element(array))) {
+                    err(child[2]->pos, "Cannot store value of type '", value, "' in array of type '", 
+                        array, "'.");
+                    return cached_type = T_ERROR;
+                }
+                cached_type = T_VOID;
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            IRParam array = child[0]->gen_ssa(env, func), index = child[1]->gen_ssa(env, func);
+            func->add_insn(ir_store_index(func, t_array_element(child[0]->type(env)), 
+                array, index, child[2]->gen_ssa(env, func)));
+            return ir_none();
+        }
+    };
+
+    rc<AST> ast_array_store(Source::Pos pos, rc<AST> array, rc<AST> index, rc<AST> value) {
+        return ref<ASTArrayStore>(pos, array, index, value);
+    }
+
+    // Dictionaries
+
+    // Reports an error and returns false if the provided type can't be the key type of a
+    // runtime dictionary.
+    static bool expect_key_type(Source::Pos pos, Type type) {
+        if (type == T_ERROR) return false;
+        if (type != T_INT && type != T_SYMBOL && type != T_STRING) {
+            err(pos, "Runtime dictionary keys must be integers, symbols or strings, but found key ",
+                "of type '", type, "'.");
+            return false;
+        }
+        return true;
+    }
+
+    struct ASTDict : public AST {
+        vector<rc<AST>> child; // alternating keys and values
+
+        ASTDict(Source::Pos pos, Type type, const vector<rc<AST>>& entries):
+            AST(pos, AST_DICT, type), child(entries) {}
+
+        const rc<AST>* begin() const override {
+            return child.begin();
+        }
+
+        const rc<AST>* end() const override {
+            return child.end();
+        }
+
+        void format(stream& io) const override {
+            write(io, "(dict");
+            for (const rc<AST>& expr : child) write(io, " ", expr);
+            write(io, ")");
+        }
+
+        rc<AST> clone() const override {
+            vector<rc<AST>> cloned_entries;
+            for (const rc<AST>& expr : child) cloned_entries.push(expr->clone());
+            return ref<ASTDict>(pos, t, cloned_entries);
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                // like arrays, entries take the types of the first, or the declared types if there are none
+                Type key = child.size() ? child[0]->type(env) : t_dict_key(t),
+                    value = child.size() ? child[1]->type(env) : t_dict_value(t);
+                if (!expect_key_type(child.size() ? child[0]->pos : pos, key)) return cached_type = T_ERROR;
+                if (value == T_VOID) {
+                    err(pos, "Runtime dictionaries must have values; sets are not supported.");
+                    return cached_type = T_ERROR;
+                }
+                for (u32 i = 0; i < child.size(); i ++) {
+                    Type expr_type = child[i]->type(env), expected = i % 2 ? value : key;
+                    if (expr_type == T_ERROR) return cached_type = T_ERROR;
+                    if (!expr_type.coerces_to(expected)) {
+                        err(child[i]->pos, "Dictionary ", i % 2 ? "value" : "key", " of type '", expr_type, 
+                            "' is incompatible with ", i % 2 ? "value" : "key", " type '", expected, "'.");
+                        return cached_type = T_ERROR;
+                    }
+                }
+                cached_type = t_dict(key, value);
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            Type dict_type = type(env);
+            IRParam dict = func->add_insn(ir_new_dict(func, dict_type, ir_int(child.size() / 2)));
+            for (u32 i = 0; i < child.size(); i += 2) {
+                IRParam key = child[i]->gen_ssa(env, func);
+                func->add_insn(ir_dict_put(func, dict_type, dict, key, child[i + 1]->gen_ssa(env, func)));
+            }
+            return dict;
+        }
+    };
+
+    rc<AST> ast_dict(Source::Pos pos, Type type, const vector<rc<AST>>& entries) {
+        return ref<ASTDict>(pos, type, entries);
+    }
+
+    // Reports an error and returns false if the provided type isn't a runtime dictionary.
+    static bool expect_dict(Source::Pos pos, Type type) {
+        if (type == T_ERROR) return false;
+        if (!type.of(K_DICT)) {
+            err(pos, "Expected runtime dictionary, found value of type '", type, "'.");
+            return false;
+        }
+        return true;
+    }
+
+    // Reports an error and returns false if 'key' can't be used to look up entries in 'dict'.
+    static bool expect_key(Source::Pos pos, Type dict, Type key) {
+        if (key == T_ERROR) return false;
+        if (!key.coerces_to(t_dict_key(dict))) {
+            err(pos, "Expected dictionary key of type '", t_dict_key(dict), "', found value of type '", 
+                key, "'.");
+            return false;
+        }
+        return true;
+    }
+
+    struct ASTDictAt : public ASTBinary {
+        ASTDictAt(Source::Pos pos, rc<AST> dict, rc<AST> key):
+            ASTBinary(pos, AST_DICT_AT, T_ANY, dict, key) {}
+
+        void format(stream& io) const override {
+            write(io, "(at ", left(), " ", right(), ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTDictAt>(pos, left()->clone(), right()->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                Type dict = left()->type(env);
+                if (!expect_dict(left()->pos, dict) || !expect_key(right()->pos, dict, right()->type(env)))
+                    cached_type = T_ERROR;
+                else cached_type = t_dict_value(dict);
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            return func->add_insn(ir_dict_at(func, left()->type(env), left()->gen_ssa(env, func), 
+                right()->gen_ssa(env, func)));
+        }
+    };
+
+    rc<AST> ast_dict_at(Source::Pos pos, rc<AST> dict, rc<AST> key) {
+        return ref<ASTDictAt>(pos, dict, key);
+    }
+
+    struct ASTDictLength : public ASTUnary {
+        ASTDictLength(Source::Pos pos, rc<AST> dict):
+            ASTUnary(pos, AST_DICT_LENGTH, T_INT, dict) {}
+
+        void format(stream& io) const override {
+            write(io, "(length ", operand(), ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTDictLength>(pos, operand()->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+                cached_type = expect_dict(operand()->pos, operand()->type(env)) ? T_INT : T_ERROR;
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            // dictionaries keep their entry count in their first word, just like arrays
+            return func->add_insn(ir_array_length(func, operand()->gen_ssa(env, func)));
+        }
+    };
+
+    rc<AST> ast_dict_length(Source::Pos pos, rc<AST> dict) {
+        return ref<ASTDictLength>(pos, dict);
+    }
+
+    struct ASTDictPut : public AST {
+        rc<AST> child[3];
+
+        ASTDictPut(Source::Pos pos, rc<AST> dict, rc<AST> key, rc<AST> value):
+            AST(pos, AST_DICT_PUT, T_VOID) {
+            child[0] = dict;
+            child[1] = key;
+            child[2] = value;
+        }
+
+        const rc<AST>* begin() const override {
+            return child;
+        }
+
+        const rc<AST>* end() const override {
+            return begin() + 3;
+        }
+
+        void format(stream& io) const override {
+            write(io, "(= (at ", child[0], " ", child[1], ") ", child[2], ")");
+        }
+
+        rc<AST> clone() const override {
+            return ref<ASTDictPut>(pos, child[0]->clone(), child[1]->clone(), child[2]->clone());
+        }
+
+        Type type(rc<Env> env) override {
+            if (!resolved) {
+                resolved = true;
+
+                Type dict = child[0]->type(env), value = child[2]->type(env);
+                if (!expect_dict(child[0]->pos, dict) || !expect_key(child[1]->pos, dict, child[1]->type(env))
+                    || value == T_ERROR) return cached_type = T_ERROR;
+                if (!value.coerces_to(t_dict_value(dict))) {
+                    err(child[2]->pos, "Cannot store value of type '", value, "' in dictionary of type '", 
+                        dict, "'.");
+                    return cached_type = T_ERROR;
+                }
+                cached_type = T_VOID;
+            }
+            return cached_type;
+        }
+
+        IRParam gen_ssa(rc<Env> env, rc<IRFunction> func) override {
+            IRParam dict = child[0]->gen_ssa(env, func), key = child[1]->gen_ssa(env, func);
+            func->add_insn(ir_dict_put(func, child[0]->type(env), dict, key, child[2]->gen_ssa(env, func)));
+            return ir_none();
+        }
+    };
+
+    rc<AST> ast_dict_put(Source::Pos pos, rc<AST> dict, rc<AST> key, rc<AST> value) {
+        return ref<ASTDictPut>(pos, dict, key, value);
+    }
+
     // Mutation
 
     struct ASTAssign : public ASTBinary {
@@ -1355,7 +1773,7 @@ namespace basil {
                 overloads.push(overload);
 
             Type args_type = arg_types.size() == 1 ? arg_types[0] : t_tuple(arg_types);
-            auto call = resolve_call(env, overloads, args_type);
+            auto call = resolve_call(env, overload->t, overloads, args_type);
             if (call.is_left()) { // if the call was resolved
                 const auto& cases = ((rc<ASTOverload>)overload)->cases;
                 auto it = cases.find(call.left());
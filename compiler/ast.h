@@ -28,6 +28,8 @@ namespace basil {
         AST_ADD, AST_SUB, AST_MUL, AST_DIV, AST_REM,
         AST_AND, AST_OR, AST_XOR, AST_NOT,
         AST_HEAD, AST_TAIL, AST_CONS,
+        AST_ARRAY, AST_ARRAY_AT, AST_ARRAY_LENGTH, AST_ARRAY_STORE,
+        AST_DICT, AST_DICT_AT, AST_DICT_LENGTH, AST_DICT_PUT,
         AST_LESS, AST_LESS_EQUAL, AST_GREATER, AST_GREATER_EQUAL, AST_EQUAL, AST_NOT_EQUAL,
         AST_ASSIGN, AST_COERCE
     };
@@ -85,7 +87,7 @@ namespace basil {
         virtual void serialize(rc<Env> env, bytebuf& buf);
 
         // Deserializes an AST node and its children from the provided byte buffer.
-        static rc<AST> deserialize(bytebuf& buf);
+        static rc<AST> deserialize(bytereader& buf);
 
         // Returns the kind of AST node this is.
         ASTKind kind() const;
@@ -157,6 +159,21 @@ namespace basil {
     rc<AST> ast_cons(Source::Pos pos, Type type, rc<AST> head, rc<AST> tail);
     rc<AST> ast_coerce(Source::Pos pos, rc<AST> value, Type dest);
 
+    // Arrays
+
+    rc<AST> ast_array(Source::Pos pos, Type type, const vector<rc<AST>>& elements);
+    rc<AST> ast_array_at(Source::Pos pos, rc<AST> array, rc<AST> index);
+    rc<AST> ast_array_length(Source::Pos pos, rc<AST> array);
+    rc<AST> ast_array_store(Source::Pos pos, rc<AST> array, rc<AST> index, rc<AST> value);
+
+    // Dictionaries
+
+    // Entries are given as alternating keys and values.
+    rc<AST> ast_dict(Source::Pos pos, Type type, const vector<rc<AST>>& entries);
+    rc<AST> ast_dict_at(Source::Pos pos, rc<AST> dict, rc<AST> key);
+    rc<AST> ast_dict_length(Source::Pos pos, rc<AST> dict);
+    rc<AST> ast_dict_put(Source::Pos pos, rc<AST> dict, rc<AST> key, rc<AST> value);
+
     // Mutation
     
     rc<AST> ast_assign(Source::Pos pos, Type type, rc<AST> dest, rc<AST> src);
@@ -20,22 +20,23 @@ namespace basil {
         DEF, DEF_TYPED, DEF_EXTERN, MACRO, MACRO_TYPED, // definitions
         LAMBDA, DO, META, EVAL, QUOTE, SPLICE, // other special forms, core behavior
         IMPORT, MODULE, USE_STRING, USE_MODULE, // modules
-        AT_MODULE, AT_TUPLE, AT_ARRAY, DOT, // accessors
+        AT_MODULE, AT_TUPLE, AT_ARRAY, AT_DICT, DOT, // accessors
         IF, IF_ELSE, WHILE, ARROW, MATCHES, MATCH, // conditionals
-        ADD_INT, ADD_FLOAT, ADD_DOUBLE, SUB, MUL, DIV, REM, // arithmetic
+        ADD_INT, ADD_FLOAT, ADD_DOUBLE, ADD_STRING, SUB, MUL, DIV, REM, // arithmetic
         INCR, DECR, // increment/decrement
         LESS, LESS_EQUAL, GREATER, GREATER_EQUAL, EQUAL, NOT_EQUAL, // comparisons
+        LESS_STRING, LESS_EQUAL_STRING, GREATER_STRING, GREATER_EQUAL_STRING, EQUAL_STRING, NOT_EQUAL_STRING,
         AND, OR, XOR, NOT, // logic
         HEAD, TAIL, CONS, // list operations
-        LENGTH_STRING, LENGTH_TUPLE, LENGTH_ARRAY, FIND, SUBSTR, // string operations
-        LIST, ARRAY, TUPLE, NEW, // data constructors
+        LENGTH_STRING, LENGTH_TUPLE, LENGTH_ARRAY, LENGTH_DICT, FIND, SUBSTR, // string operations
+        LIST, ARRAY, DICT, TUPLE, NEW, // data constructors
         UNION_TYPE, NAMED_TYPE, FN_TYPE, REF_TYPE, JUST, TYPE_VAR, // type operators
         TYPEOF, IS, ANNOTATE, IS_SUBTYPE,
         ASSIGN, // mutation
         
         PRINT, PRINTLN, WRITELN, WRITE_INT, WRITE_FLOAT, WRITE_DOUBLE, WRITE_STRING, WRITE_CHAR, // IO
         WRITE_BOOL, WRITE_VOID, // WRITE_SYMBOL, WRITE_TYPE, 
-        OPEN, CLOSE,
+        OPEN, CLOSE, READ, MAPFILE, UNMAP,
 
         EXIT, // other syscalls
 
@@ -568,9 +569,53 @@ namespace basil {
         }
     }
     
+    // A test that one of the runtime parts of a 'match' scrutinee (a column) is equal to some
+    // operand. Operands are compile-time constants unless the test is opaque, in which case
+    // the operand is another runtime value and the test can't be merged with others.
+    struct MatchTest {
+        u32 column;
+        Value operand;
+        bool opaque;
+    };
+
+    // A case of a 'match' over runtime values. Matching its pattern against the scrutinee
+    // resolves every check on types and compile-time values up front, and leaves behind the
+    // tests the case still needs at runtime, and the names it binds to runtime values.
+    struct MatchRow {
+        const vector<Value>* columns;
+        vector<MatchTest> tests;
+        vector<Symbol> bindings;
+        rc<Env> env;
+        Value pattern, body;
+        rc<AST> lowered; // the evaluated body, once some path through the match reaches it
+    };
+
+    // Matches the runtime value 'v' against 'operand', by adding a test to 'row'. A
+    // compile-time operand that can't have v's type rules the case out immediately.
+    Value match_runtime_value(rc<Env> env, const Value& pattern, const Value& v, Value operand, MatchRow* row) {
+        if (!row) return v_bool(pattern.pos, false); // a compile-time value is never equal to a runtime one
+        u32 column = 0;
+        while (column < row->columns->size() 
+            && (*row->columns)[column].data.rt->ast.raw() != v.data.rt->ast.raw()) column ++;
+        if (column == row->columns->size()) panic("Runtime value in match scrutinee has no column!");
+
+        Type t = t_runtime_base(v.type);
+        if (operand.type.of(K_RUNTIME)) {
+            if (!t_runtime_base(operand.type).coerces_to(t)) return v_bool(pattern.pos, false);
+            row->tests.push({ column, operand, true });
+        }
+        else {
+            if (!operand.type.coerces_to(t)) return v_bool(pattern.pos, false);
+            row->tests.push({ column, coerce(env, operand, t), false });
+        }
+        return v_bool(pattern.pos, true);
+    }
+
     // Returns Value(true) if the provided value 'v' matches the pattern, 
-    // returns Value(false) otherwise.
-    Value match_case(rc<Env> env, const Value& pattern, const Value& v) {
+    // returns Value(false) otherwise. When 'row' is provided, 'v' may contain runtime
+    // values, and any tests and bindings on them are added to the row instead; the
+    // result is then whether the case can match at all.
+    Value match_case(rc<Env> env, const Value& pattern, const Value& v, MatchRow* row = nullptr) {
         switch (pattern.type.kind()) {
             case K_INT:
             case K_DOUBLE:
@@ -578,11 +623,13 @@ namespace basil {
             case K_VOID:
             case K_STRING:
             case K_CHAR:    // value match
+                if (v.type.of(K_RUNTIME)) return match_runtime_value(env, pattern, v, pattern, row);
                 return v_bool(pattern.pos, v == pattern);
             case K_SYMBOL: { // variable binding pattern
                 Value pattern_copy = pattern;
                 Value var = eval(env, pattern_copy);
                 if (var.type == T_ERROR) return v_error({});
+                else if (v.type.of(K_RUNTIME)) return match_runtime_value(env, pattern, v, var, row);
                 else return v_bool(pattern.pos, v == var);
             }
             case K_LIST: {
@@ -609,6 +656,7 @@ namespace basil {
                     }
                     Symbol name = v_head(v_tail(pattern)).data.sym;
                     env->def(name, v);
+                    if (row && v.type.of(K_RUNTIME)) row->bindings.push(name);
                     return v_bool(pattern.pos, true);
                 }
                 else if (op == S_COLON) { // annotation pattern
@@ -633,11 +681,14 @@ namespace basil {
                             type, "' instead.");
                         return v_error({});
                     }
-                    if (v.type.coerces_to(type.data.type)) // match values of compatible type
-                        return match_case(env, recur, coerce(env, v, type.data.type));
+                    if (v.type.of(K_RUNTIME)) // runtime types are known statically
+                        return t_runtime_base(v.type).coerces_to(type.data.type) ? 
+                            match_case(env, recur, v, row) : v_bool(pattern.pos, false);
+                    else if (v.type.coerces_to(type.data.type)) // match values of compatible type
+                        return match_case(env, recur, coerce(env, v, type.data.type), row);
                     else if (v.type.of(K_UNION) && t_union_has(v.type, type.data.type) // match unions
                         && v.data.u->value.type == type.data.type)
-                        return match_case(env, recur, v.data.u->value);
+                        return match_case(env, recur, v.data.u->value, row);
                     else // we couldn't match the type, so we return false
                         return v_bool(pattern.pos, false);
                 }
@@ -655,9 +706,13 @@ namespace basil {
                         return v_error({});
                     }
 
+                    if (v.type.of(K_RUNTIME) && t_runtime_base(v.type).of(K_LIST)) {
+                        err(pattern.pos, "List patterns can't match runtime values yet.");
+                        return v_error({});
+                    }
                     if (!v.type.of(K_LIST)) return v_bool(pattern.pos, false); // this pattern only matches lists
-                    Value left = match_case(env, v_head(v_tail(pattern)), v_head(v)),
-                          right = match_case(env, v_head(v_tail(v_tail(pattern))), v_tail(v));
+                    Value left = match_case(env, v_head(v_tail(pattern)), v_head(v), row),
+                          right = match_case(env, v_head(v_tail(v_tail(pattern))), v_tail(v), row);
 
                     if (left.type == T_ERROR || right.type == T_ERROR) // propagate errors
                         return v_error({});
@@ -665,6 +720,10 @@ namespace basil {
                     return v_bool(pattern.pos, left.data.b && right.data.b);
                 }
                 else if (op == S_COMMA) { // tuple destructuring pattern
+                    if (v.type.of(K_RUNTIME) && t_runtime_base(v.type).of(K_TUPLE)) {
+                        err(pattern.pos, "Tuple patterns can't match runtime values yet.");
+                        return v_error({});
+                    }
                     if (!v.type.of(K_TUPLE)) return v_bool(pattern.pos, false); // this pattern only matches tuples
                     vector<Value> subpatterns;
                     list_iterable iter = iter_list(v_tail(pattern));
@@ -696,7 +755,7 @@ namespace basil {
                     }
                     if (subpatterns.size() != v_len(v)) return v_bool(pattern.pos, false); // size mismatch
                     for (u32 i = 0; i < subpatterns.size(); i ++) {
-                        Value result = match_case(env, subpatterns[i], v_at(v, i));
+                        Value result = match_case(env, subpatterns[i], v_at(v, i), row);
                         if (result.type == T_ERROR) return v_error({});
                         if (result.data.b == false) return v_bool(pattern.pos, false);
                     }
@@ -723,9 +782,13 @@ namespace basil {
                     Value name = v_head(v_tail(pattern)), subpattern = v_head(v_tail(v_tail(pattern)));
                     const Value& v_or_inner = v.type.of(K_UNION) ? v.data.u->value : v; // match on union member if it's a union
                     
+                    if (v.type.of(K_RUNTIME) && t_runtime_base(v.type).of(K_NAMED)) {
+                        err(pattern.pos, "Named patterns can't match runtime values yet.");
+                        return v_error({});
+                    }
                     if (v_or_inner.type.of(K_NAMED)) {
                         if (t_get_name(v_or_inner.type) == name.data.sym) { // if it's the right named type
-                            return match_case(env, subpattern, v_or_inner.data.named->value);
+                            return match_case(env, subpattern, v_or_inner.data.named->value, row);
                         }
                         else return v_bool(pattern.pos, false);
                     }  
@@ -742,6 +805,241 @@ namespace basil {
         }
     }
 
+    // Checks the quoted cases of a 'match' expression, returning the list of cases after 'with'.
+    Value match_cases(const Value& cases) {
+        if (cases.type == T_VOID) { // third argument is just flat out empty
+            err(cases.pos, "No cases provided in 'match' expression.");
+            return v_error({});
+        }
+        if (v_head(cases).type != T_SYMBOL || v_head(cases).data.sym != S_WITH) { // no 'with' present
+            err(v_head(cases).pos, "Expected 'with' symbol before match expression cases, found '",
+                v_head(cases), "' instead.");
+            return v_error({});
+        }
+        if (v_tail(cases).type == T_VOID) { // no cases after 'with'
+            err(cases.pos, "No cases provided in 'match' expression.");
+            return v_error({});
+        }
+        for (const Value& c : iter_list(v_tail(cases))) {
+            if (!c.type.of(K_LIST) || v_head(c).type != T_SYMBOL 
+                || v_head(c).data.sym != S_CASE_ARROW) {
+                err(c.pos, "Expected case arrow expression, with form '", p_quoted("pattern"), " ",
+                    p_keyword("=>"), " ", p_quoted("body"), "', but found '", c, "' instead.");
+                return v_error({});
+            }
+            if (v_tail(c).type == T_VOID) {
+                err(c.pos, "No pattern expression provided in case.");
+                return v_error({});
+            }
+            if (v_tail(v_tail(c)).type == T_VOID) {
+                err(c.pos, "No body expression provided in case.");
+                return v_error({});
+            }
+        }
+        return v_tail(cases);
+    }
+
+    // Returns whether any part of 'v' is a runtime value, which 'match' must test at runtime.
+    bool has_runtime_parts(const Value& v) {
+        if (v.type.of(K_RUNTIME)) return true;
+        if (v.type.of(K_TUPLE)) {
+            for (const Value& e : v_tuple_elements(v)) if (has_runtime_parts(e)) return true;
+        }
+        else if (v.type.of(K_LIST)) {
+            for (const Value& e : iter_list(v)) if (has_runtime_parts(e)) return true;
+        }
+        return false;
+    }
+
+    // Makes a column for each runtime part of 'v', replacing it with a variable so that it's
+    // only computed once. The definitions of those variables are added to 'defs'.
+    Value bind_columns(rc<Env> env, const Value& v, vector<Value>& columns, vector<rc<AST>>& defs) {
+        static u32 count = 0;
+        if (v.type.of(K_RUNTIME)) {
+            Value column = v;
+            if (v.data.rt->ast->kind() != AST_VAR) {
+                Symbol name = symbol_from(format<ustring>("#match", count ++)); // can't clash with source names
+                env->def(name, v);
+                defs.push(ast_def(v.pos, name, v.data.rt->ast));
+                column = v_runtime(v.pos, v.type, ast_var(v.pos, env, name));
+            }
+            columns.push(column);
+            return column;
+        }
+        vector<Value> parts;
+        if (v.type.of(K_TUPLE)) {
+            for (const Value& e : v_tuple_elements(v)) parts.push(bind_columns(env, e, columns, defs));
+            return v_tuple(v.pos, v.type, move(parts));
+        }
+        if (v.type.of(K_LIST) && has_runtime_parts(v)) {
+            for (const Value& e : iter_list(v)) parts.push(bind_columns(env, e, columns, defs));
+            return v_list(v.pos, v.type, move(parts));
+        }
+        return v;
+    }
+
+    // The remaining tests of a case, along some path through a match's decision tree.
+    struct MatchClause {
+        u32 row;
+        vector<MatchTest> tests;
+    };
+
+    struct MatchMatrix {
+        rc<Env> env;
+        vector<Value> columns;
+        vector<MatchRow> rows;
+        bool exhaustive = true;
+    };
+
+    rc<AST> runtime_equal(Source::Pos pos, rc<AST> a, rc<AST> b, Type t) {
+        if (t == T_STRING) return ast_call(pos, 
+            ast_func_stub(pos, t_func(t_tuple(T_STRING, T_STRING), T_BOOL), symbol_from("equal"), true),
+            vector_of<rc<AST>>(a, b));
+        return ast_equal(pos, EQUAL.type, a, b);
+    }
+
+    rc<AST> match_test(MatchMatrix& m, const MatchTest& test) {
+        const Value& column = m.columns[test.column];
+        Value operand = test.opaque ? test.operand : lower(m.env, test.operand);
+        if (operand.type == T_ERROR) return nullptr;
+        return runtime_equal(test.operand.pos, column.data.rt->ast->clone(), operand.data.rt->ast->clone(),
+            t_runtime_base(column.type));
+    }
+
+    // Evaluates the body of a case the first time it's reached, defining the names its pattern
+    // bound to runtime values beforehand.
+    rc<AST> match_body(MatchMatrix& m, u32 i) {
+        MatchRow& row = m.rows[i];
+        if (row.lowered) return row.lowered->clone();
+        Value body = lower(row.env, eval(row.env, row.body));
+        if (body.type == T_ERROR) return nullptr;
+        vector<rc<AST>> exprs;
+        for (Symbol name : row.bindings) {
+            const Value& bound = *row.env->find(name);
+            exprs.push(ast_def(bound.pos, name, bound.data.rt->ast->clone()));
+        }
+        exprs.push(body.data.rt->ast);
+        row.lowered = exprs.size() == 1 ? exprs[0] : ast_do(body.pos, exprs);
+        return row.lowered;
+    }
+
+    // Whether the constants tested on a column cover every value of its type, so the tree
+    // needs no fallback case for it.
+    bool covers_type(Type t, u32 n_constants) {
+        return (t == T_BOOL && n_constants == 2) || (t == T_VOID && n_constants == 1);
+    }
+
+    // Builds the decision tree for the clauses, which are in priority order. The first
+    // clause decides what to test next. An opaque test just splits it off from the rest;
+    // a constant test branches on every constant tested on that column at once, so no
+    // path through the tree tests a column against constants more than once.
+    rc<AST> match_decide(MatchMatrix& m, Source::Pos pos, const vector<MatchClause>& clauses) {
+        if (clauses.size() == 0) {
+            m.exhaustive = false;
+            return nullptr;
+        }
+        const MatchClause& first = clauses[0];
+        if (first.tests.size() == 0) return match_body(m, first.row);
+
+        const MatchTest& test = first.tests[0];
+        if (test.opaque) {
+            vector<MatchClause> passed = clauses, failed;
+            passed[0].tests.clear();
+            for (u32 i = 1; i < first.tests.size(); i ++) passed[0].tests.push(first.tests[i]);
+            for (u32 i = 1; i < clauses.size(); i ++) failed.push(clauses[i]);
+            rc<AST> cond = match_test(m, test), 
+                if_true = cond ? match_decide(m, pos, passed) : nullptr,
+                if_false = if_true ? match_decide(m, pos, failed) : nullptr;
+            return if_false ? ast_if_else(pos, cond, if_true, if_false) : nullptr;
+        }
+
+        u32 column = test.column;
+        vector<MatchTest> constants;
+        vector<MatchClause> others; // clauses that don't test this column against a constant
+        for (const MatchClause& c : clauses) {
+            bool tested = false;
+            for (const MatchTest& t : c.tests) if (t.column == column && !t.opaque) {
+                tested = true;
+                bool seen = false;
+                for (const MatchTest& k : constants) if (k.operand == t.operand) seen = true;
+                if (!seen) constants.push(t);
+                break;
+            }
+            if (!tested) others.push(c);
+        }
+
+        bool covered = covers_type(t_runtime_base(m.columns[column].type), constants.size());
+        rc<AST> tree = covered ? nullptr : match_decide(m, pos, others);
+        if (!covered && !tree) return nullptr;
+        for (i64 i = i64(constants.size()) - 1; i >= 0; i --) {
+            vector<MatchClause> specialized;
+            for (const MatchClause& c : clauses) {
+                MatchClause s = { c.row, {} };
+                bool keep = true, removed = false;
+                for (const MatchTest& t : c.tests) {
+                    if (!removed && t.column == column && !t.opaque) {
+                        removed = true;
+                        keep = t.operand == constants[i].operand;
+                    }
+                    else s.tests.push(t);
+                }
+                if (keep) specialized.push(s);
+            }
+            rc<AST> branch = match_decide(m, pos, specialized);
+            if (!branch) return nullptr;
+            if (covered && i == i64(constants.size()) - 1) tree = branch; // the last constant needs no test
+            else {
+                rc<AST> cond = match_test(m, constants[i]);
+                if (!cond) return nullptr;
+                tree = ast_if_else(pos, cond, branch, tree);
+            }
+        }
+        return tree;
+    }
+
+    // Compiles a 'match' on a value with runtime parts into a decision tree. Every case is
+    // checked against the scrutinee's type up front, and it's an error for a case to be
+    // unreachable, or for no case to match some value.
+    Value match_runtime(rc<Env> env, const Value& call_term, const Value& value, const Value& cases) {
+        MatchMatrix m;
+        m.env = env;
+        vector<rc<AST>> defs;
+        Value scrutinee = bind_columns(env, value, m.columns, defs);
+
+        vector<MatchClause> clauses;
+        for (const Value& c : iter_list(cases)) {
+            MatchRow row;
+            row.columns = &m.columns;
+            row.env = extend(env);
+            row.pattern = v_head(v_tail(c));
+            row.body = v_head(v_tail(v_tail(c)));
+            Value result = match_case(row.env, row.pattern, scrutinee, &row);
+            if (result.type == T_ERROR) return v_error({});
+            if (result.data.b) clauses.push({ m.rows.size(), row.tests });
+            m.rows.push(row);
+        }
+
+        rc<AST> tree = match_decide(m, call_term.pos, clauses);
+        if (!tree) {
+            if (!m.exhaustive) err(call_term.pos, "Not every possible value of '", value, 
+                "' is matched by a case; consider adding a catch-all case like 'x? => ...'.");
+            return v_error({});
+        }
+        bool reachable = true;
+        for (const MatchRow& row : m.rows) if (!row.lowered) {
+            err(row.pattern.pos, "Pattern '", row.pattern, "' is unreachable, since it either can't match ",
+                "a value of type '", t_runtime_base(value.type), "', or only matches values earlier cases already do.");
+            reachable = false;
+        }
+        if (!reachable) return v_error({});
+
+        defs.push(tree);
+        rc<AST> result = defs.size() == 1 ? tree : ast_do(call_term.pos, defs);
+        Type t = result->type(env);
+        if (t == T_ERROR) return v_error({});
+        return v_runtime(call_term.pos, t_runtime(t), result);
+    }
+
     rc<Form> at_form(rc<Env> env, rc<Form> mod, const Value& key) {
         auto it = mod->compound->members.find(key);
         if (it != mod->compound->members.end()) {
@@ -795,6 +1093,70 @@ namespace basil {
             true_form, false_form);
     }
 
+    // Runtime array and dictionary accesses are written 'a[i]', which evaluates its index to a
+    // one-element array. This unwraps the lowered index, or reports an error if there's more
+    // than one.
+    rc<AST> runtime_index(rc<AST> indices) {
+        while (indices->kind() == AST_COERCE) indices = indices->begin()[0];
+        if (indices->kind() != AST_ARRAY || indices->children() != 1) {
+            err(indices->pos, "Runtime arrays and dictionaries must be indexed by exactly one key.");
+            return nullptr;
+        }
+        return indices->begin()[0];
+    }
+
+    // Lowers a string operation to a call into the runtime. The name is mangled with the
+    // argument types, so "concat" on two strings calls concat_ss.
+    rc<AST> string_call(const Value& call_term, const Value& args, const char* name, Type result) {
+        vector<rc<AST>> operands;
+        if (args.type.of(K_TUPLE)) for (u32 i = 0; i < v_len(args); i ++) operands.push(v_at(args, i).data.rt->ast);
+        else operands.push(args.data.rt->ast);
+        return ast_call(call_term.pos, 
+            ast_func_stub(call_term.pos, t_func(t_runtime_base(args.type), result), symbol_from(name), true),
+            operands);
+    }
+
+    // Runtime string orderings compare the result of the runtime's three-way comparison
+    // against zero.
+    rc<AST> string_order(const Value& call_term, const Value& args, 
+        rc<AST> (*order)(Source::Pos, Type, rc<AST>, rc<AST>)) {
+        return order(call_term.pos, LESS.type, string_call(call_term, args, "compare", T_INT), 
+            ast_int(call_term.pos, T_INT, 0));
+    }
+
+    static bool is_at(const Value& v) {
+        return v.type == T_SYMBOL && v.data.sym == S_AT;
+    }
+
+    // Returns whether the provided lvalue is an array element or dictionary entry, 'a[i]' or
+    // 'a at i', either
+    // as written or after its form has been applied.
+    bool is_index_lval(const Value& lval) {
+        if (!lval.type.of(K_LIST) || v_list_len(lval) != 3) return false;
+        return is_at(v_head(lval)) || is_at(v_head(v_tail(lval)));
+    }
+
+    // Produces a store to the runtime array element or dictionary entry described by 'lval'.
+    rc<AST> lower_store(rc<Env> env, const Value& lval, const Value& rhs) {
+        Value array_term = is_at(v_head(lval)) ? v_head(v_tail(lval)) : v_head(lval), 
+            indices_term = v_head(v_tail(v_tail(lval)));
+        Value array = eval(env, array_term), indices = eval(env, indices_term);
+        if (array.type == T_ERROR || indices.type == T_ERROR) return nullptr;
+        bool dict = array.type.of(K_RUNTIME) && t_runtime_base(array.type).of(K_DICT);
+        if (!array.type.of(K_RUNTIME) || !(dict || t_runtime_base(array.type).of(K_ARRAY))) {
+            err(lval.pos, "Only runtime arrays and dictionaries can be assigned to by index, but '", 
+                array_term, "' has type '", array.type, "'.");
+            return nullptr;
+        }
+        indices = lower(env, indices);
+        Value value = lower(env, rhs);
+        if (indices.type == T_ERROR || value.type == T_ERROR) return nullptr;
+        rc<AST> index = runtime_index(indices.data.rt->ast);
+        if (!index) return nullptr;
+        if (dict) return ast_dict_put(lval.pos, array.data.rt->ast, index, value.data.rt->ast);
+        return ast_array_store(lval.pos, array.data.rt->ast, index, value.data.rt->ast);
+    }
+
     // this function parses quoted terms in the lhs of mutating expressions (e.g. assignment)
     // and produces a correct AST. we need this because ordinarily, lvalues would simply evaluate
     // to their associated values, which are not always assignable (say the destination variable
@@ -819,14 +1181,19 @@ namespace basil {
     // compile-time instead of compiling to typed AST.
     Value bind_lval(rc<Env> env, const Value& lval, const Value& rhs) {
         if (lval.type == T_SYMBOL) {
-            auto var = env->find(lval.data.sym);
-            if (!env->find(lval.data.sym)) {
+            auto var = env->find_mut(lval.data.sym);
+            if (!var) {
                 err(lval.pos, "Undefined variable '", lval, "'.");
                 return v_error({});
             }
             *var = rhs;
             return v_void({});
         }
+        else if (is_index_lval(lval)) {
+            rc<AST> store = lower_store(env, lval, rhs);
+            if (!store) return v_error({});
+            return v_runtime(lval.pos, t_runtime(T_VOID), store);
+        }
         else {
             err(lval.pos, "Assignment target '", lval, "' has unknown pattern.");
             return v_void({});
@@ -1163,7 +1530,7 @@ namespace basil {
         AT_ARRAY = {
             t_func(t_tuple(t_array(T_ANY), t_array(T_INT)), T_ANY),
             f_callable(PREC_ANNOTATED, ASSOC_LEFT, at_form, p_var("array"), P_SELF, p_var("index")),
-            BF_COMPTIME,
+            BF_COMPTIME | BF_RUNTIME,
             [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
                 vector<Value> elts;
                 elts.clear();
@@ -1180,7 +1547,32 @@ namespace basil {
                 } 
                 return elts.size() == 1 ? elts[0] : v_array(args.pos, infer_array(elts), move(elts));
             },
-            nullptr
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                rc<AST> index = runtime_index(v_at(args, 1).data.rt->ast);
+                if (!index) return nullptr;
+                return ast_array_at(args.pos, v_at(args, 0).data.rt->ast, index);
+            }
+        };
+        AT_DICT = {
+            t_func(t_tuple(t_dict(T_ANY, T_ANY), t_array(T_ANY)), T_ANY),
+            f_callable(PREC_ANNOTATED, ASSOC_LEFT, at_form, p_var("dict"), P_SELF, p_var("key")),
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                vector<Value> elts;
+                for (const auto& k : v_at(args, 1).data.array->elements) {
+                    if (!v_dict_has(v_at(args, 0), k)) {
+                        err(k.pos, "Key '", k, "' is not present in dictionary '", v_at(args, 0), "'.");
+                        return v_error({});
+                    }
+                    elts.push(v_dict_at(v_at(args, 0), k));
+                }
+                return elts.size() == 1 ? elts[0] : v_array(args.pos, infer_array(elts), move(elts));
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                rc<AST> key = runtime_index(v_at(args, 1).data.rt->ast);
+                if (!key) return nullptr;
+                return ast_dict_at(args.pos, v_at(args, 0).data.rt->ast, key);
+            }
         };
         DOT = {
             t_func(t_tuple(T_ANY, T_ANY), T_ANY), // type
@@ -1316,37 +1708,14 @@ namespace basil {
         MATCH = {
             t_func(t_tuple(T_ANY, t_list(T_ANY)), T_ANY),
             f_callable(PREC_CONTROL - 40, ASSOC_RIGHT, P_SELF, p_var("value"), p_quoted("cases")),
-            BF_COMPTIME,
+            BF_COMPTIME | BF_RUNTIME | BF_PRESERVING,
             [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
-                if (v_at(args, 1).type == T_VOID) { // third argument is just flat out empty
-                    err(v_at(args, 1).pos, "No cases provided in 'match' expression.");
-                    return v_error({});
-                }
-                if (v_head(v_at(args, 1)).type != T_SYMBOL
-                    || v_head(v_at(args, 1)).data.sym != S_WITH) { // no 'with' present
-                    err(v_head(v_at(args, 1)).pos, "Expected 'with' symbol before match expression cases, found '",
-                        v_head(v_at(args, 1)), "' instead.");
-                    return v_error({});
-                }
-                if (v_tail(v_at(args, 1)).type == T_VOID) { // no cases after 'with'
-                    err(v_at(args, 1).pos, "No cases provided in 'match' expression.");
-                    return v_error({});
-                }
-                for (const Value& c : iter_list(v_tail(v_at(args, 1)))) {
-                    if (!c.type.of(K_LIST) || v_head(c).type != T_SYMBOL 
-                        || v_head(c).data.sym != S_CASE_ARROW) {
-                        err(c.pos, "Expected case arrow expression, with form '", p_quoted("pattern"), " ",
-                            p_keyword("=>"), " ", p_quoted("body"), "', but found '", c, "' instead.");
-                        return v_error({});
-                    }
-                    if (v_tail(c).type == T_VOID) {
-                        err(c.pos, "No pattern expression provided in case.");
-                        return v_error({});
-                    }
-                    if (v_tail(v_tail(c)).type == T_VOID) {
-                        err(c.pos, "No body expression provided in case.");
-                        return v_error({});
-                    }
+                Value cases = match_cases(v_at(args, 1));
+                if (cases.type == T_ERROR) return v_error({});
+                if (has_runtime_parts(v_at(args, 0))) return match_runtime(env, call_term, v_at(args, 0), cases);
+                get_perf_info().make_comptime(); // matching isn't worth deferring to runtime
+
+                for (const Value& c : iter_list(cases)) {
                     Value result = match_case(env, v_head(v_tail(c)), v_at(args, 0));
                     if (result.type == T_ERROR) return v_error({});
                     else if (result.data.b) {
@@ -1357,7 +1726,12 @@ namespace basil {
                 err(v_at(args, 0).pos, "Provided value '", v_at(args, 0), "' did not match any case.");
                 return v_error({});
             },
-            nullptr
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                Value cases = match_cases(v_at(args, 1));
+                if (cases.type == T_ERROR) return nullptr;
+                Value result = match_runtime(env, call_term, v_at(args, 0), cases);
+                return result.type == T_ERROR ? nullptr : result.data.rt->ast;
+            }
         };
         ADD_INT = {
             t_func(t_tuple(T_INT, T_INT), T_INT), // type
@@ -1392,6 +1766,17 @@ namespace basil {
                 return ast_add(args.pos, ADD_DOUBLE.type, v_at(args, 0).data.rt->ast, v_at(args, 1).data.rt->ast);
             }
         };
+        ADD_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_STRING), // type
+            f_callable(PREC_ADD, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_string({}, v_tuple_at(args, 0).data.string->data + v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_call(call_term, args, "concat", T_STRING);
+            }
+        };
         SUB = {
             t_func(t_tuple(T_INT, T_INT), T_INT), // type
             f_callable(PREC_ADD, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
@@ -1519,6 +1904,73 @@ namespace basil {
                 return ast_not_equal(args.pos, NOT_EQUAL.type, v_at(args, 0).data.rt->ast, v_at(args, 1).data.rt->ast);
             }
         };
+        LESS_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL),
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data < v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_order(call_term, args, ast_less);
+            }
+        };
+        LESS_EQUAL_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL),
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data <= v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_order(call_term, args, ast_less_equal);
+            }
+        };
+        GREATER_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL),
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data > v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_order(call_term, args, ast_greater);
+            }
+        };
+        GREATER_EQUAL_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL),
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data >= v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_order(call_term, args, ast_greater_equal);
+            }
+        };
+        EQUAL_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL), // type
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data == v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_call(call_term, args, "equal", T_BOOL);
+            }
+        };
+        NOT_EQUAL_STRING = {
+            t_func(t_tuple(T_STRING, T_STRING), T_BOOL), // type
+            f_callable(PREC_COMPARE, ASSOC_LEFT, p_var("lhs"), P_SELF, p_var("rhs")), // form
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                return v_bool({}, v_tuple_at(args, 0).data.string->data != v_tuple_at(args, 1).data.string->data);
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return ast_equal(call_term.pos, EQUAL.type, string_call(call_term, args, "equal", T_BOOL), 
+                    ast_bool(call_term.pos, T_BOOL, false));
+            }
+        };
         AND = {
             t_func(t_tuple(T_BOOL, T_ANY), T_BOOL), // type
             f_callable(PREC_LOGIC, ASSOC_LEFT, p_var("lhs"), P_SELF, p_quoted("rhs")), // form
@@ -1604,11 +2056,13 @@ namespace basil {
         LENGTH_STRING = {
             t_func(T_STRING, T_INT),
             f_callable(PREC_DEFAULT, ASSOC_LEFT, p_var("string"), P_SELF),
-            BF_COMPTIME,
+            BF_COMPTIME | BF_RUNTIME,
             [](rc<Env> env, const Value& call_term, const Value& arg) -> Value {
                 return v_int({}, arg.data.string.raw()->data.size());
             },
-            nullptr
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> rc<AST> {
+                return string_call(call_term, arg, "length", T_INT);
+            }
         };
         LENGTH_TUPLE = {
             t_func(t_incomplete_tuple(), T_INT),
@@ -1622,11 +2076,24 @@ namespace basil {
         LENGTH_ARRAY = {
             t_func(t_array(T_ANY), T_INT),
             f_callable(PREC_DEFAULT, ASSOC_LEFT, p_var("array"), P_SELF),
-            BF_COMPTIME,
+            BF_COMPTIME | BF_RUNTIME,
             [](rc<Env> env, const Value& call_term, const Value& arg) -> Value {
                 return v_int({}, v_len(arg));
             },
-            nullptr
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> rc<AST> {
+                return ast_array_length(arg.pos, arg.data.rt->ast);
+            }
+        };
+        LENGTH_DICT = {
+            t_func(t_dict(T_ANY, T_ANY), T_INT),
+            f_callable(PREC_DEFAULT, ASSOC_LEFT, p_var("dict"), P_SELF),
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> Value {
+                return v_int({}, v_len(arg));
+            },
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> rc<AST> {
+                return ast_dict_length(arg.pos, arg.data.rt->ast);
+            }
         };
         FIND = {
             t_func(t_tuple(T_CHAR, T_STRING), T_INT),
@@ -1642,6 +2109,27 @@ namespace basil {
             },
             nullptr
         };
+        SUBSTR = {
+            t_func(t_tuple(T_STRING, T_INT, T_INT), T_STRING),
+            f_callable(PREC_DEFAULT, ASSOC_LEFT, P_SELF, p_var("str"), p_var("start"), p_var("end")),
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                const ustring& str = v_tuple_at(args, 0).data.string->data;
+                i64 start = v_tuple_at(args, 1).data.i, end = v_tuple_at(args, 2).data.i, n = str.size();
+                if (start < 0) start = 0; // bounds are clamped, as in the runtime
+                if (end > n) end = n;
+                if (start >= end) return v_string({}, ustring());
+
+                auto from = str.begin(); // bounds count code points
+                for (i64 i = 0; i < start; i ++) ++ from;
+                auto to = from;
+                for (i64 i = start; i < end; i ++) ++ to;
+                return v_string({}, ustring(const_slice<u8>(to._ptr - from._ptr, (const u8*)from._ptr)));
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return string_call(call_term, args, "substr", T_STRING);
+            }
+        };
         LIST = {
             t_func(t_list(T_ANY), T_ANY),
             f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_variadic("items")),
@@ -1654,13 +2142,59 @@ namespace basil {
         ARRAY = {
             t_func(t_list(T_ANY), T_ANY),
             f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_variadic("items")),
-            BF_COMPTIME,
+            BF_COMPTIME | BF_RUNTIME,
             [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
                 vector<Value> elements;
-                for (const Value& v : iter_list(args)) elements.push(v);
-                return v_array({}, infer_array(elements), move(elements));
+                bool runtime = false;
+                for (const Value& v : iter_list(args)) elements.push(v), runtime |= v.type.of(K_RUNTIME);
+                Value array = v_array({}, infer_array(elements), move(elements));
+                return runtime ? lower(env, array) : array; // any runtime element makes a runtime array
             },
-            nullptr
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                vector<rc<AST>> elements;
+                for (const Value& v : iter_list(args)) elements.push(v.data.rt->ast);
+                return ast_array(args.pos, t_array(T_ANY), elements);
+            }
+        };
+        DICT = {
+            t_func(t_list(T_ANY), T_ANY),
+            f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_variadic("entries")),
+            BF_COMPTIME | BF_RUNTIME,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                if (v_list_len(args) % 2) {
+                    err(args.pos, "Expected a value for every key in dictionary constructor.");
+                    return v_error({});
+                }
+                bool runtime = false;
+                for (const Value& v : iter_list(args)) runtime |= v.type.of(K_RUNTIME);
+                if (runtime) { // any runtime key or value makes a runtime dictionary
+                    vector<rc<AST>> entries;
+                    for (const Value& v : iter_list(args)) {
+                        Value lowered = lower(env, v);
+                        if (lowered.type == T_ERROR) return lowered;
+                        entries.push(lowered.data.rt->ast);
+                    }
+                    rc<AST> dict = ast_dict(args.pos, t_dict(T_ANY, T_ANY), entries);
+                    Type dict_type = dict->type(env);
+                    if (dict_type == T_ERROR) return v_error({});
+                    return v_runtime(args.pos, t_runtime(dict_type), dict);
+                }
+                vector<Value> items;
+                for (const Value& v : iter_list(args)) items.push(v);
+                map<Value, Value> entries;
+                for (u32 i = 0; i < items.size(); i += 2) entries.put(items[i], items[i + 1]);
+                Type dict_type = infer_dict(entries);
+                return v_dict(args.pos, dict_type, move(entries));
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                if (v_list_len(args) % 2) {
+                    err(args.pos, "Expected a value for every key in dictionary constructor.");
+                    return nullptr;
+                }
+                vector<rc<AST>> entries;
+                for (const Value& v : iter_list(args)) entries.push(v.data.rt->ast);
+                return ast_dict(args.pos, t_dict(T_ANY, T_ANY), entries);
+            }
         };
         TUPLE = {
             t_func(t_tuple(T_ANY, t_list(T_ANY)), T_ANY),
@@ -1837,7 +2371,7 @@ namespace basil {
             nullptr
         };
         ASSIGN = {
-            t_func(t_tuple(T_SYMBOL, T_ANY), T_VOID),
+            t_func(t_tuple(T_ANY, T_ANY), T_VOID), // dest is a symbol, array element or dictionary entry
             f_callable(PREC_COMPOUND - 20, ASSOC_RIGHT, p_quoted("dest"), P_SELF, p_var("src")),
             BF_COMPTIME | BF_RUNTIME | BF_STATEFUL | BF_PRESERVING, // preserve quoted dest,
             [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
@@ -1845,6 +2379,7 @@ namespace basil {
             },
             [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
                 Value lhs = v_at(args, 0);
+                if (is_index_lval(lhs)) return lower_store(env, lhs, v_at(args, 1));
                 auto lhs_ast = lower_lval(env, lhs, v_at(args, 1));
                 if (!lhs_ast) return nullptr;
                 return ast_assign(args.pos, ASSIGN.type, *lhs_ast, v_at(args, 1).data.rt->ast);
@@ -2024,6 +2559,54 @@ namespace basil {
                             vector_of<rc<AST>>(arg.data.rt->ast));
             }
         };
+        READ = {
+            t_func(t_tuple(t_named(S_STREAM, T_INT), T_INT), T_STRING),
+            f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_var("stream"), p_var("size")),
+            BF_COMPTIME | BF_RUNTIME | BF_STATEFUL,
+            [](rc<Env> env, const Value& call_term, const Value& args) -> Value {
+                const char* str = read_N6Streamii(v_at(args, 0).data.named->value.data.i, v_at(args, 1).data.i);
+                Value result = v_string(call_term.pos, ustring(const_slice<u8>(*(u32*)(str - 4) - 1, (const u8*)str)));
+                unmap_s(str);
+                return result;
+            },
+            [](rc<Env> env, const Value& call_term, const Value& args) -> rc<AST> {
+                return ast_call(call_term.pos, 
+                        ast_func_stub(call_term.pos, t_func(t_runtime_base(args.type), T_STRING), 
+                            symbol_from("read"), true), 
+                            vector_of<rc<AST>>(v_at(args, 0).data.rt->ast, v_at(args, 1).data.rt->ast));
+            }
+        };
+        MAPFILE = {
+            t_func(T_STRING, T_STRING),
+            f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_var("path")),
+            BF_COMPTIME | BF_RUNTIME | BF_STATEFUL,
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> Value {
+                const char* str = mapfile_s((const char*)arg.data.string->data.raw());
+                Value result = v_string(call_term.pos, ustring(const_slice<u8>(*(u32*)(str - 4) - 1, (const u8*)str)));
+                unmap_s(str);
+                return result;
+            },
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> rc<AST> {
+                return ast_call(call_term.pos, 
+                        ast_func_stub(call_term.pos, t_func(t_runtime_base(arg.type), T_STRING), 
+                            symbol_from("mapfile"), true), 
+                            vector_of<rc<AST>>(arg.data.rt->ast));
+            }
+        };
+        UNMAP = {
+            t_func(T_STRING, T_VOID),
+            f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_var("str")),
+            BF_COMPTIME | BF_RUNTIME | BF_STATEFUL,
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> Value {
+                return v_void({}); // compile-time strings are already copied out of their mappings
+            },
+            [](rc<Env> env, const Value& call_term, const Value& arg) -> rc<AST> {
+                return ast_call(call_term.pos, 
+                        ast_func_stub(call_term.pos, t_func(t_runtime_base(arg.type), T_VOID), 
+                            symbol_from("unmap"), true), 
+                            vector_of<rc<AST>>(arg.data.rt->ast));
+            }
+        };
         EXIT = {
             t_func(T_INT, T_VOID),
             f_callable(PREC_DEFAULT, ASSOC_RIGHT, P_SELF, p_var("code")),
@@ -2091,19 +2674,19 @@ namespace basil {
         env->def(symbol_from("module"), v_func(MODULE));
         env->def(symbol_from("use"), v_intersect(&USE_STRING, &USE_MODULE));
 
-        env->def(symbol_from("+"), v_intersect(&ADD_INT, &ADD_FLOAT, &ADD_DOUBLE));
+        env->def(symbol_from("+"), v_intersect(&ADD_INT, &ADD_FLOAT, &ADD_DOUBLE, &ADD_STRING));
         env->def(symbol_from("-"), v_func(SUB));
         env->def(symbol_from("*"), v_func(MUL));
         env->def(symbol_from("/"), v_func(DIV));
         env->def(symbol_from("%"), v_func(REM));
         // env->def(symbol_from("++"), v_func(INCR));
         // env->def(symbol_from("--"), v_func(DECR));
-        env->def(symbol_from("<"), v_func(LESS));
-        env->def(symbol_from("<="), v_func(LESS_EQUAL));
-        env->def(symbol_from(">"), v_func(GREATER));
-        env->def(symbol_from(">="), v_func(GREATER_EQUAL));
-        env->def(symbol_from("=="), v_func(EQUAL));
-        env->def(symbol_from("!="), v_func(NOT_EQUAL));
+        env->def(symbol_from("<"), v_intersect(&LESS, &LESS_STRING));
+        env->def(symbol_from("<="), v_intersect(&LESS_EQUAL, &LESS_EQUAL_STRING));
+        env->def(symbol_from(">"), v_intersect(&GREATER, &GREATER_STRING));
+        env->def(symbol_from(">="), v_intersect(&GREATER_EQUAL, &GREATER_EQUAL_STRING));
+        env->def(symbol_from("=="), v_intersect(&EQUAL, &EQUAL_STRING));
+        env->def(symbol_from("!="), v_intersect(&NOT_EQUAL, &NOT_EQUAL_STRING));
         env->def(symbol_from("and"), v_func(AND));
         env->def(symbol_from("xor"), v_func(XOR));
         env->def(symbol_from("or"), v_func(OR));
@@ -2111,10 +2694,12 @@ namespace basil {
         env->def(symbol_from("head"), v_func(HEAD));
         env->def(symbol_from("tail"), v_func(TAIL));
         env->def(symbol_from("::"), v_func(CONS));
-        env->def(symbol_from("length"), v_intersect(&LENGTH_STRING, &LENGTH_TUPLE, &LENGTH_ARRAY));
+        env->def(symbol_from("length"), v_intersect(&LENGTH_STRING, &LENGTH_TUPLE, &LENGTH_ARRAY, &LENGTH_DICT));
         env->def(symbol_from("find"), v_func(FIND));
+        env->def(symbol_from("substr"), v_func(SUBSTR));
         env->def(symbol_from("list"), v_func(LIST));
         env->def(symbol_from("array"), v_func(ARRAY));
+        env->def(symbol_from("dict"), v_func(DICT));
         env->def(symbol_from(","), v_func(TUPLE));
         env->def(symbol_from("|"), v_func(UNION_TYPE));
         env->def(symbol_from("of"), v_func(NAMED_TYPE));
@@ -2125,7 +2710,7 @@ namespace basil {
         env->def(symbol_from("is"), v_func(IS));
         env->def(symbol_from(":"), v_func(ANNOTATE));
         env->def(symbol_from("debug"), v_func(DEBUG));
-        env->def(symbol_from("at"), v_intersect(&AT_MODULE, &AT_TUPLE, &AT_ARRAY));
+        env->def(symbol_from("at"), v_intersect(&AT_MODULE, &AT_TUPLE, &AT_ARRAY, &AT_DICT));
         env->def(symbol_from("."), v_func(DOT));
         env->def(symbol_from(":>"), v_func(IS_SUBTYPE));
         env->def(symbol_from("="), v_func(ASSIGN));
@@ -2138,6 +2723,9 @@ namespace basil {
         env->def(symbol_from("println"), v_func(PRINTLN));
         env->def(symbol_from("open"), v_func(OPEN));
         env->def(symbol_from("close"), v_func(CLOSE));
+        env->def(symbol_from("read"), v_func(READ));
+        env->def(symbol_from("mapfile"), v_func(MAPFILE));
+        env->def(symbol_from("unmap"), v_func(UNMAP));
         env->def(symbol_from("exit"), v_func(EXIT));
 
         // type primitives
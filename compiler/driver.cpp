@@ -13,6 +13,7 @@
 #include "token.h"
 #include "source.h"
 #include "util/perf.h"
+#include "util/arena.h"
 #include "obj.h"
 #include "eval.h"
 #include "stdlib.h"
@@ -25,11 +26,21 @@ namespace basil {
     void init() {
         init_types_and_symbols();
         sys::init_io();
+
+        // compiler diagnostics don't go through sys streams, so keep program output
+        // line-buffered to preserve its interleaving with them
+        sys::set_buffering(sys::io_for_fd(BASIL_STDOUT_FD), BASIL_BUFFER_LINE);
     }
 
     void deinit() {
+        sys::flush(sys::io_for_fd(BASIL_STDOUT_FD));
+        sys::flush(sys::io_for_fd(BASIL_STDERR_FD));
         free_root_env();
         free_types();
+#ifdef BASIL_RC_STATS
+        file err(stderr); // whatever is still live here outlived the compiler's own state
+        write_rc_stats(err);
+#endif
     }
     
     void init_rt(jasmine::Object& obj) {
@@ -44,6 +55,21 @@ namespace basil {
         obj.define_native(jasmine::global("exit_i"), (void*)exit_i);
         obj.define_native(jasmine::global("open_si"), (void*)open_si);
         obj.define_native(jasmine::global("close_N6Streami"), (void*)close_N6Streami);
+        obj.define_native(jasmine::global("mapfile_s"), (void*)mapfile_s);
+        obj.define_native(jasmine::global("read_N6Streamii"), (void*)read_N6Streamii);
+        obj.define_native(jasmine::global("unmap_s"), (void*)unmap_s);
+        obj.define_native(jasmine::global("length_s"), (void*)length_s);
+        obj.define_native(jasmine::global("concat_ss"), (void*)concat_ss);
+        obj.define_native(jasmine::global("compare_ss"), (void*)compare_ss);
+        obj.define_native(jasmine::global("equal_ss"), (void*)equal_ss);
+        obj.define_native(jasmine::global("substr_sii"), (void*)substr_sii);
+        obj.define_native(jasmine::global("array_ii"), (void*)array_ii);
+        obj.define_native(jasmine::global("badindex_ii"), (void*)badindex_ii);
+        obj.define_native(jasmine::global("dict_i"), (void*)dict_i);
+        obj.define_native(jasmine::global("dictinsert_ii"), (void*)dictinsert_ii);
+        obj.define_native(jasmine::global("dictinsert_is"), (void*)dictinsert_is);
+        obj.define_native(jasmine::global("dictat_ii"), (void*)dictat_ii);
+        obj.define_native(jasmine::global("dictat_is"), (void*)dictat_is);
     }
 
     static bool repl_mode = false;
@@ -147,10 +173,11 @@ namespace basil {
         if (!main.type.of(K_RUNTIME)) main = lower(env, main);
 
         map<Symbol, rc<AST>> functions;
-        for (auto& [k, v] : env->values) {
-            if (v.type.of(K_FUNCTION)) for (auto& [_, v] : v.data.fn->resolutions) {
-                for (auto& [t, v] : v->insts) {
-                    functions[mangle(k, v->func->type(env))] = v->func;
+        for (const auto& [k, v] : env->values) {
+            if (v.type.of(K_FUNCTION)) for (const auto& [_, v] : v.data.fn->resolutions) {
+                for (const auto& [t, v] : v->insts) {
+                    rc<AST> func = v->func;
+                    functions[mangle(k, func->type(env))] = func;
                 }
             }
         }
@@ -260,6 +287,9 @@ namespace basil {
         optional<rc<Section>> product = some<rc<Section>>(section); 
         rc<Source> src = section->type == ST_SOURCE ? source_from_section(section) : nullptr;
         while (product && (*product)->type < target) {
+            // Each step allocates its terms, forms, and ASTs from a fresh region. Most of these
+            // die once the next step has consumed this step's product, freeing whole blocks at once.
+            region step_region;
             switch ((*product)->type) {
                 case ST_SOURCE: product = apply(product, lex_and_parse); break;
                 case ST_PARSED: product = apply(product, eval_section); break;
@@ -533,6 +563,9 @@ namespace basil {
         // write_asm(native->get_loaded(jasmine::OS_DATA), native->data(), _stdout);
         auto main = (i64(*)())native->find(jasmine::global(".basil_main"));
         main();
+#ifdef BASIL_RC_STATS
+        deinit(); // exiting skips the usual teardown, which reports refcell statistics
+#endif
         exit(0);
         // println("= ", BOLD, ITALICBLUE, main(), RESET);
     }
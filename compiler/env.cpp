@@ -21,21 +21,21 @@ namespace basil {
     }
 
     optional<const Value&> Env::find(Symbol name) const {
-        auto it = values.find(name);
-        if (it == values.end()) {
+        const Value* value = values.lookup(name);
+        if (!value) {
             if (parent) return parent->find(name);
             return none<const Value&>();
         }
-        else return some<const Value&>(it->second);
+        else return some<const Value&>(*value);
     }
 
-    optional<Value&> Env::find(Symbol name) {
-        auto it = values.find(name);
-        if (it == values.end()) {
-            if (parent) return parent->find(name);
+    optional<Value&> Env::find_mut(Symbol name) {
+        Value* value = values.lookup_mut(name);
+        if (!value) {
+            if (parent) return parent->find_mut(name);
             return none<Value&>();
         }
-        else return some<Value&>(it->second);
+        else return some<Value&>(*value);
     }
     
     void Env::detach(rc<Env> child) {
@@ -61,8 +61,7 @@ namespace basil {
     }
 
     optional<rc<Env>> locate(rc<Env> env, Symbol name) {
-        auto it = env->values.find(name);
-        if (it != env->values.end()) return some<rc<Env>>(env);
+        if (env->values.contains(name)) return some<rc<Env>>(env);
         else if (env->parent) return locate(env->parent, name);
         else return none<rc<Env>>();
     }
@@ -30,10 +30,14 @@ namespace basil {
     // collected at the end of a given function scope! They are tied into the
     // overall tree of the compilation session and remain there unless
     // explicitly untied later.
+    //
+    // Bindings are stored in an overlay_map, so cloning an environment (which we
+    // do for every compile-time function call) shares its definitions with the
+    // original instead of copying them.
     struct Env {
         rc<Env> parent;
         vector<rc<Env>> children;
-        map<Symbol, Value> values;
+        overlay_map<Symbol, Value> values;
 
         // Constructs an empty environment with no parent.
         Env();
@@ -46,13 +50,19 @@ namespace basil {
         // is not present in this environment or any parent environment. Otherwise, returns
         // the value in this environment or the nearest parent that contained the name.
         optional<const Value&> find(Symbol name) const;
-        optional<Value&> find(Symbol name);
+
+        // Like find(), but returns a mutable reference. Only use this to modify the
+        // binding - if it lives in a layer shared with a clone of this environment, it
+        // gets copied into this environment's own layer first.
+        optional<Value&> find_mut(Symbol name);
 
         // Removes a child environment from this environment, causing it to be garbage-collected
         // if it is not tethered elsewhere.
         void detach(rc<Env> child);
 
         // Duplicates this environment, creating an identical environment with the same parent.
+        // This is constant-time - subsequent definitions in either environment are not visible
+        // to the other.
         rc<Env> clone() const;
         
         // Constructs an environment with a parent. Use extend() instead of calling this
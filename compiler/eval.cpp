@@ -12,6 +12,13 @@
 #include "driver.h"
 #include "forms.h"
 
+namespace basil {
+    struct ResolveKey;
+}
+
+template<>
+u64 hash(const basil::ResolveKey& key);
+
 namespace basil {
     // Infers a form from the provided type.
     rc<Form> infer_form(Type type) {
@@ -698,9 +705,24 @@ namespace basil {
         else return args;
     }
 
-    either<Type, OverloadError> resolve_call(rc<Env> env, const vector<Type>& overloads_in, Type args) {
-        if (overloads_in.size() == 0) panic("Cannot resolve empty list of overloads!");
-        if (overloads_in.size() == 1) return overloads_in[0];
+    // Identifies a particular overload resolution problem: the intersection type we drew the
+    // candidate function types from, and the argument type we're calling them with.
+    struct ResolveKey {
+        Type isect, args;
+
+        bool operator==(const ResolveKey& other) const {
+            return isect == other.isect && args == other.args;
+        }
+    };
+
+    // Results of previous overload resolutions. We only cache calls where every type involved
+    // is concrete - without type variables, overload resolution is a pure function of the
+    // candidate and argument types. Types are interned, so the intersection type stands in for
+    // its whole set of candidates - extending an overload set (as in add_type_overload) always
+    // results in a new intersection type, so stale results are never used.
+    static map<ResolveKey, either<Type, OverloadError>> resolve_cache;
+
+    static either<Type, OverloadError> resolve_call_uncached(const vector<Type>& overloads_in, Type args) {
         static vector<either<i64, PriorityError>> priorities;
         priorities.clear();
 
@@ -752,6 +774,20 @@ namespace basil {
         return overloads[0];
     }
 
+    either<Type, OverloadError> resolve_call(rc<Env> env, Type isect, const vector<Type>& overloads, Type args) {
+        if (overloads.size() == 0) panic("Cannot resolve empty list of overloads!");
+        if (overloads.size() == 1) return overloads[0];
+
+        if (!t_is_concrete(args) || !t_is_concrete(isect)) return resolve_call_uncached(overloads, args);
+
+        ResolveKey key = { isect, args };
+        auto it = resolve_cache.find(key);
+        if (it != resolve_cache.end()) return it->second;
+        auto result = resolve_call_uncached(overloads, args);
+        resolve_cache.put(key, result);
+        return result;
+    }
+
     Value coerce_rt(rc<Env> env, const Param& param, bool is_runtime, 
         BuiltinFlags flags, const Value& v, Type dest) {
         if ((v.type.of(K_RUNTIME) || is_runtime) && !dest.of(K_RUNTIME)) {
@@ -949,7 +985,7 @@ namespace basil {
             }
 
             // perform type-based overload resolution
-            auto resolved = resolve_call(env, valid, args_type);
+            auto resolved = resolve_call(env, fntype, valid, args_type);
 
             // handle errors if necessary
             if (resolved.is_right()) { // error
@@ -1340,3 +1376,9 @@ namespace basil {
         }
     }
 }
+
+template<>
+u64 hash(const basil::ResolveKey& key) {
+    // types are interned, so we can hash their ids directly
+    return ::hash(key.isect.id) * 10727359211460302549ul ^ ::hash(key.args.id);
+}
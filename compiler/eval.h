@@ -86,12 +86,12 @@ namespace basil {
     };
 
     // Resolves an overloaded function call, given a list of valid overload types
-    // and a list of the types of its parameters. Runtime types and type variables 
-    // generally behave like their underlying types for the purposes of this 
-    // function.
+    // drawn from the intersection type isect, and a list of the types of its parameters. 
+    // Runtime types and type variables generally behave like their underlying types for 
+    // the purposes of this function.
     // Returns a valid type from overloads if resolution succeeds, or an OverloadError
     // instance otherwise.
-    either<Type, OverloadError> resolve_call(rc<Env> env, const vector<Type>& overloads, Type args);
+    either<Type, OverloadError> resolve_call(rc<Env> env, Type isect, const vector<Type>& overloads, Type args);
 
     // Stores measurements about function call 
     struct PerfInfo {
@@ -30,50 +30,59 @@ namespace basil {
         "license"
     };
 
+    // Version of the object encoding itself, stored in the object header. Bump
+    // this whenever the way sections are written changes; objects in any other
+    // format are rejected rather than misread.
+    //  -> 1: sizes, counts and ids are LEB128 varints
+    static const u16 OBJECT_FORMAT_VERSION = 1;
+
     // Helpers to read/write various things
+    //
+    // Sizes, counts and ids are written as LEB128 varints, since they're almost
+    // always small. Signed integers are zigzag-encoded first.
 
     static buffer TEMP;
 
     // Byte string
-    // 4 bytes (LE)     - Size in bytes
+    // Varint           - Size in bytes
     // ? bytes          - String contents, UTF-8
 
     void write_string(const string& s, bytebuf& buf) {
-        buf.write<u32>(little_endian<u32>(s.size()));
-        for (u32 i = 0; i < s.size(); i ++) buf.write<u8>(s[i]);
+        buf.write_varint(s.size());
+        buf.write(s.raw(), s.size());
     }
 
     void write_string(const char* s, bytebuf& buf) {
         write_string(string(s), buf);
     }
 
-    string read_string(bytebuf& buf) {
-        u32 len = from_little_endian<u32>(buf.read<u32>());
+    string read_string(bytereader& buf) {
+        u32 len = buf.read_varint();
         string s;
-        for (u32 i = 0; i < len; i ++) s += buf.read<u8>();
+        u8 chunk[256];
+        while (len) {
+            u32 n = len < sizeof(chunk) ? len : sizeof(chunk);
+            buf.read(chunk, n);
+            for (u32 i = 0; i < n; i ++) s += chunk[i];
+            len -= n;
+        }
         return s;
     }
 
     // UTF-8 string
-    // 4 bytes (LE)     - Size in bytes
+    // Varint           - Size in bytes
     // ? bytes          - String contents, UTF-8
 
     void write_string(const ustring& s, bytebuf& buf) {
-        if (TEMP.size() != 0) panic("TEMP buffer was not empty before serializing string!");
-        write(TEMP, s);
-        u32 len = TEMP.size();
-        buf.write<u32>(little_endian<u32>(len));
-        for (u32 i = 0; i < len; i ++) buf.write<u8>(TEMP.read());
-        if (TEMP.size() != 0) panic("TEMP buffer is not empty after serializing string!");
+        buf.write_varint(s.bytes());
+        buf.write(s.raw(), s.bytes());
     }
 
-    ustring read_ustring(bytebuf& buf) {
-        u32 len = from_little_endian<u32>(buf.read<u32>());
-        if (TEMP.size() != 0) panic("TEMP buffer was not empty before deserializing string!");
-        for (u32 i = 0; i < len; i ++) TEMP.write(buf.read<u8>());
-        string s(TEMP); // read
-        if (TEMP.size() != 0) panic("TEMP buffer is not empty after deserializing string!");
-        return ustring(s);
+    ustring read_ustring(bytereader& buf) {
+        u32 len = buf.read_varint();
+        const u8* bytes = buf.view(len);
+        if (!len || !bytes) return ustring();
+        return ustring(const_slice<u8>{len, bytes});
     }
 
     // Symbol
@@ -83,7 +92,7 @@ namespace basil {
         write_string(string_from(symbol), buf);
     }
 
-    Symbol read_symbol(bytebuf& buf) {
+    Symbol read_symbol(bytereader& buf) {
         return symbol_from(read_ustring(buf));
     }
 
@@ -102,7 +111,7 @@ namespace basil {
         buf.write<u8>(kind);
     }
 
-    ParamKind read_param_kind(bytebuf& buf) {
+    ParamKind read_param_kind(bytereader& buf) {
         return (ParamKind)buf.read<u8>();
     }
 
@@ -131,7 +140,7 @@ namespace basil {
         }
     }
 
-    Param read_param(bytebuf& buf) {
+    Param read_param(bytereader& buf) {
         ParamKind pk = read_param_kind(buf);
         switch (pk) {
             case PK_VARIABLE:
@@ -168,7 +177,7 @@ namespace basil {
         buf.write<u8>(fk);
     }
 
-    FormKind read_form_kind(bytebuf& buf) {
+    FormKind read_form_kind(bytereader& buf) {
         return (FormKind)buf.read<u8>();
     }
 
@@ -178,15 +187,15 @@ namespace basil {
     //    1 byte           - Associativity
     //         -> ASSOC_LEFT = 0
     //         -> ASSOC_RIGHT = 1
-    //    8 bytes (LE)     - Precedence as signed integer
+    //    Signed varint    - Precedence
     //  Callable:
     //    1 byte                - Number of params (N)
     //    [Param]*N bytes       - Param list
     //  Overloaded:
-    //    4 bytes               - Number of overloads
+    //    Varint                - Number of overloads
     //    [Callable]*N bytes    - Overload list
     //  Compound:
-    //    4 bytes                   - Number of members
+    //    Varint                    - Number of members
     //    [(Symbol, Value)]*N       - Member list
 
     void write_form(rc<Form> form, bytebuf& buf) {
@@ -196,7 +205,7 @@ namespace basil {
         buf.write<u8>(form->is_macro ? 1 : 0);
         if (form->kind == FK_CALLABLE || form->kind == FK_OVERLOADED) {
             buf.write<u8>(form->assoc);
-            buf.write<i64>(little_endian<i64>(form->precedence));
+            buf.write_svarint(form->precedence);
         }
         if (form->kind == FK_CALLABLE) {
             buf.write<u8>(((rc<Callable>)form->invokable)->parameters->size());
@@ -204,7 +213,7 @@ namespace basil {
                 write_param(p, buf);
         }
         else if (form->kind == FK_OVERLOADED) {
-            buf.write<u32>(little_endian<u32>(((rc<Overloaded>)form->invokable)->overloads.size()));
+            buf.write_varint(((rc<Overloaded>)form->invokable)->overloads.size());
             for (rc<Callable> callable : ((rc<Overloaded>)form->invokable)->overloads) {
                 buf.write<u8>(callable->parameters->size());
                 for (const Param& p : *callable->parameters)
@@ -216,17 +225,17 @@ namespace basil {
         }
     }
 
-    rc<Form> read_form(bytebuf& buf) {
+    rc<Form> read_form(bytereader& buf) {
         static vector<rc<Form>> callables;
         static vector<Param> params;
         
         FormKind fk = read_form_kind(buf);
+        if (fk == FK_NONE) return nullptr; // written without a macro flag
         rc<Form> form;
         bool is_macro = buf.read<u8>();
-        if (fk == FK_NONE) return nullptr;
-        else if (fk == FK_CALLABLE) {
+        if (fk == FK_CALLABLE) {
             Associativity assoc = (Associativity)buf.read<u8>();
-            i64 prec = from_little_endian<i64>(buf.read<i64>());
+            i64 prec = buf.read_svarint();
 
             u8 nparams = buf.read<u8>();
             params.clear();
@@ -235,9 +244,9 @@ namespace basil {
         }
         else if (fk == FK_OVERLOADED) {
             Associativity assoc = (Associativity)buf.read<u8>();
-            i64 prec = from_little_endian<i64>(buf.read<i64>());
+            i64 prec = buf.read_svarint();
 
-            u32 nforms = from_little_endian<u32>(buf.read<u32>());
+            u32 nforms = buf.read_varint();
             callables.clear();
             for (u32 i = 0; i < nforms; i ++) {
                 u8 nparams = buf.read<u8>();
@@ -267,7 +276,7 @@ namespace basil {
         buf.write<u8>(kind);
     }
 
-    Kind read_kind(bytebuf& buf) {
+    Kind read_kind(bytereader& buf) {
         return (Kind)buf.read<u8>();
     }
 
@@ -279,7 +288,7 @@ namespace basil {
         buf.write<u64>(little_endian<u64>(packed));
     }
 
-    Source::Pos read_pos(bytebuf& buf) {
+    Source::Pos read_pos(bytereader& buf) {
         u64 packed = from_little_endian<u64>(buf.read<u64>());
         return *(Source::Pos*)&packed;
     }
@@ -289,18 +298,18 @@ namespace basil {
     //   List:
     //      Type                 - Element type
     //   Tuple type:
-    //      4 bytes (LE)         - Number of members N
+    //      Varint               - Number of members N
     //      [Type]*N             - Member types
     //      1 byte               - Complete?
     //   Array type:
     //      Type                 - Element type
     //      1 byte               - Is sized?
-    //       -> 4 byte           - Size
+    //       -> Varint           - Size
     //   Union type:
-    //      4 bytes (LE)         - Number of members N
+    //      Varint               - Number of members N
     //      [Type]*N             - Member types
     //   Intersection type:
-    //      4 bytes (LE)         - Number of members N
+    //      Varint               - Number of members N
     //      [Type]*N             - Member types
     //   Named type:
     //      Symbol              - Name
@@ -309,7 +318,7 @@ namespace basil {
     //      Type                - Argument type
     //      Type                - Return type
     //   Struct type:
-    //      4 bytes (LE)         - Number of fields N
+    //      Varint               - Number of fields N
     //      [(Symbol, Type)]*N   - Fields
     //      1 byte               - Complete?
     //   Dict type:
@@ -321,33 +330,33 @@ namespace basil {
     //      Symbol               - Variable name
     //      Type                 - Concrete type
     //   Form-function type:    
-    //      4 bytes (LE)         - Arity
+    //      Varint               - Arity
     //   Form-intersect type:
-    //      4 bytes (LE)         - Number of entries N
+    //      Varint               - Number of entries N
     //      [(Form, Type)]*N     - Entries
     void write_type(Type type, bytebuf& buf) {
         write_kind(type.true_kind(), buf);
         switch (type.true_kind()) {
             case K_LIST: return write_type(t_list_element(type), buf);
             case K_TUPLE:
-                buf.write<u32>(little_endian<u32>(t_tuple_len(type)));
+                buf.write_varint(t_tuple_len(type));
                 for (u32 i = 0; i < t_tuple_len(type); i ++) write_type(t_tuple_at(type, i), buf);
                 buf.write<u8>(t_tuple_is_complete(type) ? 1 : 0);
                 return;
             case K_ARRAY:
                 write_type(t_array_element(type), buf);
                 buf.write<u8>(t_array_is_sized(type) ? 1 : 0);
-                if (t_array_is_sized(type)) buf.write<u32>(little_endian<u32>(t_array_size(type)));
+                if (t_array_is_sized(type)) buf.write_varint(t_array_size(type));
                 return;
             case K_UNION: {
                 auto members = t_union_members(type);
-                buf.write<u32>(little_endian<u32>(members.size()));
+                buf.write_varint(members.size());
                 for (Type t : members) write_type(t, buf);
                 return;
             }
             case K_INTERSECT: {
                 auto members = t_intersect_members(type);
-                buf.write<u32>(little_endian<u32>(members.size()));
+                buf.write_varint(members.size());
                 for (Type t : members) write_type(t, buf);
                 return;
             }
@@ -362,7 +371,7 @@ namespace basil {
                 return;
             case K_STRUCT: {
                 auto fields = t_struct_fields(type);
-                buf.write<u32>(little_endian<u32>(fields.size()));
+                buf.write_varint(fields.size());
                 for (const auto& [k, v] : fields) {
                     write_symbol(k, buf);
                     write_type(v, buf);
@@ -380,11 +389,11 @@ namespace basil {
                 write_type(t_tvar_concrete(type), buf);
                 return;
             case K_FORM_FN:
-                buf.write<u32>(little_endian<u32>(t_form_fn_arity(type)));
+                buf.write_varint(t_form_fn_arity(type));
                 return;
             case K_FORM_ISECT: {
                 auto overloads = t_form_isect_members(type);
-                buf.write<u32>(little_endian<u32>(overloads.size()));
+                buf.write_varint(overloads.size());
                 for (const auto& [k, v] : overloads) {
                     write_form(k, buf);
                     write_type(v, buf);
@@ -395,7 +404,7 @@ namespace basil {
         }
     }
 
-    Type read_type(bytebuf& buf) {
+    Type read_type(bytereader& buf) {
         Kind k = read_kind(buf);
         switch (k) {
             case K_INT: return T_INT;
@@ -413,23 +422,23 @@ namespace basil {
             case K_BOOL: return T_BOOL;
             case K_LIST: return t_list(read_type(buf));
             case K_TUPLE: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 vector<Type> ts;
                 for (u32 i = 0; i < n; i ++) ts.push(read_type(buf));
                 return buf.read<u8>() ? t_tuple(ts) : t_incomplete_tuple(ts);
             }
             case K_ARRAY: {
                 Type t = read_type(buf);
-                return buf.read<u8>() ? t_array(t, from_little_endian<u32>(buf.read<u32>())) : t_array(t);
+                return buf.read<u8>() ? t_array(t, buf.read_varint()) : t_array(t);
             }
             case K_UNION: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 set<Type> ts;
                 for (u32 i = 0; i < n; i ++) ts.insert(read_type(buf));
                 return t_union(ts);
             }
             case K_INTERSECT: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 vector<Type> ts;
                 for (u32 i = 0; i < n; i ++) ts.push(read_type(buf));
                 return t_intersect(ts);
@@ -445,7 +454,7 @@ namespace basil {
             }
             case K_STRUCT: {
                 map<Symbol, Type> fields;
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 for (u32 i = 0; i < n; i ++) {
                     Symbol s = read_symbol(buf);
                     Type t = read_type(buf);
@@ -465,9 +474,9 @@ namespace basil {
                 t_tvar_bind(tvar, base);
                 return tvar;
             }
-            case K_FORM_FN: return t_form_fn(from_little_endian<u32>(buf.read<u32>()));
+            case K_FORM_FN: return t_form_fn(buf.read_varint());
             case K_FORM_ISECT: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 map<rc<Form>, Type> overloads;
                 for (u32 i = 0; i < n; i ++) {
                     rc<Form> form = read_form(buf);
@@ -486,34 +495,34 @@ namespace basil {
     // (terms are a subset of values that can be produced by the parser)
     // Kind (1 byte)
     //   Int:
-    //      8 bytes (LE)        - Signed integer value
+    //      Signed varint       - Integer value
     //   Float:
     //      4 bytes (LE)        - 32-bit float value
     //   Double:
     //      8 bytes (LE)        - 64-bit float value
     //   Char:                  
-    //      4 bytes (LE)        - UTF-8 code point
+    //      Varint              - UTF-8 code point
     //   String:
     //      [UTF-8 string]      - UTF-8 string value
     //   Symbol:
     //      [Symbol]            - Symbol value
     //   List:
-    //      4 bytes (LE)        - Number of elements (N)
+    //      Varint              - Number of elements (N)
     //      [Term]*N            - Element list
 
     void write_term(const Value& term, const Section& section, bytebuf& buf) {
         write_kind(term.type.kind(), buf);
         write_pos(term.pos, buf);
         switch (term.type.kind()) {
-            case K_INT: return buf.write<i64>(little_endian<i64>(term.data.i));
+            case K_INT: return buf.write_svarint(term.data.i);
             case K_FLOAT: return buf.write<u32>(little_endian<u32>(*(u32*)&term.data.f32));
             case K_DOUBLE: return buf.write<u64>(little_endian<u64>(*(u64*)&term.data.f64));
-            case K_CHAR: return buf.write<u32>(little_endian<u32>(term.data.ch.u));
+            case K_CHAR: return buf.write_varint(term.data.ch.u);
             case K_STRING: return write_string(term.data.string->data, buf);
             case K_SYMBOL: return write_symbol(term.data.sym, buf);
             case K_VOID: return;
             case K_LIST: 
-                buf.write<u32>(little_endian<u32>(v_list_len(term)));
+                buf.write_varint(v_list_len(term));
                 for (const Value& v : iter_list(term)) write_term(v, section, buf);
                 return;
             default:
@@ -522,20 +531,20 @@ namespace basil {
         }
     }
 
-    Value read_term(const Section& section, bytebuf& buf) {
+    Value read_term(const Section& section, bytereader& buf) {
         Kind k = (Kind)buf.read();
         Source::Pos pos = read_pos(buf);
         switch (k) {
-            case K_INT: return v_int(pos, from_little_endian<i64>(buf.read<i64>()));
+            case K_INT: return v_int(pos, buf.read_svarint());
             case K_FLOAT: return v_float(pos, (const float&)from_little_endian<u32>(buf.read<u32>()));
             case K_DOUBLE: return v_double(pos, (const double&)from_little_endian<u64>(buf.read<u64>()));
-            case K_CHAR: return v_char(pos, rune{from_little_endian<u32>(buf.read<u32>())});
+            case K_CHAR: return v_char(pos, rune{u32(buf.read_varint())});
             case K_STRING: return v_string(pos, read_ustring(buf));
             case K_SYMBOL: return v_symbol(pos, read_symbol(buf));
             case K_VOID: return v_void(pos);
             case K_LIST: {
                 vector<Value> values;
-                u32 len = from_little_endian<u32>(buf.read<u32>());
+                u32 len = buf.read_varint();
                 for (u32 i = 0; i < len; i ++)
                     values.push(read_term(section, buf));
                 return v_list(pos, t_list(T_ANY), move(values));
@@ -549,7 +558,7 @@ namespace basil {
     struct EnvTable;
     
     void write_value(const Value& v, const EnvTable& envs, bytebuf& buf);
-    Value read_value(bytebuf& buf, const EnvTable& envs);
+    Value read_value(bytereader& buf, const EnvTable& envs);
 
     struct EnvTable {
         rc<Env> global;
@@ -581,15 +590,15 @@ namespace basil {
         }
 
         void write_envs(bytebuf& buf) {
-            buf.write<u32>(little_endian<u32>(envs.size()));
-            for (rc<Env> env : envs) buf.write<u32>(little_endian<u32>(env->children.size()));
+            buf.write_varint(envs.size());
+            for (rc<Env> env : envs) buf.write_varint(env->children.size());
         }
 
         void write_all(bytebuf& buf) {
             write_envs(buf);
             
             for (rc<Env> env : envs) {
-                buf.write<u32>(little_endian<u32>(env->values.size()));
+                buf.write_varint(env->values.size());
                 for (const auto& [k, v] : env->values) {
                     write_symbol(k, buf);
                     write_value(v, *this, buf);
@@ -597,28 +606,28 @@ namespace basil {
             }
         }
 
-        rc<Env> read_env(rc<Env> parent, bytebuf& buf) {
+        rc<Env> read_env(rc<Env> parent, bytereader& buf) {
             rc<Env> env = extend(parent);
             env_ids[u64(env.raw())] = envs.size();
             envs.push(env);
-            u32 n_children = from_little_endian<u32>(buf.read<u32>());
+            u32 n_children = buf.read_varint();
             for (u32 i = 0; i < n_children; i ++) {
                 env->children.push(read_env(env, buf));
             }
             return env;
         }
 
-        rc<Env> read_envs(bytebuf& buf) {
-            u32 n_envs = from_little_endian<u32>(buf.read<u32>());
+        rc<Env> read_envs(bytereader& buf) {
+            u32 n_envs = buf.read_varint();
             if (!n_envs) return nullptr;
             else return read_env(root_env(), buf);
         }
 
-        rc<Env> read_all(bytebuf& buf) {
+        rc<Env> read_all(bytereader& buf) {
             rc<Env> global = read_envs(buf);
 
             for (rc<Env> env : envs) {
-                u32 n_vals = from_little_endian<u32>(buf.read<u32>());
+                u32 n_vals = buf.read_varint();
                 for (u32 i = 0; i < n_vals; i ++) {
                     env->def(read_symbol(buf), read_value(buf, *this));
                 }
@@ -633,7 +642,7 @@ namespace basil {
     // [Form]                   - Form of this value (defaults to Term)
     // [Type]                   - Type of this value
     //    Int:
-    //      8 bytes (LE)        - Integer value
+    //      Signed varint       - Integer value
     //    Float:
     //      4 bytes (LE)        - Float value
     //    Double:
@@ -641,7 +650,7 @@ namespace basil {
     //    Bool:
     //      1 byte              - Boolean value
     //    Char:
-    //      4 bytes (LE)        - UTF-8 code point value
+    //      Varint              - UTF-8 code point value
     //    Symbol:
     //      [Symbol]            - Symbol name
     //    String:
@@ -649,39 +658,39 @@ namespace basil {
     //    Type:
     //      [Type]              - Type value
     //    Module:
-    //      4 bytes (LE)        - Environment ID
+    //      Varint              - Environment ID
     //    List:
-    //      4 bytes (LE)        - Number of items N
+    //      Varint              - Number of items N
     //      [Value]*N           - Elements
     //    Tuple:
     //      [Value]*N           - Elements (N based on type)
     //    Array:
-    //      4 bytes (LE)?       - Size N (if array type is unsized)
+    //      Varint?             - Size N (if array type is unsized)
     //      [Value]*N           - Elements
     //    Union:
     //      [Value]             - Value
     //    Intersect:
-    //      4 bytes (LE)        - Number of elements N
+    //      Varint              - Number of elements N
     //      [(Type, Value)]*N   - Elements
     //    Function:
     //      1 byte              - Is this a builtin?
     //      If builtin:
     //         [Symbol]         - Root env name of this builtin
     //      If not builtin:
-    //         4 bytes (LE)     - Environment ID
-    //         4 bytes (LE)     - Number of arguments N
+    //         Varint           - Environment ID
+    //         Varint           - Number of arguments N
     //         [Symbol]*N       - Argument names
     //         [Value]          - Body term
     //         1 byte           - Named?
     //         If named:
     //           [Symbol]       - Function name
     //    FormFunction:
-    //      4 bytes (LE)        - Environment ID
-    //      4 bytes (LE)        - Number of arguments N
+    //      Varint              - Environment ID
+    //      Varint              - Number of arguments N
     //      [Symbol]*N          - Argument names
     //      [Value]             - Body term
     //    FormIsect:
-    //      4 bytes (LE)        - Number of elements N
+    //      Varint              - Number of elements N
     //      [(Form, Value)]*N   - Elements
 
     void write_value(const Value& v, const EnvTable& envs, bytebuf& buf) {
@@ -689,24 +698,24 @@ namespace basil {
         write_form(v.form, buf);
         write_type(v.type, buf);
         switch (v.type.true_kind()) {
-            case K_INT: buf.write<i64>(little_endian<i64>(v.data.i)); break;
+            case K_INT: buf.write_svarint(v.data.i); break;
             case K_FLOAT: buf.write<float>(little_endian<float>(v.data.f32)); break;
             case K_DOUBLE: buf.write<double>(little_endian<double>(v.data.f64)); break;
             case K_BOOL: buf.write<u8>(v.data.b ? 1 : 0); break;
-            case K_CHAR: buf.write<u32>(little_endian<u32>(v.data.ch)); break;
+            case K_CHAR: buf.write_varint(v.data.ch); break;
             case K_SYMBOL: write_symbol(v.data.sym, buf); break;
             case K_STRING: write_string(v.data.string->data, buf); break;
             case K_TYPE: write_type(v.data.type, buf); break;
-            case K_MODULE: buf.write<u32>(little_endian<u32>(envs.id_for(v.data.mod->env))); break;
+            case K_MODULE: buf.write_varint(envs.id_for(v.data.mod->env)); break;
             case K_LIST:
-                buf.write<u32>(little_endian<u32>(v_list_len(v)));
+                buf.write_varint(v_list_len(v));
                 for (const Value& e : iter_list(v)) write_value(e, envs, buf);
                 break;
             case K_TUPLE:
                 for (u32 i = 0; i < v_len(v); i ++) write_value(v_at(v, i), envs, buf);
                 break;
             case K_ARRAY:
-                if (!t_array_is_sized(v.type)) buf.write<u32>(little_endian<u32>(v_len(v)));
+                if (!t_array_is_sized(v.type)) buf.write_varint(v_len(v));
                 for (u32 i = 0; i < v_len(v); i ++) write_value(v_at(v, i), envs, buf);
                 break;
             case K_UNION:
@@ -716,8 +725,8 @@ namespace basil {
                 buf.write<u8>(v.data.fn->builtin ? 1 : 0);
                 if (v.data.fn->builtin) write_symbol(*builtin_name(*v.data.fn->builtin), buf);
                 else {
-                    buf.write<u32>(little_endian<u32>(envs.id_for(v.data.fn->env)));
-                    buf.write<u32>(little_endian<u32>(v.data.fn->args.size()));
+                    buf.write_varint(envs.id_for(v.data.fn->env));
+                    buf.write_varint(v.data.fn->args.size());
                     for (Symbol s : v.data.fn->args) write_symbol(s, buf);
                     write_value(v.data.fn->body, envs, buf);
                     buf.write<u8>(v.data.fn->name ? 1 : 0);
@@ -725,20 +734,20 @@ namespace basil {
                 }
                 break;
             case K_FORM_FN:
-                buf.write<u32>(little_endian<u32>(envs.id_for(v.data.fl_fn->env)));
-                buf.write<u32>(little_endian<u32>(v.data.fl_fn->args.size()));
+                buf.write_varint(envs.id_for(v.data.fl_fn->env));
+                buf.write_varint(v.data.fl_fn->args.size());
                 for (Symbol s : v.data.fl_fn->args) write_symbol(s, buf);
                 write_value(v.data.fl_fn->body, envs, buf);
                 break;
             case K_INTERSECT:
-                buf.write<u32>(little_endian<u32>(v.data.isect->values.size()));
+                buf.write_varint(v.data.isect->values.size());
                 for (const auto& [k, v] : v.data.isect->values) {
                     write_type(k, buf);
                     write_value(v, envs, buf);
                 }
                 break;
             case K_FORM_ISECT:
-                buf.write<u32>(little_endian<u32>(v.data.fl_isect->overloads.size()));
+                buf.write_varint(v.data.fl_isect->overloads.size());
                 for (const auto& [k, v] : v.data.fl_isect->overloads) {
                     write_form(k, buf);
                     write_value(v, envs, buf);
@@ -749,24 +758,24 @@ namespace basil {
         }
     }
 
-    Value read_value(bytebuf& buf, const EnvTable& envs) {
+    Value read_value(bytereader& buf, const EnvTable& envs) {
         Value v;
         v.pos = read_pos(buf);
         v.form = read_form(buf);
         v.type = read_type(buf);
         v.data.i = 0; // kind of a hack...we zero out all the refcells by doing this
         switch (v.type.true_kind()) {
-            case K_INT: v.data.i = from_little_endian<i64>(buf.read<i64>()); break;
+            case K_INT: v.data.i = buf.read_svarint(); break;
             case K_FLOAT: v.data.f32 = from_little_endian<float>(buf.read<float>()); break;
             case K_DOUBLE: v.data.f64 = from_little_endian<double>(buf.read<double>()); break;
             case K_BOOL: v.data.b = buf.read<u8>(); break;
-            case K_CHAR: v.data.ch = from_little_endian<u32>(buf.read<u32>()); break;
+            case K_CHAR: v.data.ch = buf.read_varint(); break;
             case K_SYMBOL: v.data.sym = read_symbol(buf); break;
             case K_STRING: v.data.string = ref<String>(read_ustring(buf)); break;
             case K_TYPE: v.data.type = read_type(buf); break;
-            case K_MODULE: v.data.mod = ref<Module>(envs.env_for(from_little_endian<u32>(buf.read<u32>()))); break;
+            case K_MODULE: v.data.mod = ref<Module>(envs.env_for(buf.read_varint())); break;
             case K_LIST: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 rc<List> l = nullptr;
                 vector<Value> vals;
                 for (u32 i = 0; i < n; i ++) vals.push(read_value(buf, envs));
@@ -781,7 +790,7 @@ namespace basil {
                 break;
             }
             case K_ARRAY: {
-                u32 n = t_array_is_sized(v.type) ? t_array_size(v.type) : from_little_endian<u32>(buf.read<u32>());
+                u32 n = t_array_is_sized(v.type) ? t_array_size(v.type) : buf.read_varint();
                 vector<Value> values;
                 for (u32 i = 0; i < n; i ++) values.push(read_value(buf, envs));
                 v.data.array = ref<Array>(values);
@@ -794,8 +803,8 @@ namespace basil {
                 if (buf.read<u8>()) {
                     return *root_env()->find(read_symbol(buf)); // builtin
                 }
-                rc<Env> env = envs.env_for(from_little_endian<u32>(buf.read<u32>()));
-                u32 n_args = from_little_endian<u32>(buf.read<u32>());
+                rc<Env> env = envs.env_for(buf.read_varint());
+                u32 n_args = buf.read_varint();
                 vector<Symbol> args;
                 for (u32 i = 0; i < n_args; i ++) args.push(read_symbol(buf));
                 Value body = read_value(buf, envs);
@@ -804,8 +813,8 @@ namespace basil {
                 break;
             }
             case K_FORM_FN: {
-                rc<Env> env = envs.env_for(from_little_endian<u32>(buf.read<u32>()));
-                u32 n_args = from_little_endian<u32>(buf.read<u32>());
+                rc<Env> env = envs.env_for(buf.read_varint());
+                u32 n_args = buf.read_varint();
                 vector<Symbol> args;
                 for (u32 i = 0; i < n_args; i ++) args.push(read_symbol(buf));
                 Value body = read_value(buf, envs);
@@ -813,7 +822,7 @@ namespace basil {
                 break;
             }
             case K_INTERSECT: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 map<Type, Value> values;
                 for (u32 i = 0; i < n; i ++) {
                     Type t = read_type(buf);
@@ -824,7 +833,7 @@ namespace basil {
                 break;
             }
             case K_FORM_ISECT: {
-                u32 n = from_little_endian<u32>(buf.read<u32>());
+                u32 n = buf.read_varint();
                 map<rc<Form>, Value> values;
                 for (u32 i = 0; i < n; i ++) {
                     rc<Form> f = read_form(buf);
@@ -842,16 +851,16 @@ namespace basil {
 
     void write_def(Symbol name, const DefInfo& def, bytebuf& buf) {
         write_symbol(name, buf);
-        buf.write<u32>(little_endian<u32>(def.offset));
+        buf.write_varint(def.offset);
         buf.write<u8>(def.form ? 1 : 0);
         buf.write<u8>(def.type ? 1 : 0);
         if (def.form) write_form(*def.form, buf);
         if (def.type) write_type(*def.type, buf);
     }
 
-    pair<Symbol, DefInfo> read_def(bytebuf& buf) {
+    pair<Symbol, DefInfo> read_def(bytereader& buf) {
         Symbol s = read_symbol(buf);
-        u32 offset = from_little_endian<u32>(buf.read<u32>());
+        u32 offset = buf.read_varint();
         bool has_form = buf.read<u8>();
         bool has_type = buf.read<u8>();
         DefInfo info = { offset, none<rc<Form>>(), none<Type>() };
@@ -868,7 +877,7 @@ namespace basil {
     void Section::serialize_header(bytebuf& buf) {
         buf.write<u8>(type);
         write_string(name, buf);
-        buf.write<u32>(little_endian<u32>(defs.size()));
+        buf.write_varint(defs.size());
         for (const auto& [k, v] : defs) {
             write_def(k, v, buf);
         }
@@ -879,8 +888,8 @@ namespace basil {
         SourceSection(const ustring& name):
             Section(ST_SOURCE, name, map<Symbol, DefInfo>()) {}
         
-        void deserialize(bytebuf& buf) {
-            u32 len = little_endian<u32>(buf.read<u32>());
+        void deserialize(bytereader& buf) {
+            u32 len = buf.read_varint();
             buffer tmp;
             for (u32 i = 0; i < len; i ++) {
                 tmp.write(buf.read());
@@ -895,7 +904,7 @@ namespace basil {
                 write(TEMP, s);
             }
             u32 len = TEMP.size();
-            buf.write<u32>(little_endian<u32>(len));
+            buf.write_varint(len);
             for (u32 i = 0; i < len; i ++) buf.write(TEMP.read());
             if (TEMP.size() != 0) panic("TEMP buffer is not empty after serializing source!");
         }
@@ -906,7 +915,7 @@ namespace basil {
         ParsedSection(const ustring& name):
             Section(ST_PARSED, name, map<Symbol, DefInfo>()) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             term = read_term(*this, buf);
         }
 
@@ -921,7 +930,7 @@ namespace basil {
         ModuleSection(const ustring& name, const map<Symbol, DefInfo>& defs):
             Section(ST_EVAL, name, defs) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             EnvTable table;
             env = table.read_all(buf);
             main = read_value(buf, table);
@@ -942,7 +951,7 @@ namespace basil {
         ASTSection(const ustring& name, const map<Symbol, DefInfo>& defs):
             Section(ST_AST, name, defs) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             panic("Unimplemented!");
         }
 
@@ -957,7 +966,7 @@ namespace basil {
         IRSection(const ustring& name, const map<Symbol, DefInfo>& defs):
             Section(ST_IR, name, defs) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             panic("Unimplemented!");
         }
 
@@ -971,7 +980,7 @@ namespace basil {
         JasmineSection(const ustring& name, const map<Symbol, DefInfo>& defs):
             Section(ST_JASMINE, name, defs) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             panic("Unimplemented!");
         }
 
@@ -985,7 +994,7 @@ namespace basil {
         NativeSection(const ustring& name, const map<Symbol, DefInfo>& defs):
             Section(ST_NATIVE, name, defs) {}
         
-        void deserialize(bytebuf& buf) {
+        void deserialize(bytereader& buf) {
             panic("Unimplemented!");
         }
 
@@ -1020,8 +1029,24 @@ namespace basil {
 
     // Loads this object in full from the provided stream.
     void Object::read(stream& io) {
-        bytebuf buf;
-        while (io) buf.write<u8>(io.read());
+        // read the whole input into one block, so sections can be parsed in place
+        u64 size = 0, capacity = 4096;
+        u8* data = new u8[capacity];
+        while (u64 n = io.read(data + size, capacity - size)) {
+            size += n;
+            if (size < capacity) continue;
+            u8* old = data;
+            data = new u8[capacity *= 2];
+            memcpy(data, old, size);
+            delete[] old;
+        }
+        bytereader buf(data, size);
+        read(buf);
+        delete[] data;
+    }
+
+    // Loads this object in full from the provided reader.
+    void Object::read(bytereader& buf) {
         char magic[11];
         for (u32 i = 0; i < 10; i ++) magic[i] = buf.read<u8>();
         magic[10] = '\0';
@@ -1048,12 +1073,17 @@ namespace basil {
             return err({}, "Main section index is too high: main index is ", *main_section, 
                 ", but object only has ", num_sections, " sections.");
 
-        for (u32 i = 0; i < 8; i ++) buf.read<u8>(); // unused
+        u16 format = from_little_endian<u16>(buf.read<u16>());
+        if (format != OBJECT_FORMAT_VERSION)
+            return err({}, "Basil object was written in object format ", format, 
+                ", but compiler only reads format ", OBJECT_FORMAT_VERSION, "; recompile it from source!");
+
+        for (u32 i = 0; i < 6; i ++) buf.read<u8>(); // unused
 
         for (u32 i = 0; i < num_sections; i ++) {
             SectionType type = (SectionType)buf.read<u8>();
             ustring name = read_ustring(buf);
-            u32 num_defs = from_little_endian<u32>(buf.read<u32>());
+            u32 num_defs = buf.read_varint();
             map<Symbol, DefInfo> defs;
             for (u32 j = 0; j < num_defs; j ++)
                 defs.insert(read_def(buf));
@@ -1072,12 +1102,18 @@ namespace basil {
         buf.write<u16>(little_endian<u16>(version.patch));
         buf.write<u32>(little_endian<u32>(sections.size()));
         buf.write<i32>(little_endian<i32>(main_section ? *main_section : -1));
-        for (u32 i = 0; i < 8; i ++) buf.write<u8>(0); // unused
+        buf.write<u16>(little_endian<u16>(OBJECT_FORMAT_VERSION));
+        for (u32 i = 0; i < 6; i ++) buf.write<u8>(0); // unused
         for (rc<Section> section : sections) {
             section->serialize_header(buf);
             section->serialize(buf);
         }
-        while (buf.size()) io.write(buf.read());
+        u8 chunk[4096];
+        while (buf.size()) {
+            u64 n = buf.size() < sizeof(chunk) ? buf.size() : sizeof(chunk);
+            buf.read(chunk, n);
+            io.write(chunk, n);
+        }
     }
 
     rc<Source> source_from_section(rc<Section> section) {
@@ -66,7 +66,7 @@ namespace basil {
 
         // Fills in all internal data structures besides 'type' and 'defs' with
         // data from the provided buffer.
-        virtual void deserialize(bytebuf& buf) = 0;
+        virtual void deserialize(bytereader& buf) = 0;
 
         // Writes all internal data structures besides 'type' and 'defs' to the
         // provided buffer.
@@ -90,6 +90,9 @@ namespace basil {
         // Loads this object in full from the provided stream.
         void read(stream& io);
 
+        // Loads this object in full from the provided reader, in place.
+        void read(bytereader& buf);
+
         // Writes this object to the provided stream.
         void write(stream& io);
 
@@ -11,6 +11,7 @@
 #include "util/io.h"
 #include "errors.h"
 #include "util/utf8.h"
+#include "string.h"
 
 namespace basil {
     void Source::check_limits() const {
@@ -18,66 +19,114 @@ namespace basil {
             err(full_span(), "Source file ", filepath ? *filepath : "", " with ", lines.size(),
                 " lines exceeds maximum length of 1000000 lines.");
         else for (u32 i = 0; i < lines.size(); i ++) {
-            if (lines[i]->size() > 4000)
+            if ((*this)[i].size() > 4000)
                 err(line_span(i), "Line ", i, " of source file ", filepath ? *filepath : "", 
-                    " with length ", lines[i]->size(), " exceeds maximum line length of 4000 characters.");
+                    " with length ", (*this)[i].size(), " exceeds maximum line length of 4000 characters.");
         }
     }
 
-    ustring* process_line(const string& s) {
-        ustring line(s);
-        ustring* u = new ustring();
-        for (rune r : line) {
-            if (r == '\t') *u += "    ";
-            else *u += r;
+    void Source::reserve_text(u32 n) {
+        if (text_size + n <= text_capacity) return;
+        u32 new_capacity = text_capacity ? text_capacity : 256;
+        while (new_capacity < text_size + n) new_capacity *= 2;
+        u8* new_text = new u8[new_capacity];
+        if (text) memcpy(new_text, text, text_size), delete[] text;
+        text = new_text, text_capacity = new_capacity;
+    }
+
+    void Source::append_text(const u8* bytes, u32 n) {
+        if (!n) return;
+        reserve_text(n);
+        memcpy(text + text_size, bytes, n);
+        text_size += n;
+    }
+
+    void Source::index_lines(u32 from) {
+        // memchr is typically vectorized, so this is much quicker than looking at
+        // each byte ourselves.
+        const u8 *it = text + from, *end = text + text_size;
+        while (it != end) {
+            const u8* nl = (const u8*)memchr(it, '\n', end - it);
+            it = nl ? nl + 1 : end;
+            line_starts.push(it - text);
+            lines.push(nullptr);
+        }
+    }
+
+    void Source::finish_text() {
+        const u8* nul = text_size ? (const u8*)memchr(text, '\0', text_size) : nullptr;
+        if (nul) text_size = nul - text; // like any other text stream, we stop at a null character
+        if (text_size > 0 && text[text_size - 1] != '\n') {
+            u8 nl = '\n';
+            append_text(&nl, 1);
         }
-        return u;
+        index_lines(0);
     }
 
-    Source::Source() {}
+    ustring* Source::decode_line(u32 i) const {
+        const u8* start = text + line_starts[i];
+        u32 n = line_starts[i + 1] - line_starts[i];
+        if (!memchr(start, '\t', n)) return new ustring(const_slice<u8>(n, start));
 
-    Source::Source(const ustring& filename):
-        filepath(some<ustring>(filename)) {
-        file f((const char*)filename.raw(), "r");
-        if (!f) {
+        string s; // we're using this as a byte buffer
+        for (u32 j = 0; j < n; j ++) {
+            if (start[j] == '\t') s += "    ";
+            else s += start[j];
+        }
+        return new ustring(s);
+    }
+
+    Source::Source() {
+        line_starts.push(0);
+    }
+
+    Source::Source(const ustring& filename): Source() {
+        filepath = some<ustring>(filename);
+        if (!exists((const char*)filename.raw())) {
             err({}, "Could not open file '", filename, "'.");
             return;
         }
+        file f((const char*)filename.raw(), "r");
 
-        string s; // we're using this as a byte buffer
-        while (f.peek()) {
-            s += f.peek();
-            if (f.read() == '\n')
-                lines.push(process_line(s)), s = ""; // convert to ustring, clear buffer 
-        }
-        if (s.size() > 0) lines.push(process_line(s));
-        if (lines.size() > 0 && lines.back()->back() != '\n') *lines.back() += '\n';
+        // read the whole file in large chunks directly into the text buffer
+        const u32 CHUNK_SIZE = 65536;
+        u64 n;
+        do {
+            reserve_text(CHUNK_SIZE);
+            n = f.read(text + text_size, text_capacity - text_size);
+            text_size += n;
+        } while (n > 0);
+        finish_text();
     }
 
-    Source::Source(stream& io) {
+    Source::Source(stream& io): Source() {
         string s; // we're using this as a byte buffer
-        while (io.peek()) {
-            s += io.peek();
-            if (io.read() == '\n')
-                lines.push(process_line(s)), s = ""; // convert to ustring, clear buffer 
-        }
-        if (s.size() > 0) lines.push(process_line(s));
-        if (lines.size() > 0 && lines.back()->back() != '\n') *lines.back() += '\n';
+        while (io.peek()) s += io.read();
+        append_text(s.raw(), s.size());
+        finish_text();
     }
 
     Source::~Source() {
-        for (ustring* line : lines) delete line;
+        for (ustring* line : lines) if (line) delete line;
+        if (text) delete[] text;
     }
 
-    Source::Source(const Source& other) {
-        for (ustring* line : other.lines) lines.push(new ustring(*line));
+    Source::Source(const Source& other): Source() {
+        filepath = other.filepath;
+        append_text(other.text, other.text_size);
+        index_lines(0);
     }
 
     Source& Source::operator=(const Source& other) {
         if (this != &other) {
-            for (ustring* line : lines) delete line;
+            for (ustring* line : lines) if (line) delete line;
             lines.clear();
-            for (ustring* line : other.lines) lines.push(new ustring(*line));
+            line_starts.clear();
+            line_starts.push(0);
+            text_size = 0;
+            filepath = other.filepath;
+            append_text(other.text, other.text_size);
+            index_lines(0);
         }
         return *this;
     }
@@ -101,6 +150,8 @@ namespace basil {
 
     rune Source::View::peek() const {
         if (line == src->lines.size()) return 0;
+        u8 b = *(const u8*)iter._ptr;
+        if (b < 128) return b; // no need to decode ASCII
         return *iter;
     }
     
@@ -114,7 +165,8 @@ namespace basil {
         rune r = peek();
         if (!r) return r;
         column ++;
-        iter ++;
+        if (r < 128) iter._ptr ++;
+        else iter ++;
         if (iter == (*src)[line].end()) {
             column = 0, line ++;
             if (line < src->size()) iter = (*src)[line].begin();
@@ -122,7 +174,18 @@ namespace basil {
         return r;
     }
 
+    const u8* Source::View::raw() const {
+        if (line == src->lines.size()) return (const u8*)"";
+        return (const u8*)iter._ptr;
+    }
+
+    void Source::View::skip_ascii(u32 n) {
+        column += n;
+        iter._ptr += n;
+    }
+
     const ustring& Source::operator[](u32 i) const {
+        if (!lines[i]) lines[i] = decode_line(i);
         return *lines[i];
     }
 
@@ -153,7 +216,7 @@ namespace basil {
     }
 
     Source::Pos Source::line_span(u32 i) const {
-        return { i, 0, i, lines[i]->size() };
+        return { i, 0, i, (*this)[i].size() };
     }
 
     Source::Pos Source::full_span() const {
@@ -166,7 +229,9 @@ namespace basil {
         while (io.peek()) {
             s += io.peek();
             if (io.read() == '\n') {
-                lines.push(process_line(s)); // convert to ustring and push 
+                u32 start = text_size;
+                append_text(s.raw(), s.size());
+                index_lines(start); // adds exactly one line, since s ends in its only newline
                 break; // stop after reading one line
             }
         }
@@ -21,7 +21,27 @@ namespace basil {
     // revisiting source information without passing it around everywhere as strings.
     class Source {
         optional<ustring> filepath = none<ustring>();
-        vector<ustring*> lines;
+        u8* text = nullptr; // the raw bytes of the whole source, always ending in a newline
+        u32 text_size = 0, text_capacity = 0;
+        vector<u32> line_starts; // byte offset of each line within text, plus one past the last
+        mutable vector<ustring*> lines; // decoded lines, null until first accessed
+
+        // Makes sure the text buffer has room for at least n more bytes.
+        void reserve_text(u32 n);
+
+        // Appends n bytes to the end of the text buffer.
+        void append_text(const u8* bytes, u32 n);
+
+        // Finds every line break in the text past the provided byte offset, and adds
+        // an (as of yet undecoded) line for each.
+        void index_lines(u32 from);
+
+        // Truncates the text at the first null byte, if any, adds a trailing newline
+        // if it's missing, and indexes all of its lines.
+        void finish_text();
+
+        // Decodes line i from the text buffer, expanding tabs to four spaces.
+        ustring* decode_line(u32 i) const;
 
         // Checks that the Source file is within the size limitations enforced by the
         // Basil language. No source can be more than a million lines long, and no
@@ -90,6 +110,14 @@ namespace basil {
             // If advancing would move the iterator off the end of the current line, this View
             // will move to the next line.
             rune read();
+
+            // Returns the encoded bytes of the rest of the current line, starting at this View.
+            // The bytes are null-terminated. Returns an empty string past the end of the Source.
+            const u8* raw() const;
+
+            // Advances past n single-byte characters, all of which must be on the current line
+            // and none of which may be its trailing newline.
+            void skip_ascii(u32 n);
         };
 
         // Returns the line at index i of this Source object.
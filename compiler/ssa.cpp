@@ -341,11 +341,10 @@ namespace basil {
     IRInsn::~IRInsn() {}
 
     bool IRInsn::liveout() {
-        bool result = false;
         bitset new_in = out;
         for (const IRParam& p : src) if (p.kind == IK_VAR) new_in.insert(p.data.var);
         if (dest && dest->kind == IK_VAR) new_in.erase(dest->data.var);
-        for (u32 i : new_in) result = in.insert(i) || result;
+        bool result = in |= new_in;
         // print("\tinstruction ");
         // format(_stdout);
         // show_liveness(_stdout);
@@ -697,10 +696,276 @@ namespace basil {
         return ref<IRIf>(cond, ifTrue, ifFalse);
     }
 
+    // Switches with at least this many cases, spanning at most two and a half times as
+    // many values, are dispatched with a jump table. Sparser ones are split in half until
+    // they're either dense enough or short enough to compare against each case in turn.
+    #define MIN_TABLE_CASES 4
+    #define MAX_COMPARE_CASES 3
+
+    struct IRSwitch : public IRInsn {
+        vector<i64> values; // sorted, and parallel to the case blocks starting at src[2]
+
+        IRSwitch(Type type, const IRParam& value, const vector<i64>& values_in, 
+            const vector<rc<IRBlock>>& targets, rc<IRBlock> otherwise):
+            IRInsn(IR_SWITCH, type, none<IRParam>()), values(values_in) {
+            src.push(value);
+            src.push(ir_block(otherwise->id));
+            for (const rc<IRBlock>& target : targets) src.push(ir_block(target->id));
+        }
+
+        void format(stream& io) const override {
+            write(io, "switch ", src[0], " [");
+            for (u32 i = 0; i < values.size(); i ++) write(io, i ? ", " : "", values[i], " => ", src[i + 2]);
+            write(io, "] else ", src[1]);
+        }
+
+        jasmine::Symbol target(IRFunction& func, u32 i) const {
+            return func.get_block(src[i + 2].data.block)->label();
+        }
+
+        // Emits the dispatch for cases 'first' up to but not including 'last'.
+        void emit_cases(IRFunction& func, Context& ctx, u32 first, u32 last) const {
+            jasmine::Type repr = type.repr(ctx);
+            jasmine::Param value = src[0].emit(func, ctx);
+            jasmine::Symbol otherwise = func.get_block(src[1].data.block)->label();
+            u32 n = last - first;
+            u64 range = u64(values[last - 1] - values[first]) + 1;
+            if (n >= MIN_TABLE_CASES && range * 2 <= n * 5) {
+                vector<jasmine::Symbol> table;
+                for (u64 i = 0; i < range; i ++) table.push(otherwise);
+                for (u32 i = first; i < last; i ++) table[values[i] - values[first]] = target(func, i);
+                jasmine::bc::switch_(repr, otherwise, value, values[first], table);
+            }
+            else if (n <= MAX_COMPARE_CASES) {
+                for (u32 i = first; i < last; i ++) 
+                    jasmine::bc::jeq(repr, target(func, i), value, jasmine::bc::imm(values[i]));
+                jasmine::bc::jump(otherwise);
+            }
+            else {
+                static u32 split_idx = 0;
+                ustring name = ::format<ustring>(".SW", split_idx ++);
+                jasmine::Symbol lower = jasmine::local(name.raw());
+                u32 mid = first + n / 2;
+                jasmine::bc::jl(repr, lower, value, jasmine::bc::imm(values[mid]));
+                emit_cases(func, ctx, mid, last);
+                jasmine::bc::label(lower, jasmine::OS_CODE);
+                emit_cases(func, ctx, first, mid);
+            }
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            emit_cases(func, ctx, 0, values.size());
+        }
+    };
+
     // rc<IRInsn> ir_head(rc<IRFunction> func, Type list_type, const IRParam& list);
     // rc<IRInsn> ir_tail(rc<IRFunction> func, Type list_type, const IRParam& list);
     // rc<IRInsn> ir_cons(rc<IRFunction> func, Type list_type, const IRParam& head, const IRParam& tail);
 
+    // Runtime arrays are a pointer to an i64 length, followed immediately by the elements,
+    // each stored at the size of its Jasmine representation.
+
+    static jasmine::Param element_at(IRFunction& func, Context& ctx, jasmine::Type repr, 
+        const IRParam& array, const IRParam& index) {
+        u64 size = repr.size(jasmine::DEFAULT_TARGET, ctx);
+        if (size != 1 && size != 2 && size != 4 && size != 8)
+            panic("Unsupported array element size ", size, "!");
+        u64 base = array.emit(func, ctx).data.reg.id;
+        if (index.kind == IK_INT) return jasmine::bc::m(base, 8 + index.data.i * i64(size));
+        return jasmine::bc::m(base, index.emit(func, ctx).data.reg.id, size, 8);
+    }
+
+    // Emits a check that 'index' is within the bounds of 'array', calling into the runtime
+    // to report the error and exit if it isn't. 'scratch' receives the result of that call.
+    static void check_index(IRFunction& func, Context& ctx, const jasmine::Param& scratch,
+        const IRParam& array, const IRParam& index) {
+        static u32 check_idx = 0;
+        ustring ok_name = ::format<ustring>(".IX", check_idx ++), bad_name = ::format<ustring>(".IX", check_idx ++);
+        jasmine::Symbol ok = jasmine::local(ok_name.raw()), bad = jasmine::local(bad_name.raw());
+        jasmine::Param length = jasmine::bc::m(array.emit(func, ctx).data.reg.id, 0);
+        jasmine::Param i = index.emit(func, ctx);
+        if (index.kind == IK_INT) { // constant indices only need comparing against the length
+            if (index.data.i >= 0) jasmine::bc::jg(jasmine::I64, ok, length, i);
+        }
+        else {
+            jasmine::bc::jl(jasmine::I64, bad, i, jasmine::bc::imm(0));
+            jasmine::bc::jl(jasmine::I64, ok, i, length);
+            jasmine::bc::label(bad, jasmine::OS_CODE);
+        }
+        jasmine::bc::begincall(jasmine::I64, scratch, jasmine::bc::l(jasmine::global("badindex_ii")));
+        jasmine::bc::arg(jasmine::I64, i);
+        jasmine::bc::arg(jasmine::I64, length);
+        jasmine::bc::endcall();
+        jasmine::bc::label(ok, jasmine::OS_CODE);
+    }
+
+    struct IRNewArray : public IRUnary {
+        IRNewArray(rc<IRFunction> func, Type array_type, const IRParam& length):
+            IRUnary(func, IR_NEW_ARRAY, array_type, length) {}
+
+        void format(stream& io) const override {
+            write(io, *dest, " = new ", type, "[", operand(), "]");
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::Type elt = t_array_element(type).repr(ctx);
+            jasmine::bc::begincall(type.repr(ctx), dest->emit(func, ctx), 
+                jasmine::bc::l(jasmine::global("array_ii")));
+            jasmine::bc::arg(jasmine::I64, operand().emit(func, ctx));
+            jasmine::bc::arg(jasmine::I64, jasmine::bc::imm(elt.size(jasmine::DEFAULT_TARGET, ctx)));
+            jasmine::bc::endcall();
+        }
+    };
+
+    rc<IRInsn> ir_new_array(rc<IRFunction> func, Type array_type, const IRParam& length) {
+        return ref<IRNewArray>(func, array_type, length);
+    }
+
+    struct IRLoadIndex : public IRBinary {
+        IRLoadIndex(rc<IRFunction> func, Type element_type, const IRParam& array, const IRParam& index):
+            IRBinary(func, IR_LOAD_INDEX, element_type, array, index) {}
+
+        void format(stream& io) const override {
+            write(io, *dest, " = ", left(), "[", right(), "]");
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::Type repr = type.repr(ctx);
+            check_index(func, ctx, dest->emit(func, ctx), left(), right());
+            jasmine::bc::mov(repr, dest->emit(func, ctx), element_at(func, ctx, repr, left(), right()));
+        }
+    };
+
+    rc<IRInsn> ir_load_index(rc<IRFunction> func, Type element_type, const IRParam& array, const IRParam& index) {
+        return ref<IRLoadIndex>(func, element_type, array, index);
+    }
+
+    struct IRStoreIndex : public IRInsn {
+        IRStoreIndex(rc<IRFunction> func, Type element_type, const IRParam& array, const IRParam& index, 
+            const IRParam& value):
+            IRInsn(IR_STORE_INDEX, element_type, some<IRParam>(ir_temp(func))) { // dest receives the bounds check's call
+            src.push(array);
+            src.push(index);
+            src.push(value);
+        }
+
+        void format(stream& io) const override {
+            write(io, src[0], "[", src[1], "] = ", src[2]);
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::Type repr = type.repr(ctx);
+            check_index(func, ctx, dest->emit(func, ctx), src[0], src[1]);
+            jasmine::bc::mov(repr, element_at(func, ctx, repr, src[0], src[1]), src[2].emit(func, ctx));
+        }
+    };
+
+    rc<IRInsn> ir_store_index(rc<IRFunction> func, Type element_type, const IRParam& array, 
+        const IRParam& index, const IRParam& value) {
+        return ref<IRStoreIndex>(func, element_type, array, index, value);
+    }
+
+    struct IRArrayLength : public IRUnary {
+        IRArrayLength(rc<IRFunction> func, const IRParam& array):
+            IRUnary(func, IR_ARRAY_LENGTH, T_INT, array) {}
+
+        void format(stream& io) const override {
+            write(io, *dest, " = length ", operand());
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::bc::mov(jasmine::I64, dest->emit(func, ctx), 
+                jasmine::bc::m(operand().emit(func, ctx).data.reg.id, 0));
+        }
+    };
+
+    rc<IRInsn> ir_array_length(rc<IRFunction> func, const IRParam& array) {
+        return ref<IRArrayLength>(func, array);
+    }
+
+    // Runtime dictionaries are built and searched by the runtime, which hands back a
+    // pointer to the slot holding a key's value. Like arrays, they keep their length in
+    // their first word. String keys are hashed by contents and other keys by value, so
+    // each has its own entry points.
+
+    // Emits a call to the entry point for the slot of 'key' in 'dict', leaving a pointer to
+    // it in 'dest'. 'word_fn' and 'string_fn' name the entry points for each kind of key.
+    static void dict_slot(IRFunction& func, Context& ctx, Type dict_type, const char* word_fn, 
+        const char* string_fn, const jasmine::Param& dest, const IRParam& dict, const IRParam& key) {
+        const char* name = t_dict_key(dict_type) == T_STRING ? string_fn : word_fn;
+        jasmine::bc::begincall(jasmine::I64, dest, jasmine::bc::l(jasmine::global(name)));
+        jasmine::bc::arg(jasmine::I64, dict.emit(func, ctx));
+        jasmine::bc::arg(jasmine::I64, key.emit(func, ctx));
+        jasmine::bc::endcall();
+    }
+
+    struct IRNewDict : public IRUnary {
+        IRNewDict(rc<IRFunction> func, Type dict_type, const IRParam& capacity):
+            IRUnary(func, IR_NEW_DICT, dict_type, capacity) {}
+
+        void format(stream& io) const override {
+            write(io, *dest, " = new ", type, "(", operand(), ")");
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::bc::begincall(type.repr(ctx), dest->emit(func, ctx), 
+                jasmine::bc::l(jasmine::global("dict_i")));
+            jasmine::bc::arg(jasmine::I64, operand().emit(func, ctx));
+            jasmine::bc::endcall();
+        }
+    };
+
+    rc<IRInsn> ir_new_dict(rc<IRFunction> func, Type dict_type, const IRParam& capacity) {
+        return ref<IRNewDict>(func, dict_type, capacity);
+    }
+
+    struct IRDictAt : public IRBinary {
+        Type dict_type;
+
+        IRDictAt(rc<IRFunction> func, Type dict_type_in, const IRParam& dict, const IRParam& key):
+            IRBinary(func, IR_DICT_AT, t_dict_value(dict_type_in), dict, key), dict_type(dict_type_in) {}
+
+        void format(stream& io) const override {
+            write(io, *dest, " = ", left(), "{", right(), "}");
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::Param slot = dest->emit(func, ctx);
+            dict_slot(func, ctx, dict_type, "dictat_ii", "dictat_is", slot, left(), right());
+            jasmine::bc::mov(type.repr(ctx), slot, jasmine::bc::m(slot.data.reg.id, 0));
+        }
+    };
+
+    rc<IRInsn> ir_dict_at(rc<IRFunction> func, Type dict_type, const IRParam& dict, const IRParam& key) {
+        return ref<IRDictAt>(func, dict_type, dict, key);
+    }
+
+    struct IRDictPut : public IRInsn {
+        IRDictPut(rc<IRFunction> func, Type dict_type, const IRParam& dict, const IRParam& key, 
+            const IRParam& value):
+            IRInsn(IR_DICT_PUT, dict_type, some<IRParam>(ir_temp(func))) { // dest holds the slot
+            src.push(dict);
+            src.push(key);
+            src.push(value);
+        }
+
+        void format(stream& io) const override {
+            write(io, src[0], "{", src[1], "} = ", src[2]);
+        }
+
+        void emit(IRFunction& func, Context& ctx) const override {
+            jasmine::Param slot = dest->emit(func, ctx);
+            dict_slot(func, ctx, type, "dictinsert_ii", "dictinsert_is", slot, src[0], src[1]);
+            jasmine::bc::mov(t_dict_value(type).repr(ctx), jasmine::bc::m(slot.data.reg.id, 0), 
+                src[2].emit(func, ctx));
+        }
+    };
+
+    rc<IRInsn> ir_dict_put(rc<IRFunction> func, Type dict_type, const IRParam& dict, const IRParam& key, 
+        const IRParam& value) {
+        return ref<IRDictPut>(func, dict_type, dict, key, value);
+    }
+
     struct IRCall : public IRInsn {
         IRCall(rc<IRFunction> func, Type func_type, const IRParam& proc, const vector<IRParam>& args):
             IRInsn(IR_CALL, func_type, some<IRParam>(ir_temp(func))) {
@@ -823,6 +1088,7 @@ namespace basil {
         gvn_ssa,
         constant_folding_ssa,
         optimize_arithmetic_ssa,
+        form_switches,
         linearize_cfg,
         phi_elim,
         cleanup_nops
@@ -959,8 +1225,7 @@ namespace basil {
                 for (const rc<IRBlock>& bb : func->blocks[i]->in) {
                     // print(" ", bb->id);
                     if (first) tmp = bb->dom, first = false;
-                    else for (u32 i : tmp) 
-                        if (!bb->dom.contains(i)) tmp.erase(i); // safe to erase mid-iteration for bitset
+                    else tmp &= bb->dom;
                 }
                 tmp.insert(i);
                 // println("");
@@ -969,11 +1234,8 @@ namespace basil {
                 // print("DOM(", i, ") = ");
                 // write_seq(_stdout, func->blocks[i]->dom, "", ", ", "\n");
 
-                bool diff = false;
-                for (u32 i : tmp) if (!func->blocks[i]->dom.contains(i)) diff = true;
-                for (u32 i : func->blocks[i]->dom) if (!tmp.contains(i)) diff = true;
                 // if tmp(i) != DOM(i), replace DOM with tmp
-                if (diff) {
+                if (tmp != func->blocks[i]->dom) {
                     func->blocks[i]->dom = tmp;
                     working = true;
                 }
@@ -1012,10 +1274,8 @@ namespace basil {
         bool working = false;
         for (i64 i = i64(block->insns.size()) - 1; i >= 0; i --) {
             rc<IRInsn>& insn = block->insns[i];
-            if (i < i64(block->insns.size()) - 1) {
-                for (u32 i : block->insns[i + 1]->in)
-                    working = insn->out.insert(i) || working;
-            }
+            if (i < i64(block->insns.size()) - 1)
+                working = (insn->out |= block->insns[i + 1]->in) || working;
             working = insn->liveout() || working;
         }
         // println("block ", block->id, " is ", working ? "not " : "", "done working");
@@ -1032,10 +1292,8 @@ namespace basil {
             for (i64 i = i64(func->blocks.size()) - 1; i >= 0; i --) {
                 working = liveness_block(func->blocks[i]) || working; // compute liveness for this basic block
 
-                for (auto& pred : func->blocks[i]->in) {
-                    for (u32 j : func->blocks[i]->insns.front()->in) // unify our new in with each predecessor's out
-                        working = pred->insns.back()->out.insert(j) || working;
-                }
+                for (auto& pred : func->blocks[i]->in) // unify our new in with each predecessor's out
+                    working = (pred->insns.back()->out |= func->blocks[i]->insns.front()->in) || working;
             }
         }
     }
@@ -1064,6 +1322,102 @@ namespace basil {
         panic("Unimplemented!");
     }
 
+    #define MIN_SWITCH_CASES 4
+
+    // Finds the variable and constant that 'block' compares for equality before branching
+    // on the result, if its branch is the only use of the comparison.
+    static bool case_test(const rc<IRBlock>& block, const map<u32, u32>& uses, IRParam& var, i64& value) {
+        if (block->insns.size() < 2) return false;
+        const rc<IRInsn>& test = block->insns[block->insns.size() - 2];
+        const rc<IRInsn>& branch = block->insns.back();
+        if (test->op != IR_EQ || branch->op != IR_IF) return false;
+        if (branch->src[0].kind != IK_VAR || branch->src[0].data.var != test->dest->data.var) return false;
+        auto it = uses.find(test->dest->data.var);
+        if (it == uses.end() || it->second != 1) return false;
+        if (test->type != T_INT && test->type != T_CHAR && test->type != T_SYMBOL) return false;
+
+        u32 var_side = test->src[0].kind == IK_VAR ? 0 : 1;
+        const IRParam& constant = test->src[1 - var_side];
+        if (test->src[var_side].kind != IK_VAR) return false;
+        switch (constant.kind) {
+            case IK_INT: value = constant.data.i; break;
+            case IK_CHAR: value = constant.data.ch.u; break;
+            case IK_SYMBOL: value = constant.data.sym.id; break;
+            default: return false;
+        }
+        var = test->src[var_side];
+        return value >= -0x80000000l && value <= 0x7fffffffl; // must fit in an immediate
+    }
+
+    static void replace_entry(rc<IRBlock> block, rc<IRBlock> old_pred, rc<IRBlock> new_pred) {
+        for (rc<IRBlock>& pred : block->in) if (pred.is(old_pred)) pred = new_pred;
+    }
+
+    void form_switches(rc<IRFunction> func) {
+        map<u32, u32> uses;
+        for (const rc<IRBlock>& block : func->blocks) for (const rc<IRInsn>& insn : block->insns)
+            for (const IRParam& p : insn->src) if (p.kind == IK_VAR) uses[p.data.var] ++;
+
+        bitset consumed;
+        for (rc<IRBlock> head : func->blocks) {
+            IRParam var(IK_VAR);
+            i64 value;
+            if (consumed.contains(head->id) || !case_test(head, uses, var, value)) continue;
+            Type type = head->insns[head->insns.size() - 2]->type;
+
+            // follow the false branches for as long as they only test the same variable
+            vector<rc<IRBlock>> chain;
+            vector<i64> values;
+            rc<IRBlock> block = head;
+            while (true) {
+                chain.push(block);
+                values.push(value);
+                rc<IRBlock> next = func->get_block(block->insns.back()->src[2].data.block);
+                IRParam next_var(IK_VAR);
+                if (next->insns.size() != 2 || next->in.size() != 1 || !case_test(next, uses, next_var, value)
+                    || next_var.data.var != var.data.var || next->insns[0]->type != type) break;
+                bool repeated = false;
+                for (i64 v : values) repeated = repeated || v == value;
+                if (repeated) break;
+                block = next;
+            }
+            if (chain.size() < MIN_SWITCH_CASES) continue;
+
+            // every case, and the fallback, needs its own block outside the chain
+            vector<rc<IRBlock>> targets;
+            for (const rc<IRBlock>& b : chain) targets.push(func->get_block(b->insns.back()->src[1].data.block));
+            rc<IRBlock> rest = func->get_block(chain.back()->insns.back()->src[2].data.block);
+            bitset seen;
+            for (const rc<IRBlock>& b : chain) seen.insert(b->id);
+            bool distinct = true;
+            for (const rc<IRBlock>& target : targets) {
+                if (seen.contains(target->id)) distinct = false;
+                seen.insert(target->id);
+            }
+            if (!distinct || seen.contains(rest->id)) continue;
+
+            for (u32 i = 0; i < chain.size(); i ++) replace_entry(targets[i], chain[i], head);
+            replace_entry(rest, chain.back(), head);
+            head->out = targets;
+            head->out.push(rest);
+            for (u32 i = 1; i < chain.size(); i ++) {
+                consumed.insert(chain[i]->id);
+                chain[i]->insns.clear(), chain[i]->in.clear(), chain[i]->out.clear();
+            }
+
+            for (u32 i = 1; i < values.size(); i ++) // sort the cases by value
+                for (u32 j = i; j > 0 && values[j - 1] > values[j]; j --) {
+                    i64 v = values[j];
+                    values[j] = values[j - 1], values[j - 1] = v;
+                    rc<IRBlock> b = targets[j];
+                    targets[j] = targets[j - 1], targets[j - 1] = b;
+                }
+            head->insns.pop();
+            head->insns.pop();
+            head->insns.push(ref<IRSwitch>(type, var, values, targets, rest));
+        }
+    }
+
     void linearize_postorder(vector<rc<IRBlock>>& ordering, bitset& visited, const rc<IRBlock>& block) {
         visited.insert(block->id);
         for (i64 i = i64(block->out.size()) - 1; i >= 0; i --) if (!visited.contains(block->out[i]->id))
@@ -1138,6 +1492,9 @@ namespace basil {
     }
     
     void optimize(rc<IRFunction> func, OptLevel level) {
+        // simplify the control flow graph before analyzing it
+        require(func, FORM_SWITCHES);
+
         // compute some common properties
         require(func, DOMINANCE_FRONTIER);
         require(func, LIVENESS);
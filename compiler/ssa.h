@@ -43,9 +43,11 @@ namespace basil {
         IR_ADD, IR_SUB, IR_MUL, IR_DIV, IR_REM,
         IR_AND, IR_XOR, IR_OR, IR_NOT,
         IR_LT, IR_LE, IR_GT, IR_GE, IR_EQ, IR_NE,
-        IR_GOTO, IR_IF, IR_IFGOTO,
+        IR_GOTO, IR_IF, IR_IFGOTO, IR_SWITCH,
         IR_CALL, IR_ARG, IR_RETURN,
         IR_HEAD, IR_TAIL, IR_CONS,
+        IR_NEW_ARRAY, IR_LOAD_INDEX, IR_STORE_INDEX, IR_ARRAY_LENGTH,
+        IR_NEW_DICT, IR_DICT_AT, IR_DICT_PUT,
         IR_ASSIGN,
         IR_PHI
     };
@@ -260,6 +262,15 @@ namespace basil {
     rc<IRInsn> ir_head(rc<IRFunction> func, Type list_type, const IRParam& list);
     rc<IRInsn> ir_tail(rc<IRFunction> func, Type list_type, const IRParam& list);
     rc<IRInsn> ir_cons(rc<IRFunction> func, Type list_type, const IRParam& head, const IRParam& tail);
+    rc<IRInsn> ir_new_array(rc<IRFunction> func, Type array_type, const IRParam& length);
+    rc<IRInsn> ir_load_index(rc<IRFunction> func, Type element_type, const IRParam& array, const IRParam& index);
+    rc<IRInsn> ir_store_index(rc<IRFunction> func, Type element_type, const IRParam& array, 
+        const IRParam& index, const IRParam& value);
+    rc<IRInsn> ir_array_length(rc<IRFunction> func, const IRParam& array);
+    rc<IRInsn> ir_new_dict(rc<IRFunction> func, Type dict_type, const IRParam& capacity);
+    rc<IRInsn> ir_dict_at(rc<IRFunction> func, Type dict_type, const IRParam& dict, const IRParam& key);
+    rc<IRInsn> ir_dict_put(rc<IRFunction> func, Type dict_type, const IRParam& dict, const IRParam& key, 
+        const IRParam& value);
     rc<IRInsn> ir_call(rc<IRFunction> func, Type func_type, const IRParam& proc, const vector<IRParam>& args);
     rc<IRInsn> ir_arg(rc<IRFunction> func, Type type, const IRParam& dest, u32 arg);
     rc<IRInsn> ir_assign(rc<IRFunction> func, Type type, const IRParam& dest, const IRParam& src);
@@ -285,6 +296,7 @@ namespace basil {
         GLOBAL_VALUE_NUMBERING,
         CONSTANT_FOLDING,
         OPTIMIZE_ARITHMETIC,
+        FORM_SWITCHES,
         LINEARIZE_CFG,
         PHI_ELIMINATION,
         CLEANUP_NOPS,
@@ -346,6 +358,10 @@ namespace basil {
     // a lower-level code generation pass.
     void optimize_arithmetic_ssa(rc<IRFunction> func);
 
+    // Replaces chains of blocks that each compare the same integer, character, or symbol
+    // variable against a different constant with a single multiway branch.
+    void form_switches(rc<IRFunction> func);
+
     // Computes a linear scheduling of basic blocks within the function.
     void linearize_cfg(rc<IRFunction> func);
 
@@ -52,31 +52,98 @@ namespace basil {
         return true;
     }
 
+    // Lexical classes of ASCII characters. C_SYMBOL marks characters that can continue
+    // a symbol, except for ':', which needs extra context.
+    enum CharClass : u8 {
+        C_SPACE = 1, C_SEPARATOR = 2, C_OPENER = 4, C_DIGIT = 8, 
+        C_LETTER = 16, C_SIGIL = 32, C_SYMBOL = 64
+    };
+
+    enum : u8 { // shorthands for the table below
+        NON = 0,
+        SPC = C_SPACE | C_SEPARATOR,
+        SEP = C_SEPARATOR,
+        OPN = C_SEPARATOR | C_OPENER,
+        QOT = C_SEPARATOR | C_OPENER | C_SIGIL,
+        PUN = C_SEPARATOR | C_SIGIL,
+        COL = C_SIGIL,
+        SIG = C_SIGIL | C_SYMBOL,
+        DIG = C_DIGIT | C_SYMBOL,
+        LET = C_LETTER | C_SYMBOL
+    };
+
+    // Lexical classes for every byte. These agree with the utf8_is_* predicates below
+    // for ASCII characters. Bytes past 7f are part of multi-byte runes, so they have no
+    // class, and we fall back to the predicates for them.
+    const u8 CHAR_CLASSES[256] = {
+        SEP, NON, NON, NON, NON, NON, NON, NON, // 00 - 07
+        NON, SPC, SPC, SPC, NON, NON, NON, NON, // 08 - 0f
+        NON, NON, NON, NON, NON, NON, NON, NON, // 10 - 17
+        NON, NON, NON, NON, NON, NON, NON, NON, // 18 - 1f
+        SPC, SIG, QOT, SIG, SIG, SIG, SIG, QOT, // 20 - 27
+        OPN, SEP, SIG, SIG, PUN, SIG, PUN, SIG, // 28 - 2f
+        DIG, DIG, DIG, DIG, DIG, DIG, DIG, DIG, // 30 - 37
+        DIG, DIG, COL, PUN, SIG, SIG, SIG, PUN, // 38 - 3f
+        SIG, LET, LET, LET, LET, LET, LET, LET, // 40 - 47
+        LET, LET, LET, LET, LET, LET, LET, LET, // 48 - 4f
+        LET, LET, LET, LET, LET, LET, LET, LET, // 50 - 57
+        LET, LET, LET, OPN, QOT, SEP, SIG, SIG, // 58 - 5f
+        SIG, LET, LET, LET, LET, LET, LET, LET, // 60 - 67
+        LET, LET, LET, LET, LET, LET, LET, LET, // 68 - 6f
+        LET, LET, LET, LET, LET, LET, LET, LET, // 70 - 77
+        LET, LET, LET, OPN, SIG, SEP, SIG, NON, // 78 - 7f
+    };
+
     bool is_space(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_SPACE;
         return utf8_is_separator(r) || r == '\t' || r == '\n' || r == ' ' || r == '\v';
     }
 
     bool is_separator(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_SEPARATOR;
         return is_space(r) || utf8_is_punctuation_open(r) || utf8_is_punctuation_close(r) || utf8_is_initial_quote(r) || utf8_is_final_quote(r)
             || r == '"' || r == '\'' || r == ',' || r == '.' || r == ';' || r == '\\' || r == '\0' || r == '?';
     }
 
     bool is_opener(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_OPENER;
         return utf8_is_punctuation_open(r) || utf8_is_initial_quote(r) || r == '"' || r == '\'' || r == '\\';
     }
 
     bool is_digit(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_DIGIT;
         return utf8_is_digit(r); // Nd character class
     }
 
     bool is_letter(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_LETTER;
         return utf8_is_mark(r) || utf8_is_letter(r);
     }
 
     bool is_sigil(rune r) {
+        if (r < 128) return CHAR_CLASSES[r] & C_SIGIL;
         return utf8_is_connector(r) || utf8_is_dash(r) || utf8_is_other_punctuation(r) || utf8_is_symbol(r);
     }
 
+    // Moves the view past the longest run of ASCII characters in any of the provided
+    // classes, without decoding them one at a time. If any are consumed, end is updated
+    // to the position of the last one.
+    void skip_run(Source::View& view, u8 classes, Source::Pos& end) {
+        const u8* bytes = view.raw();
+        u32 n = 0;
+        while (CHAR_CLASSES[bytes[n]] & classes) n ++;
+        if (n) {
+            end = Source::Pos{view.line, view.column + n - 1, view.line, view.column + n};
+            view.skip_ascii(n);
+        }
+    }
+
+    // Interns the text between start and the current position of the view as a symbol.
+    // Tokens built this way never span multiple lines, so this is always one contiguous run.
+    Symbol symbol_since(const Source::View& view, const u8* start) {
+        return symbol_from(const_slice<u8>(view.raw() - start, start));
+    }
+
     TokenKind SINGLETON_KINDS[128] = {
         TK_NONE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, // 00 - 07
         TK_NONE, TK_NONE, TK_NEWLINE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, TK_NONE, // 08 - 0f
@@ -221,31 +288,34 @@ namespace basil {
             result = Token{span(begin, end), symbol_from(acc), TK_STRING};
         }
         else if (is_digit(ch)) {
-            ustring acc;
+            const u8* start = view.raw();
             bool floating = false;
-            while (is_digit(ch)) end = view.pos(), acc += view.read(), ch = view.peek();
+            skip_run(view, C_DIGIT, end), ch = view.peek();
+            while (is_digit(ch)) end = view.pos(), view.read(), ch = view.peek();
             if (ch == '.') {
                 floating = true;
-                end = view.pos(), acc += view.read(), ch = view.peek(); // consume dot
+                end = view.pos(), view.read(), ch = view.peek(); // consume dot
                 if (!is_digit(ch)) {
                     err(view.pos(), "Expected at least one digit after decimal point.");
                     return none<Token>();
                 }
-                while (is_digit(ch)) end = view.pos(), acc += view.read(), ch = view.peek();
+                skip_run(view, C_DIGIT, end), ch = view.peek();
+                while (is_digit(ch)) end = view.pos(), view.read(), ch = view.peek();
             }
+            Symbol digits = symbol_since(view, start);
             // whether it's an integer or float constant, we should be done reading the numeric portion
             if ((is_opener(ch) && ch != '\\') || is_letter(ch))
-                result = Token{span(begin, end), symbol_from(acc), floating ? TK_FLOATCOEFF : TK_INTCOEFF};
+                result = Token{span(begin, end), digits, floating ? TK_FLOATCOEFF : TK_INTCOEFF};
             else if (is_separator(ch) 
                 || (ch == ':' && is_block_colon(view))) // block colons are special, since : is not a separator but it can terminate numbers
-                result = Token{span(begin, end), symbol_from(acc), floating ? TK_FLOAT : TK_INT};
+                result = Token{span(begin, end), digits, floating ? TK_FLOAT : TK_INT};
             else {
                 err(view.pos(), "Unexpected character in numeric literal: '", ch, "'.");
                 return none<Token>();
             }
         }
         else if (is_letter(ch) || is_sigil(ch)) {
-            ustring acc;
+            const u8* start = view.raw();
             bool skip_symbol = false;
             switch (ch) {
                 case '_':
@@ -253,12 +323,12 @@ namespace basil {
                     view.read();
                     return none<Token>();
                 case '+': // prefix plus
-                    end = view.pos(), acc += view.read(), ch = view.peek();
+                    end = view.pos(), view.read(), ch = view.peek();
                     if (is_letter(ch) || is_digit(ch) || is_opener(ch)) 
                         skip_symbol = true, result = Token{span(begin, end), S_PLUS, TK_PLUS};
                     break;
                 case '-': // prefix minus
-                    end = view.pos(), acc += view.read(), ch = view.peek();
+                    end = view.pos(), view.read(), ch = view.peek();
                     if (is_letter(ch) || is_digit(ch) || is_opener(ch)) 
                         skip_symbol = true, result = Token{span(begin, end), S_MINUS, TK_MINUS};
                     break;
@@ -270,7 +340,7 @@ namespace basil {
                         view.read();
                     }
                     else { // prefix quote or normal ident
-                        end = view.pos(), acc += view.read(), ch = view.peek();
+                        end = view.pos(), view.read(), ch = view.peek();
                         if (!is_space(ch) && ch != ':') 
                             skip_symbol = true, result = Token{span(begin, end), S_COLON, TK_QUOTE};
                     }
@@ -281,16 +351,18 @@ namespace basil {
                                             // they only consist of that separator
                         skip_symbol = true; // we want to skip normal symbol stuff
                         while (ch == repeated) 
-                            end = view.pos(), acc += view.read(), ch = view.peek();
-                        result = Token{span(begin, end), symbol_from(acc), TK_SYMBOL};
+                            end = view.pos(), view.read(), ch = view.peek();
+                        result = Token{span(begin, end), symbol_since(view, start), TK_SYMBOL};
                     }
             }
             if (!skip_symbol) { // do normal symbol tokenization
-                while ((is_letter(ch) || is_sigil(ch) || is_digit(ch)) && !is_separator(ch)) {
-                    if (ch == ':' && acc.back() != ':') break; // block colon ends identifiers that don't end with colon
-                    end = view.pos(), acc += view.read(), ch = view.peek();
+                while (skip_run(view, C_SYMBOL, end), ch = view.peek(), 
+                    (is_letter(ch) || is_sigil(ch) || is_digit(ch)) && !is_separator(ch)) {
+                    if (ch == ':' && (view.raw() == start || view.raw()[-1] != ':')) 
+                        break; // block colon ends identifiers that don't end with colon
+                    end = view.pos(), view.read();
                 }
-                result = Token{span(begin, end), symbol_from(acc), TK_SYMBOL};
+                result = Token{span(begin, end), symbol_since(view, start), TK_SYMBOL};
             }
         }
 
@@ -32,24 +32,87 @@ namespace basil {
 
     Symbol::Symbol(u32 id_in): id(id_in) {}
 
-    static map<ustring, u32> SYMBOL_MAP;
-    static vector<ustring> SYMBOL_LIST;
+    // The text of every symbol is stored back-to-back in large chunks, and looked up
+    // through an open-addressed table of symbol ids, so interning never needs a
+    // temporary ustring. We only create a ustring for a symbol if one is asked for.
+    struct SymbolEntry {
+        const u8* bytes; // null-terminated
+        u32 size;
+        u64 hash;
+        ustring* str; // created on demand by string_from
+    };
+
+    static const u32 SYMBOL_CHUNK_SIZE = 65536;
+
+    static vector<SymbolEntry> SYMBOL_LIST;
+    static u32* SYMBOL_TABLE = nullptr; // symbol ids plus one, or zero for empty slots
+    static u32 SYMBOL_TABLE_CAPACITY = 0; // always a power of two
+    static u8 *symbol_chunk = nullptr, *symbol_chunk_end = nullptr;
+
+    static const u8* store_symbol_bytes(const u8* bytes, u32 size) {
+        u8* dst;
+        if (size + 1 > SYMBOL_CHUNK_SIZE / 4) dst = new u8[size + 1]; // big symbols get their own allocation
+        else {
+            if (u32(symbol_chunk_end - symbol_chunk) < size + 1) {
+                symbol_chunk = new u8[SYMBOL_CHUNK_SIZE];
+                symbol_chunk_end = symbol_chunk + SYMBOL_CHUNK_SIZE;
+            }
+            dst = symbol_chunk;
+            symbol_chunk += size + 1;
+        }
+        for (u32 i = 0; i < size; i ++) dst[i] = bytes[i];
+        dst[size] = '\0';
+        return dst;
+    }
+
+    static void insert_symbol(u32 id) {
+        u32 mask = SYMBOL_TABLE_CAPACITY - 1;
+        u32 i = SYMBOL_LIST[id].hash & mask;
+        while (SYMBOL_TABLE[i]) i = (i + 1) & mask;
+        SYMBOL_TABLE[i] = id + 1;
+    }
+
+    static void grow_symbol_table() {
+        if (SYMBOL_TABLE) delete[] SYMBOL_TABLE;
+        SYMBOL_TABLE_CAPACITY = SYMBOL_TABLE_CAPACITY ? SYMBOL_TABLE_CAPACITY * 2 : 1024;
+        SYMBOL_TABLE = new u32[SYMBOL_TABLE_CAPACITY];
+        for (u32 i = 0; i < SYMBOL_TABLE_CAPACITY; i ++) SYMBOL_TABLE[i] = 0;
+        for (u32 id = 0; id < SYMBOL_LIST.size(); id ++) insert_symbol(id);
+    }
+
+    // Returns the id of the symbol with the provided text, creating it if necessary.
+    static u32 intern(const u8* bytes, u32 size) {
+        u64 h = raw_hash(bytes, size);
+        if (SYMBOL_TABLE) {
+            u32 mask = SYMBOL_TABLE_CAPACITY - 1;
+            for (u32 i = h & mask; SYMBOL_TABLE[i]; i = (i + 1) & mask) {
+                const SymbolEntry& entry = SYMBOL_LIST[SYMBOL_TABLE[i] - 1];
+                if (entry.hash != h || entry.size != size) continue;
+                u32 j = 0;
+                while (j < size && entry.bytes[j] == bytes[j]) j ++;
+                if (j == size) return SYMBOL_TABLE[i] - 1; // Return existing symbol
+            }
+        }
+
+        u32 id = SYMBOL_LIST.size(); // Construct new symbol with next-highest id.
+        SYMBOL_LIST.push({ store_symbol_bytes(bytes, size), size, h, nullptr });
+        if (SYMBOL_LIST.size() * 2 > SYMBOL_TABLE_CAPACITY) grow_symbol_table(); // keep load under 1/2
+        else insert_symbol(id);
+        return id;
+    }
 
     const ustring& string_from(Symbol sym) {
-        return SYMBOL_LIST[sym.id];
+        SymbolEntry& entry = SYMBOL_LIST[sym.id];
+        if (!entry.str) entry.str = new ustring(const_slice<u8>(entry.size, entry.bytes));
+        return *entry.str;
     }
 
     Symbol symbol_from(const ustring& str) {
-        auto it = SYMBOL_MAP.find(str);
-        if (it != SYMBOL_MAP.end()) {
-            return Symbol(it->second); // Return existing symbol
-        }
-        else {
-            Symbol result(SYMBOL_LIST.size()); // Construct new symbol with next-highest id.
-            SYMBOL_MAP[str] = result.id;
-            SYMBOL_LIST.push(str);
-            return result;
-        }
+        return Symbol(intern((const u8*)str.raw(), str.bytes()));
+    }
+
+    Symbol symbol_from(const const_slice<u8>& bytes) {
+        return Symbol(intern(bytes.begin(), bytes.size()));
     }
 
     Symbol S_NONE,
@@ -201,6 +264,9 @@ namespace basil {
 
     static map<rc<Class>, u32> TYPE_MAP;
     static vector<rc<Class>> TYPE_LIST;
+    static vector<u8> TYPE_TVAR_STATE; // 0 if not yet known, 1 if free of tvars, 2 if it contains any
+
+    static bool memoized_coerces(Type from, Type to, bool generic);
 
     Type::Type(): id(0) {}
 
@@ -232,11 +298,11 @@ namespace basil {
     }
 
     bool Type::coerces_to(Type other) const {
-        return TYPE_LIST[id]->coerces_to(*TYPE_LIST[other.id]);
+        return memoized_coerces(*this, other, false);
     }
 
     bool Type::coerces_to_generic(Type other) const {
-        return TYPE_LIST[id]->coerces_to_generic(*TYPE_LIST[other.id]);
+        return memoized_coerces(*this, other, true);
     }
 
     void Type::write_mangled(stream& io) const {
@@ -313,6 +379,7 @@ namespace basil {
             auto result = t_from(TYPE_LIST.size());
             TYPE_MAP[newtype] = result.id;
             TYPE_LIST.push(newtype);
+            TYPE_TVAR_STATE.push(0);
             newtype->_id = result.id;
             return result;
         }
@@ -1171,6 +1238,7 @@ namespace basil {
     static set<u64> tvar_isecting;
 
     static u32 is_isect_mode = 0;
+    static u64 tvar_generation = 1; // incremented whenever any tvar binding changes
 
     void bind_tvar(u32 id, Type type);
 
@@ -1264,6 +1332,7 @@ namespace basil {
             it = tvar_bindings[as<TVarClass>(*TYPE_LIST[it.id]).id];
         }
         tvar_bindings[id] = type;
+        tvar_generation ++;
     }
     
     // Represents runtime types.
@@ -1603,6 +1672,75 @@ namespace basil {
         }
     }
     
+    // Unlike t_is_concrete, this looks at the type's own structure and not at
+    // whatever its tvars are currently bound to. Since interned types never
+    // change, the answer is permanent and we cache it per type id.
+    static bool t_tvar_free(Type t) {
+        if (TYPE_TVAR_STATE[t.id]) return TYPE_TVAR_STATE[t.id] == 1;
+        bool result = true;
+        switch (t.true_kind()) {
+            case K_TVAR: result = false; break;
+            case K_RUNTIME: result = t_tvar_free(t_runtime_base(t)); break;
+            case K_LIST: result = t_tvar_free(t_list_element(t)); break;
+            case K_ARRAY: result = t_tvar_free(t_array_element(t)); break;
+            case K_NAMED: result = t_tvar_free(t_get_base(t)); break;
+            case K_FUNCTION: result = t_tvar_free(t_arg(t)) && t_tvar_free(t_ret(t)); break;
+            case K_DICT: result = t_tvar_free(t_dict_key(t)) && t_tvar_free(t_dict_value(t)); break;
+            case K_UNION:
+                for (rc<Class> cl : as<UnionClass>(*TYPE_LIST[t.id]).members) 
+                    result = result && t_tvar_free(t_from(cl->id()));
+                break;
+            case K_INTERSECT:
+                for (rc<Class> cl : as<IntersectionClass>(*TYPE_LIST[t.id]).members) 
+                    result = result && t_tvar_free(t_from(cl->id()));
+                break;
+            case K_STRUCT:
+                for (const auto& [f, ft] : as<StructClass>(*TYPE_LIST[t.id]).fields) 
+                    result = result && t_tvar_free(t_from(ft->id()));
+                break;
+            case K_FORM_ISECT:
+                for (const auto& [f, ft] : as<FormIsectClass>(*TYPE_LIST[t.id]).members) 
+                    result = result && t_tvar_free(t_from(ft->id()));
+                break;
+            case K_TUPLE:
+                for (u32 i = 0; i < t_tuple_len(t); i ++) result = result && t_tvar_free(t_tuple_at(t, i));
+                break;
+            default: break;
+        }
+        TYPE_TVAR_STATE[t.id] = result ? 1 : 2;
+        return result;
+    }
+
+    struct CoercionMemo {
+        u64 generation; // 0 if the result holds permanently
+        bool result;
+    };
+
+    // Coercion results, keyed by the pair of type ids.
+    static map<u64, CoercionMemo> COERCE_MEMO, GENERIC_MEMO;
+
+    // Between two tvar-free types, a coercion query always has the same answer,
+    // so we remember it forever. Queries involving tvars depend on the current
+    // bindings, and may bind tvars themselves unless we're in nonbinding mode. So
+    // we only remember those in nonbinding mode, and only until the next time a
+    // tvar is bound.
+    static bool memoized_coerces(Type from, Type to, bool generic) {
+        const Class& a = *TYPE_LIST[from.id];
+        const Class& b = *TYPE_LIST[to.id];
+        bool permanent = t_tvar_free(from) && t_tvar_free(to);
+        if (!permanent && !nonbinding) return generic ? a.coerces_to_generic(b) : a.coerces_to(b);
+
+        map<u64, CoercionMemo>& memo = generic ? GENERIC_MEMO : COERCE_MEMO;
+        u64 key = u64(from.id) << 32 | to.id;
+        auto it = memo.find(key);
+        if (it != memo.end() && (it->second.generation == 0 || it->second.generation == tvar_generation))
+            return it->second.result;
+
+        bool result = generic ? a.coerces_to_generic(b) : a.coerces_to(b);
+        memo[key] = { permanent ? 0 : tvar_generation, result };
+        return result;
+    }
+
     bool t_is_concrete(Type t) {
         switch (t.is_tvar() ? K_TVAR : t.kind()) {
             case K_SYMBOL:
@@ -90,6 +90,7 @@ namespace basil {
         explicit Symbol(u32 id);
 
         friend Symbol symbol_from(const ustring& str);
+        friend Symbol symbol_from(const const_slice<u8>& bytes);
     };
 
     // DO NOT MODIFY - these aren't const so they can be initialized 
@@ -109,6 +110,9 @@ namespace basil {
     // or constructs a new symbol if not.
     Symbol symbol_from(const ustring& str);
 
+    // Like symbol_from(const ustring&), but takes the UTF-8 encoded text directly.
+    Symbol symbol_from(const const_slice<u8>& bytes);
+
     extern const u64 KIND_HASHES[NUM_KINDS];
 
     // Represents a unique type. Two equal types with the same structure
@@ -88,12 +88,12 @@ namespace basil {
 
     void destruct_list(rc<List>& rc) {
         uint8_t* it = rc._data;
-        while (it && *(u64*)it) { // while it is not null *and* still has a refcount
-            u64 count = -- *(u64*)it; // decrement refcount
+        while (it && (*(u64*)it & RC_COUNT_MASK)) { // while it is not null *and* still has a refcount
+            u64 count = -- *(u64*)it & RC_COUNT_MASK; // decrement refcount
             if (!count) { // manually deallocate
-                uint8_t* next = ((List*)(it + sizeof(u64)))->tail._data;
-                ((List*)(it + sizeof(u64)))->head.~Value();
-                delete[] it;
+                uint8_t* next = ((List*)(it + RC_HEADER_SIZE))->tail._data;
+                ((List*)(it + RC_HEADER_SIZE))->head.~Value();
+                rc_free(it);
                 it = next;
             }
             else break; // if we aren't deleting something, no need to decrement further cells
@@ -1317,6 +1317,40 @@ namespace basil {
                 inner_ast->t = t_lowered;
                 return v_runtime(src.pos, t_runtime(t_lowered), inner_ast);
             }
+            case K_ARRAY: {
+                vector<rc<AST>> elements;
+                for (const Value& v : src.data.array->elements) {
+                    Value elt = lower(env, v);
+                    if (elt.type == T_ERROR) return elt;
+                    elements.push(elt.data.rt->ast);
+                }
+                if (t_lowered == T_ERROR) {
+                    err(src.pos, "Attempted to lower array '", src, "' with compile-time-only elements.");
+                    return v_error(src.pos);
+                }
+                rc<AST> array = ast_array(src.pos, t_array(t_array_element(t_lowered)), elements);
+                Type array_type = array->type(env); // runtime arrays carry their length, so aren't sized
+                if (array_type == T_ERROR) return v_error(src.pos);
+                return v_runtime(src.pos, t_runtime(array_type), array);
+            }
+            case K_DICT: {
+                vector<rc<AST>> entries;
+                for (const auto& [k, v] : src.data.dict->elements) {
+                    Value key = lower(env, k), value = lower(env, v);
+                    if (key.type == T_ERROR) return key;
+                    if (value.type == T_ERROR) return value;
+                    entries.push(key.data.rt->ast);
+                    entries.push(value.data.rt->ast);
+                }
+                if (t_lowered == T_ERROR) {
+                    err(src.pos, "Attempted to lower dictionary '", src, "' with compile-time-only entries.");
+                    return v_error(src.pos);
+                }
+                rc<AST> dict = ast_dict(src.pos, t_lowered, entries);
+                Type dict_type = dict->type(env);
+                if (dict_type == T_ERROR) return v_error(src.pos);
+                return v_runtime(src.pos, t_runtime(dict_type), dict);
+            }
             case K_ERROR:
             case K_RUNTIME: return src;
             default:   
@@ -259,7 +259,31 @@ namespace jasmine {
                 i64 negative = io.peek() == '-' ? -1 : 1;
                 io.read();
                 consume_leading_space(io);
-                if ((io.peek() >= '0' && io.peek() <= '9') || io.peek() == '-') {
+                if (io.peek() == '%' && ptr.kind == PK_REG && negative > 0) {
+                    p.data.mem.kind = MK_REG_INDEX;
+                    p.data.mem.reg = ptr.data.reg;
+                    p.data.mem.index = parse_register(context, true, io);
+                    p.data.mem.scale = 1;
+                    p.data.mem.off = 0;
+                    consume_leading_space(io);
+                    if (io.peek() == '*') {
+                        io.read();
+                        consume_leading_space(io);
+                        p.data.mem.scale = parse_number(io);
+                        if (p.data.mem.scale != 1 && p.data.mem.scale != 2
+                            && p.data.mem.scale != 4 && p.data.mem.scale != 8) {
+                            fprintf(stderr, "[ERROR] Index scale must be 1, 2, 4, or 8.\n");
+                            exit(1);
+                        }
+                        consume_leading_space(io);
+                    }
+                    if (io.peek() == '+' || io.peek() == '-') {
+                        i64 sign = io.read() == '-' ? -1 : 1;
+                        consume_leading_space(io);
+                        p.data.mem.off = sign * parse_number(io);
+                    }
+                }
+                else if ((io.peek() >= '0' && io.peek() <= '9') || io.peek() == '-') {
                     if (ptr.kind == PK_REG) {
                         p.data.mem.kind = MK_REG_OFF;
                         p.data.mem.reg = ptr.data.reg;
@@ -350,6 +374,22 @@ namespace jasmine {
         expect(')', io);
     }
 
+    void parse_table(Context& context, stream& io, Insn& insn) {
+        expect('(', io);
+        bool first = true;
+        while (io && io.peek() != ')') {
+            if (!first) expect(',', io);
+            parse_param(context, io, insn);
+            if (insn.params.back().kind != PK_LABEL) {
+                fprintf(stderr, "[ERROR] Expected label in jump table.\n");
+                exit(1);
+            }
+            first = false;
+            consume_leading_space(io);
+        }
+        expect(')', io);
+    }
+
     Member parse_member(Context& context, stream& io) {
         string name = next_string(io);
         expect(':', io);
@@ -410,7 +450,7 @@ namespace jasmine {
             exit(1);
         }
         data[0] |= n << 5;
-        for (u8 j = 0; j <= n; j ++) io.write(data[j]);
+        io.write(data, n + 1);
     }
 
     // Disassemblers
@@ -432,8 +472,10 @@ namespace jasmine {
 
     string disassemble_string(const Context& context, bytebuf& buf) {
         u8 length = buf.read<u8>();
+        u8 chars[256];
+        buf.read(chars, length);
         string s;
-        for (u32 i = 0; i < length; i ++) s += buf.read<u8>();
+        for (u32 i = 0; i < length; i ++) s += chars[i];
         return s;
     }
 
@@ -472,7 +514,7 @@ namespace jasmine {
                 p.data.reg = disassemble_reg(context, buf);
                 break;
             case PK_MEM: {
-                p.data.mem.kind = MemKind(buf.read<u8>() >> 6 & 3);
+                p.data.mem.kind = MemKind(buf.read<u8>() >> 5 & 7);
                 switch (p.data.mem.kind) {
                     case MK_REG_OFF:
                         p.data.mem.reg = disassemble_reg(context, buf);
@@ -492,6 +534,12 @@ namespace jasmine {
                         p.data.mem.type = disassemble_type(context, buf);
                         p.data.mem.off = disassemble_imm(context, buf);
                         break;
+                    case MK_REG_INDEX:
+                        p.data.mem.reg = disassemble_reg(context, buf);
+                        p.data.mem.index = disassemble_reg(context, buf);
+                        p.data.mem.scale = buf.read<u8>();
+                        p.data.mem.off = disassemble_imm(context, buf);
+                        break;
                 }
                 break;
             }
@@ -553,6 +601,11 @@ namespace jasmine {
             insn.params.back().annotation = some<Type>(type);
         }
     }
+
+    void disassemble_table(Context& context, bytebuf& buf, const Object& obj, Insn& insn, ParamKind pk) {
+        i64 n = disassemble_60bit(buf).first;
+        for (i64 i = 0; i < n; i ++) disassemble_param(context, buf, obj, insn, PK_LABEL);
+    }
     
     // Validators
 
@@ -585,7 +638,7 @@ namespace jasmine {
                 assemble_60bit(obj.code(), param.data.reg.id, param.data.reg.global);
                 break;
             case PK_MEM:
-                obj.code().write(param.data.mem.kind << 6); // memkind
+                obj.code().write<u8>(param.data.mem.kind << 5); // memkind
                 switch (param.data.mem.kind) {
                     case MK_REG_OFF:
                         assemble_60bit(obj.code(), param.data.mem.reg.id, param.data.mem.reg.global);
@@ -608,6 +661,12 @@ namespace jasmine {
                         assemble_type(context, param.data.mem.type, obj);
                         assemble_60bit(obj.code(), abs(param.data.mem.off), param.data.mem.off < 0);
                         break;
+                    case MK_REG_INDEX:
+                        assemble_60bit(obj.code(), param.data.mem.reg.id, param.data.mem.reg.global);
+                        assemble_60bit(obj.code(), param.data.mem.index.id, param.data.mem.index.global);
+                        obj.code().write<u8>(param.data.mem.scale);
+                        assemble_60bit(obj.code(), abs(param.data.mem.off), param.data.mem.off < 0);
+                        break;
                 }
                 break;
             case PK_LABEL:
@@ -661,6 +720,13 @@ namespace jasmine {
         return insn.params.size();
     }
 
+    // Jump tables are every remaining parameter, all of which are labels.
+    i64 assemble_table(const Context& context, Object& obj, const Insn& insn, i64 param) {
+        assemble_60bit(obj.code(), insn.params.size() - param, false);
+        for (i64 i = param; i < insn.params.size(); i ++) assemble_param(context, insn.params[i], obj);
+        return insn.params.size();
+    }
+
     // Printers
 
     void print_type(const Context& context, stream& io, Type t, const char* prefix) {
@@ -745,6 +811,17 @@ namespace jasmine {
                     }
                     write(io, "]");
                     break;
+                case MK_REG_INDEX:
+                    write(io, prefix, "[");
+                    print_reg(context, io, p.data.mem.reg);
+                    write(io, " + ");
+                    print_reg(context, io, p.data.mem.index);
+                    if (p.data.mem.scale != 1) write(io, " * ", (u32)p.data.mem.scale);
+                    if (p.data.mem.off != 0) 
+                        write(io, p.data.mem.off < 0 ? " - " : " + ", 
+                            p.data.mem.off < 0 ? -p.data.mem.off : p.data.mem.off);
+                    write(io, "]");
+                    break;
             }
         }
     }
@@ -776,6 +853,14 @@ namespace jasmine {
         return insn.params.size();
     }
 
+    i64 print_table(const Context& context, stream& io, const Insn& insn, i64 param) {
+        write(io, " (");
+        for (i64 i = param; i < insn.params.size(); i ++) 
+            print_param(context, insn.params[i], io, i == param ? "" : ", ");
+        write(io, ")");
+        return insn.params.size();
+    }
+
     i64 print_label(const Context& context, stream& io, const Insn& insn, i64 param) {
         const Param& p = insn.params[param];
         if (p.kind != PK_LABEL) {
@@ -848,6 +933,14 @@ namespace jasmine {
         print_label
     };
 
+    static OpComponent C_TABLE = {
+        parse_table,
+        disassemble_table,
+        nullptr,
+        assemble_table,
+        print_table
+    };
+
     static OpComponent C_TYPEDEF = {
         parse_typedef,
         disassemble_typedef,
@@ -902,6 +995,13 @@ namespace jasmine {
         );
     }
 
+    Op switch_op(Opcode opcode) {
+        return Op(
+            opcode,
+            C_TYPE, C_LABEL, C_DEST, C_SRC, C_TABLE
+        );
+    }
+
     Op typedef_op(Opcode opcode) {
         return Op(
             opcode,
@@ -956,7 +1056,8 @@ namespace jasmine {
         ternary_op(OP_ROR), 
         call_op(OP_SYSCALL), 
         unary_op(OP_LIT),
-        unary_op(OP_STAT)
+        unary_op(OP_STAT),
+        switch_op(OP_SWITCH)
     };
 
     map<string, Opcode> OPCODE_TABLE = map_of<string, Opcode>(
@@ -1006,7 +1107,8 @@ namespace jasmine {
         string("ror"), OP_ROR,
         string("syscall"), OP_SYSCALL,
         string("lit"), OP_LIT,
-        string("stat"), OP_STAT
+        string("stat"), OP_STAT,
+        string("switch"), OP_SWITCH
     );
 
     string OPCODE_NAMES[] = {
@@ -1024,7 +1126,8 @@ namespace jasmine {
         "type", "global",
         "rol", "ror",
         "syscall", 
-        "lit", "stat"
+        "lit", "stat",
+        "switch"
     };
 
     Insn parse_insn(Context& context, stream& io) {
@@ -1091,8 +1194,8 @@ namespace jasmine {
         pk[2] = ParamKind(typearg >> 4 & 3);
         i64 i = 0;
         for (const auto& comp : OPS[insn.opcode].components) {
-            comp->disassembler(context, buf, obj, insn, pk[i]);
-            if (comp != &C_TYPE && comp != &C_TYPEDEF && comp != &C_VARIADIC) i ++;
+            comp->disassembler(context, buf, obj, insn, i < 3 ? pk[i] : PK_LABEL);
+            if (comp != &C_TYPE && comp != &C_TYPEDEF && comp != &C_VARIADIC && comp != &C_TABLE) i ++;
         }
         i = 0;
         for (const auto& comp : OPS[insn.opcode].components) if (comp->validator) {
@@ -1281,6 +1384,17 @@ namespace jasmine {
             return p;
         }
 
+        Param m(u64 reg, u64 index, u8 scale, i64 off) {
+            Param p;
+            p.kind = PK_MEM;
+            p.data.mem.kind = MK_REG_INDEX;
+            p.data.mem.reg = { false, reg };
+            p.data.mem.index = { false, index };
+            p.data.mem.scale = scale;
+            p.data.mem.off = off;
+            return p;
+        }
+
         Param l(Symbol symbol) {
             Param p;
             p.kind = PK_LABEL;
@@ -1492,6 +1606,19 @@ namespace jasmine {
         void jump(Symbol symbol) {
             unary(OP_JUMP, I64, l(symbol));
         }
+
+        // Jumps to targets[value - low], or to 'otherwise' if that's out of bounds.
+        void switch_(Type type, Symbol otherwise, const Param& value, i64 low, const vector<Symbol>& targets) {
+            verify_buffer();
+            Insn insn;
+            insn.opcode = OP_SWITCH;
+            insn.type = type;
+            insn.params.push(l(otherwise));
+            insn.params.push(value);
+            insn.params.push(imm(low));
+            for (Symbol target : targets) insn.params.push(l(target));
+            assemble_insn(*ctx, *obj, insn);
+        }
         
         void nop() {
             nullary(OP_NOP);
@@ -1666,30 +1793,63 @@ namespace jasmine {
             && (in.params[0].kind == PK_REG || in.params[0].kind == PK_MEM);
     }
 
+    // adds any registers read by a parameter to 'live'. memory parameters read their
+    // base and index registers even when they are the destination.
+    void param_uses(const Param& p, bitset& live) {
+        if (p.kind == PK_REG) live.insert(p.data.reg.id);
+        if (p.kind == PK_MEM && 
+            (p.data.mem.kind == MK_REG_OFF || p.data.mem.kind == MK_REG_TYPE || p.data.mem.kind == MK_REG_INDEX))
+            live.insert(p.data.mem.reg.id);
+        if (p.kind == PK_MEM && p.data.mem.kind == MK_REG_INDEX)
+            live.insert(p.data.mem.index.id);
+    }
+
     bool liveout(const Insn& in, bitset& live, const bitset& out) {
         bitset old = live;
         bool changed = false;
         live = out;
         if (destructive(in)) {
-            live.erase(in.params[0].data.reg.id);
-            for (u32 i = 1; i < in.params.size(); i ++) {
-                if (in.params[i].kind == PK_REG) live.insert(in.params[i].data.reg.id);
-                if (in.params[i].kind == PK_MEM && 
-                    (in.params[i].data.mem.kind == MK_REG_OFF || in.params[i].data.mem.kind == MK_REG_TYPE))
-                    live.insert(in.params[i].data.mem.reg.id);
-            }
+            if (in.params[0].kind == PK_REG) live.erase(in.params[0].data.reg.id);
+            else param_uses(in.params[0], live);
+            for (u32 i = 1; i < in.params.size(); i ++) param_uses(in.params[i], live);
         }
         else {
-            for (u32 i = 0; i < in.params.size(); i ++) {
-                if (in.params[i].kind == PK_REG) live.insert(in.params[i].data.reg.id);
-                if (in.params[i].kind == PK_MEM && 
-                    (in.params[i].data.mem.kind == MK_REG_OFF || in.params[i].data.mem.kind == MK_REG_TYPE))
-                    live.insert(in.params[i].data.mem.reg.id);
-            }
+            for (u32 i = 0; i < in.params.size(); i ++) param_uses(in.params[i], live);
         }
         return live != old || changed;
     }
 
+    // Finds the instructions 'in' may jump to within the function. Jumps name their target
+    // first, and switches follow their value and lower bound with a table of targets.
+    static void jump_targets(const Insn& in, const map<Symbol, u64>& local_syms, vector<u64>& targets) {
+        targets.clear();
+        if (in.opcode < OP_JEQ || (in.opcode > OP_JUMP && in.opcode != OP_SWITCH)) return;
+        for (u32 i = 0; i < in.params.size(); i ++) {
+            if (i > 0 && (in.opcode != OP_SWITCH || i < 3)) continue;
+            auto it = local_syms.find(in.params[i].data.label);
+            if (it == local_syms.end()) {
+                fprintf(stderr, "[ERROR] Tried to jump to label '%s' outside of current function.\n", 
+                    name(in.params[i].data.label));
+                exit(1);
+            }
+            targets.push(it->second);
+        }
+    }
+
+    // Assignments known to be identical form sets, each named by its earliest assignment.
+    // 'eqv' maps every other assignment towards that one.
+    static u64 canonical_assignment(map<u64, u64>& eqv, u64 a) {
+        auto it = eqv.find(a);
+        if (it == eqv.end()) return a;
+        return it->second = canonical_assignment(eqv, it->second);
+    }
+
+    static void unify_assignments(map<u64, u64>& eqv, u64 a, u64 b) {
+        a = canonical_assignment(eqv, a), b = canonical_assignment(eqv, b);
+        if (a < b) eqv[b] = a;
+        else if (b < a) eqv[a] = b;
+    }
+
     void compute_ranges(Function& function, const vector<Insn>& insns) {
         vector<pair<bitset, bitset>> sets;
         map<Symbol, u64> local_syms;
@@ -1700,35 +1860,17 @@ namespace jasmine {
         }
 
         sets.push({});
+        vector<u64> targets;
         bool changed = true;
         while (changed) {
             changed = false;
             for (i64 i = i64(function.last); i >= i64(function.first); i --) {
                 const Insn& in = insns[i];
-                if (in.opcode == OP_JUMP) { // unconditional jump
-                    auto it = local_syms.find(in.params[0].data.label);
-                    if (it == local_syms.end()) {
-                        fprintf(stderr, "[ERROR] Tried to jump to label '%s' outside of current function.\n", 
-                            name(in.params[0].data.label));
-                        exit(1);
-                    }
-
-                    changed |= sets[i - function.first].second |= sets[it->second - function.first].first;
-                }
-                else if (in.opcode >= OP_JEQ && in.opcode < OP_JUMP) { // conditional jump
-                    auto it = local_syms.find(in.params[0].data.label);
-                    if (it == local_syms.end()) {
-                        fprintf(stderr, "[ERROR] Tried to jump to label '%s' outside of current function.\n", 
-                            name(in.params[0].data.label));
-                        exit(1);
-                    }
-                    
-                    changed |= sets[i - function.first].second |= sets[it->second - function.first].first;
+                jump_targets(in, local_syms, targets);
+                for (u64 target : targets) 
+                    changed |= sets[i - function.first].second |= sets[target - function.first].first;
+                if (in.opcode != OP_JUMP && in.opcode != OP_SWITCH) // fall through to the next insn
                     changed |= sets[i - function.first].second |= sets[i + 1 - function.first].first;
-                }
-                else {
-                    changed |= sets[i - function.first].second |= sets[i + 1 - function.first].first;
-                }
                 
                 changed = liveout(insns[i], sets[i - function.first].first, sets[i - function.first].second) || changed;
             }
@@ -1766,28 +1908,20 @@ namespace jasmine {
                 auto it = prev.find(r);
                 auto existing = bind.find(r);
                 if (existing != bind.end() && it != prev.end()) {
-                    eqv[existing->second] = it->second;
-                    eqv[it->second] = existing->second;
+                    unify_assignments(eqv, existing->second, it->second);
                 }
                 else if (it != prev.end()) bind[r] = it->second; // use prev binding
                 else if (existing == bind.end()) 
                     panic("Expected previous assignment of register %", r, " on instruction ", idx + function.first, "! Might be undefined!");
             }
             
-            if (insns[i].opcode >= OP_JEQ && insns[i].opcode <= OP_JUMP) { // jump instruction
-                auto it = local_syms.find(insns[i].params[0].data.label);
-                if (it == local_syms.end()) {
-                    fprintf(stderr, "[ERROR] Tried to jump to label '%s' outside of current function.\n", 
-                        name(insns[i].params[0].data.label));
-                    exit(1);
-                }
-                // copy bindings to jump targets
-                u64 dest = it->second - function.first;
+            jump_targets(insns[i], local_syms, targets);
+            for (u64 target : targets) { // copy bindings to jump targets
+                u64 dest = target - function.first;
                 for (const auto& [r, i] : bind) {
                     auto it = dom_assign[dest].find(r); // check for existing binding
                     if (it != dom_assign[dest].end() && it->second != i) { // unify these two bindings
-                        eqv[it->second] = i;
-                        eqv[i] = it->second;
+                        unify_assignments(eqv, it->second, i);
                     }
                     else dom_assign[dest].put(r, i);
                 }
@@ -1795,22 +1929,8 @@ namespace jasmine {
         }
 
         // eliminate eqv
-        map<u64, u64> canonical; // canonical values for all eqv entries
-        for (const auto& [a, b] : eqv) {
-            if (a < b) canonical[b] = a;
-            else canonical[a] = b;
-        }
-        
-        changed = true;
-        while (changed) {
-            changed = false;
-            for (u64 i = function.first; i <= function.last; i ++) {
-                for (auto& [r, i] : dom_assign[i - function.first]) {
-                    auto it = canonical.find(i);
-                    if (it != canonical.end() && it->second < i) i = it->second, changed = true;
-                }
-            }
-        }
+        for (u64 i = function.first; i <= function.last; i ++)
+            for (auto& [r, a] : dom_assign[i - function.first]) a = canonical_assignment(eqv, a);
         eqv.clear();
         // println("");
         // for (u64 i = function.first; i <= function.last; i ++) {
@@ -1900,6 +2020,17 @@ namespace jasmine {
         // println("");
     }
 
+    // Returns whether another range already bound to 'reg' is live at the same time as 'r'.
+    // Ranges only have one location, so moving one moves it for its whole lifetime.
+    static bool overlaps_binding(const Function& f, const LiveRange* r, u32 reg) {
+        for (const LiveRange& other : f.ranges) {
+            if (&other == r || other.loc.type != LT_REGISTER || *other.loc.reg != reg) continue;
+            for (const auto& [a, b] : r->intervals) for (const auto& [c, d] : other.intervals)
+                if (a < d && c < b) return true;
+        }
+        return false;
+    }
+
     void clobber(Function& f, const Insn& insn, u32 insn_idx, const_slice<bitset*> regs, 
         vector<LiveRange*>& mappings, const Target& target) {
         bitset clobbers = target.clobbers(insn);
@@ -1922,6 +2053,7 @@ namespace jasmine {
             bool remapped = false;
             for (u32 i : kregs) {
                 if (r->illegal.contains(i)) continue; // can't reallocate to previously-clobbered reg
+                if (overlaps_binding(f, r, i)) continue; // or one in use elsewhere in the range
 
                 r->loc = loc_reg(i);
                 kregs.erase(i);
@@ -2018,7 +2150,8 @@ namespace jasmine {
                 }
 
                 if (kregs.begin() != kregs.end()) {
-                    auto reg = r->hint && r->hint->type == LT_REGISTER ? *r->hint->reg : *kregs.begin();
+                    auto reg = r->hint && r->hint->type == LT_REGISTER && kregs.contains(*r->hint->reg) 
+                        ? *r->hint->reg : *kregs.begin(); // only take the hint if it's still free
                     // println("\tallocated %", r->reg.id, " to ", x64::REGISTER_NAMES[reg]);
                     r->loc = loc_reg(reg);
                     kregs.erase(reg);
@@ -2029,6 +2162,12 @@ namespace jasmine {
             }
         }
 
+        // Calls expect rsp to be 16-byte aligned, so functions that make any always set up a
+        // frame that keeps it that way. Call sites then pad out whatever they push.
+        bool calls = false;
+        for (u64 i = f.first; i <= f.last; i ++) if (insns[i].opcode == OP_CALL) calls = true;
+        if (calls) f.stack = f.stack ? (f.stack + 15) & ~15ul : 16;
+
         // for (const LiveRange& r : f.ranges) {
         //     Param p;
         //     p.kind = PK_REG;
@@ -2083,7 +2222,7 @@ namespace jasmine {
                     return some<x64::Arg>(regs[size]((x64::Register)*reg_bindings[p.data.reg.id]->loc.reg));
                 }
                 else {
-                    return some<x64::Arg>(mems[size](x64::RBP, -i64(*reg_bindings[p.data.reg.id]->loc.offset)));
+                    return some<x64::Arg>(mems[size](x64::RBP, *reg_bindings[p.data.reg.id]->loc.offset));
                 }
             }
             case PK_MEM: {
@@ -2119,6 +2258,19 @@ namespace jasmine {
                         }
                         else return none<x64::Arg>();
                     }
+                    case MK_REG_INDEX: {
+                        static x64::Arg(*mems[4])(x64::Register, x64::Register, x64::Scale, i64) = {
+                            x64::m8, x64::m16, x64::m32, x64::m64
+                        };
+                        auto base = reg_bindings.find(m.reg.id), index = reg_bindings.find(m.index.id);
+                        if (base == reg_bindings.end() || index == reg_bindings.end()
+                            || base->second->loc.type != LT_REGISTER || index->second->loc.type != LT_REGISTER)
+                            return none<x64::Arg>(); // spilled operands are handled by borrow_address_registers()
+                        x64::Scale scale = m.scale == 8 ? x64::SCALE8 : m.scale == 4 ? x64::SCALE4 
+                            : m.scale == 2 ? x64::SCALE2 : x64::SCALE1;
+                        return some<x64::Arg>(mems[size]((x64::Register)*base->second->loc.reg, 
+                            (x64::Register)*index->second->loc.reg, scale, m.off));
+                    }
                     case MK_LABEL_OFF:
                         // if (reg_bindings[m.reg.id]->loc.type == LT_REGISTER) {
                         //     return some<x64::Arg>(m64((x64::Register)*reg_bindings[m.reg.id]->loc.reg, m.off));
@@ -2142,6 +2294,30 @@ namespace jasmine {
         }
     }
 
+    // Returns whether the provided memory operand computes its address using 'reg'.
+    static bool addresses(const x64::Arg& arg, x64::Register reg) {
+        using namespace x64;
+        if (arg.type >= REGISTER_OFFSET8 && arg.type <= REGISTER_OFFSET64)
+            return arg.data.register_offset.base == reg;
+        if (arg.type >= SCALED_INDEX8 && arg.type <= SCALED_INDEX64)
+            return arg.data.scaled_index.base == reg || arg.data.scaled_index.index == reg;
+        return false;
+    }
+
+    // Pushes a quadword argument. push only encodes sign-extended 32-bit immediates, so
+    // immediates are stored into a fresh stack slot instead.
+    void push_x64(const x64::Arg& src) {
+        using namespace x64;
+        if (!is_immediate(src.type)) return push(src);
+        i64 val = immediate_value(src);
+        sub(r64(RSP), imm(8));
+        if (val >= -0x80000000l && val <= 0x7fffffffl) mov(m64(RSP, 0), imm(val));
+        else {
+            mov(m32(RSP, 0), imm(i32(val)));
+            mov(m32(RSP, 4), imm(i32(val >> 32)));
+        }
+    }
+
     void move_x64(const x64::Arg& dest, const x64::Arg& src) {
         using namespace x64;
         if (is_register(dest.type) && dest == src)
@@ -2149,10 +2325,17 @@ namespace jasmine {
         if (is_label(src.type) && is_register(dest.type))
             return lea(dest, src);
         if (is_label(src.type)) {
-            push(r64(RAX));
-            lea(r64(RAX), src);
-            mov(dest, r64(RAX));
-            pop(r64(RAX));
+            Register tmp = RAX; // borrow a register the destination isn't addressed by
+            while (addresses(dest, tmp)) tmp = Register(tmp + 1);
+            Arg adjusted = dest;
+            if (addresses(dest, RSP)) { // account for the push
+                if (adjusted.type >= SCALED_INDEX8) adjusted.data.scaled_index.offset += 8;
+                else adjusted.data.register_offset.offset += 8;
+            }
+            push(r64(tmp));
+            lea(r64(tmp), src);
+            mov(adjusted, r64(tmp));
+            pop(r64(tmp));
             return;
         }
         if (is_register(dest.type) && is_immediate(src.type) && immediate_value(src) == 0)
@@ -2165,6 +2348,62 @@ namespace jasmine {
         }
     }
 
+    static bool reads(const x64::Arg& arg, x64::Register reg) {
+        return (x64::is_register(arg.type) && arg.data.reg == reg) || addresses(arg, reg);
+    }
+
+    // Performs each move from a source to a destination register as if they all happened
+    // at once, so no source is overwritten before it's read. A move waits while another
+    // still reads its destination, and cycles are broken by saving a source on the stack.
+    void parallel_move_x64(vector<pair<x64::Arg, x64::Arg>>& moves) {
+        using namespace x64;
+        vector<pair<Arg, Arg>> saved;
+        while (moves.size()) {
+            i64 ready = -1, cyclic = -1;
+            for (u32 i = 0; i < moves.size() && ready < 0; i ++) {
+                bool blocked = false;
+                for (u32 j = 0; j < moves.size(); j ++)
+                    if (j != i && reads(moves[j].second, moves[i].first.data.reg)) blocked = true;
+                if (!blocked) ready = i;
+                else if (!is_immediate(moves[i].second.type) && !is_label(moves[i].second.type)) cyclic = i;
+            }
+            if (ready < 0) { // every move is waiting on another, so save one source until the end
+                push(moves[cyclic].second);
+                saved.push(moves[cyclic]);
+                ready = cyclic;
+            }
+            else move_x64(moves[ready].first, moves[ready].second);
+            moves[ready] = moves.back();
+            moves.pop();
+        }
+        for (i64 i = i64(saved.size()) - 1; i >= 0; i --) pop(saved[i].first);
+    }
+
+    // Moves 'left' into 'dest' and applies 'op' with 'right', as a ternary jasmine instruction
+    // lowers to a two-operand x64 one. x64 permits only one memory operand, so if 'dest' and
+    // 'right' are both in memory, 'right' is loaded into a register saved around the operation.
+    void binary_x64(void (*op)(const x64::Arg&, const x64::Arg&, x64::Size), 
+        const x64::Arg& dest, const x64::Arg& left, const x64::Arg& right) {
+        using namespace x64;
+        if (!is_memory(dest.type) || !is_memory(right.type)) {
+            move_x64(dest, left);
+            return op(dest, right, AUTO);
+        }
+        Register tmp = RAX;
+        while (addresses(dest, tmp) || addresses(left, tmp) || addresses(right, tmp) 
+            || (is_register(left.type) && left.data.reg == tmp) || tmp == RSP || tmp == RBP) tmp = Register(tmp + 1);
+        Arg adjusted[3] = { dest, left, right };
+        for (Arg& arg : adjusted) if (addresses(arg, RSP)) { // account for the push
+            if (arg.type >= SCALED_INDEX8) arg.data.scaled_index.offset += 8;
+            else arg.data.register_offset.offset += 8;
+        }
+        push(r64(tmp));
+        mov(r64(tmp), adjusted[2]);
+        move_x64(adjusted[0], adjusted[1]);
+        op(adjusted[0], r64(tmp), AUTO);
+        pop(r64(tmp));
+    }
+
     i64 log2(i64 n) {
         i64 acc = 0;
         while (n > 1) {
@@ -2184,7 +2423,7 @@ namespace jasmine {
         }
     }
     
-    void generate_x64_insn(Function& f, const Insn& insn, u32 insn_idx, vector<x64::Arg>& args, Object& obj) {
+    static void define_x64_label(const Insn& insn, Object& obj) {
         ObjectSection section = OS_CODE;
         if (insn.opcode == OP_LIT) section = OS_DATA;
         if (insn.opcode == OP_STAT) section = OS_STATIC;
@@ -2195,6 +2434,10 @@ namespace jasmine {
             }
             obj.define(*insn.label, section);
         }
+    }
+
+    void generate_x64_insn(Function& f, const Insn& insn, u32 insn_idx, vector<x64::Arg>& args, Object& obj) {
+        define_x64_label(insn, obj);
         using namespace x64;
 
         static Condition conds_x64[6] = {
@@ -2226,15 +2469,13 @@ namespace jasmine {
                         return lea(args[0], m64(args[1].data.reg, args[2].data.reg, SCALE1, 0));
                     }
                 }
-                move_x64(args[0], args[1]);
-                add(args[0], args[2]);
-                return;
+                return binary_x64(add, args[0], args[1], args[2]);
             case OP_SUB:
                 if (!is_memory(args[1].type) && !is_memory(args[2].type)) {
                     if (is_immediate(args[1].type)) {
-                        i64 val = immediate_value(args[2]);
+                        i64 val = immediate_value(args[1]);
                         if (val == 0) {
-                            move_x64(args[0], args[1]);
+                            move_x64(args[0], args[2]);
                             return neg(args[0]);
                         }
                     }
@@ -2253,13 +2494,8 @@ namespace jasmine {
                             return lea(args[0], m64(args[1].data.reg, -val));
                         }
                     }
-                    else if (is_register(args[0].type)) {
-                        return lea(args[0], m64(args[1].data.reg, args[2].data.reg, SCALE1, 0));
-                    }
                 }
-                move_x64(args[0], args[1]);
-                sub(args[0], args[2]);
-                return;
+                return binary_x64(sub, args[0], args[1], args[2]);
             case OP_MUL: {
                 commute_ternary(args);
                 if (is_immediate(args[2].type)) {
@@ -2367,37 +2603,50 @@ namespace jasmine {
                 ret();
                 return;
             case OP_CALL: {
+                vector<Kind> param_kinds;
+                for (u32 i = 2; i < insn.params.size(); i ++) param_kinds.push(insn.params[i].annotation->kind);
+                auto params = obj.get_target().place_parameters(param_kinds); // compute parameter locations
+
+                // the frame leaves rsp aligned, so pad if we push an odd number of words before the call
+                u32 pushes = 0, pushed_args = 0;
+                for (LiveRange* r : f.preserved_regs[insn_idx - f.first]) if (r->loc.type == LT_REGISTER) pushes ++;
+                for (const Location& loc : params) 
+                    if (loc.type == LT_PUSHED_L2R || loc.type == LT_PUSHED_R2L) pushed_args ++;
+                bool pad = (pushes + pushed_args) % 2;
+                if (pad) sub(r64(RSP), imm(8));
+
                 for (LiveRange* r : f.preserved_regs[insn_idx - f.first]) if (r->loc.type == LT_REGISTER)
                     push(r64((Register)*r->loc.reg));
 
                 auto fn = insn.params[1].kind == PK_LABEL ? args[1] : r64(RAX);
                 if (insn.params[1].kind != PK_LABEL) move_x64(r64(RAX), args[1]);
 
-                vector<Kind> param_kinds;
-                for (u32 i = 2; i < insn.params.size(); i ++) param_kinds.push(insn.params[i].annotation->kind);
-                auto params = obj.get_target().place_parameters(param_kinds); // compute parameter locations
-
+                static vector<pair<Arg, Arg>> moves; // register arguments are placed last, all at once,
+                moves.clear();                       // since they may be held in each other's registers
                 for (u32 i = 2; i < insn.params.size(); i ++) {
                     if (params[i - 2].type == LT_REGISTER) 
-                        move_x64(r64((Register)*params[i - 2].reg), args[i]);
+                        moves.push({ r64((Register)*params[i - 2].reg), args[i] });
                     else if (params[i - 2].type == LT_STACK_MEMORY && params[i - 2].offset)
                         move_x64(m64(RBP, *params[i - 2].offset), args[i]);
                     else if (params[i - 2].type == LT_PUSHED_L2R)
-                        push(args[i]);
+                        push_x64(args[i]);
                 }
                 for (i64 i = i64(insn.params.size()) - 1; i >= 2; i --) {
                     if (params[i - 2].type == LT_PUSHED_R2L) 
-                        push(args[i]);
+                        push_x64(args[i]);
                 }
+                parallel_move_x64(moves);
                 call(fn);
 
                 Location ret = obj.get_target().locate_return_value(insn.type.kind);
                 if (ret.type == LT_REGISTER) if (args[0].data.reg != RSP) move_x64(args[0], r64((Register)*ret.reg));
+                if (pushed_args) add(r64(RSP), imm(8 * pushed_args)); // the caller cleans up stack arguments
 
                 for (i64 i = i64(f.preserved_regs[insn_idx - f.first].size()) - 1; i >= 0; i --) {
                     const auto& r = f.preserved_regs[insn_idx - f.first][i];
                     if (r->loc.type == LT_REGISTER) pop(r64((Register)*r->loc.reg));
                 }
+                if (pad) add(r64(RSP), imm(8));
 
                 return;
             }
@@ -2407,7 +2656,8 @@ namespace jasmine {
             case OP_JLE:
             case OP_JG:
             case OP_JGE:
-                if (is_immediate(args[1].type) && is_immediate(args[2].type)) {
+                if ((is_immediate(args[1].type) && is_immediate(args[2].type))
+                    || (is_memory(args[1].type) && is_memory(args[2].type))) {
                     move_x64(r64(RAX), args[1]);
                     cmp(r64(RAX), args[2]);
                     jcc(args[0], conds_x64[insn.opcode - OP_JEQ]);
@@ -2431,10 +2681,40 @@ namespace jasmine {
                 }
                 else cmp(args[1], args[2]);
                 setcc(args[0], conds_x64[insn.opcode - OP_CEQ]);
+                if (insn.type.kind != K_I8 && insn.type.kind != K_U8)
+                    and_(args[0], imm(0xff)); // setcc only writes the low byte
                 return;
             case OP_JUMP:
                 jmp(args[0]);
                 return;
+            case OP_SWITCH: {
+                // The table holds the offset of each target from the end of its entry, so it
+                // doesn't need relocating wherever the code is loaded.
+                static u64 table_idx = 0;
+                char table_name[32];
+                snprintf(table_name, sizeof(table_name), ".JT%lu", (unsigned long)table_idx ++);
+                jasmine::Symbol table = local(table_name);
+
+                i64 low = immediate_value(args[2]);
+                move_x64(r64(RAX), args[1]);
+                if (low < -0x80000000l || low > 0x7fffffffl) {
+                    mov(r64(RDX), imm(low));
+                    sub(r64(RAX), r64(RDX));
+                }
+                else if (low) sub(r64(RAX), imm(low));
+                cmp(r64(RAX), imm(insn.params.size() - 3));
+                jcc(args[0], ABOVE_OR_EQUAL); // also catches values below the bound, which wrapped
+                lea(r64(RDX), label64(table));
+                lea(r64(RDX), m64(RDX, RAX, SCALE4, 4));
+                movsx(r64(RAX), m32(RDX, -4));
+                add(r64(RAX), r64(RDX));
+                jmp(r64(RAX));
+
+                while (obj.data().size() % 4) lit8(0);
+                obj.define(table, OS_DATA);
+                for (u32 i = 3; i < args.size(); i ++) rel32(args[i].data.label);
+                return;
+            }
             case OP_MOV: 
                 return move_x64(args[0], args[1]);
             // case OP_XCHG: 
@@ -2466,6 +2746,76 @@ namespace jasmine {
         }
     }
 
+    // Returns whether 'p' is a memory operand that needs its address registers in hardware
+    // registers. Scaled-index operands always do. Register-offset operands do when based on
+    // a spilled scalar, which holds a pointer; a spilled struct is addressed in its slot.
+    static bool needs_address_registers(const Param& p, const map<u64, LiveRange*>& reg_bindings) {
+        if (p.kind != PK_MEM) return false;
+        if (p.data.mem.kind == MK_REG_INDEX) return true;
+        if (p.data.mem.kind != MK_REG_OFF) return false;
+        auto it = reg_bindings.find(p.data.mem.reg.id);
+        return it != reg_bindings.end() && it->second->loc.type == LT_STACK_MEMORY 
+            && it->second->type.kind != K_STRUCT;
+    }
+
+    // Loads any spilled address registers of the instruction's memory operands into registers
+    // the instruction doesn't otherwise use, which are saved on the stack around it. The
+    // borrowed registers are returned in the order they were pushed, and 'mem_bindings' is
+    // updated to point at them. Register operands keep using 'reg_bindings', so a spilled
+    // destination is still written to its slot even if it also appears in an address.
+    vector<x64::Register> borrow_address_registers(const Target& target, const Insn& insn, const Function& f,
+        const map<u64, LiveRange*>& reg_bindings, map<u64, LiveRange*>& mem_bindings, vector<LiveRange>& scratch) {
+        using namespace x64;
+        vector<u64> spilled;
+        bitset used;
+        scratch.clear();
+        for (const Param& p : insn.params) {
+            u64 ids[2];
+            u32 n = 0;
+            if (p.kind == PK_REG) ids[n ++] = p.data.reg.id;
+            else if (p.kind == PK_MEM && p.data.mem.kind != MK_LABEL_OFF && p.data.mem.kind != MK_LABEL_TYPE) {
+                ids[n ++] = p.data.mem.reg.id;
+                if (p.data.mem.kind == MK_REG_INDEX) ids[n ++] = p.data.mem.index.id;
+            }
+            for (u32 i = 0; i < n; i ++) {
+                auto it = reg_bindings.find(ids[i]);
+                if (it == reg_bindings.end()) continue;
+                if (it->second->loc.type == LT_REGISTER) used.insert(*it->second->loc.reg);
+                else if (needs_address_registers(p, reg_bindings)) {
+                    bool seen = false;
+                    for (u64 id : spilled) if (id == ids[i]) seen = true;
+                    if (!seen) spilled.push(ids[i]);
+                }
+            }
+        }
+
+        // rax, rcx, and rdx are avoided since some instructions use them implicitly
+        static const Register candidates[] = { RBX, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+        vector<Register> borrowed;
+        for (u64 id : spilled) {
+            Register reg = INVALID;
+            for (Register r : candidates) if (!used.contains(r)) {
+                reg = r;
+                break;
+            }
+            used.insert(reg);
+            Param p;
+            p.kind = PK_REG;
+            p.data.reg = Reg{ false, id };
+            Arg src = *to_x64_arg(target, I64, f, reg_bindings, p);
+            if (src.type == REGISTER_OFFSET64 && src.data.register_offset.base == RSP)
+                src.data.register_offset.offset += 8 * (borrowed.size() + 1);
+            push(r64(reg));
+            mov(r64(reg), src);
+            borrowed.push(reg);
+            scratch.push(LiveRange(Reg{ false, id }, I64));
+            scratch.back().loc = loc_reg(reg);
+        }
+        mem_bindings = reg_bindings;
+        for (u32 i = 0; i < spilled.size(); i ++) mem_bindings[spilled[i]] = &scratch[i];
+        return borrowed;
+    }
+
     void generate_x64(Function& f, vector<Insn>& insns, Object& obj) {
         using namespace x64;
         writeto(obj);        
@@ -2489,7 +2839,9 @@ namespace jasmine {
         }
 
         static vector<x64::Arg> args;
-        map<u64, LiveRange*> reg_bindings;
+        static vector<LiveRange> scratch;
+        vector<Register> borrowed;
+        map<u64, LiveRange*> reg_bindings, mem_bindings;
         for (u32 i = f.first; i <= f.last; i ++) {
             const Insn& insn = insns[i];
 
@@ -2508,17 +2860,33 @@ namespace jasmine {
                         reg_bindings[r->reg.id] = r;
 
             args.clear();
+            bool borrows = false;
+            for (const Param& p : insn.params) borrows |= needs_address_registers(p, reg_bindings);
+            if (borrows && insn.params[0].kind == PK_REG && insn.opcode != OP_CALL
+                && reg_bindings.find(insn.params[0].data.reg.id) == reg_bindings.end()) {
+                define_x64_label(insn, obj); // load into an unused destination
+                continue;
+            }
+            if (borrows) 
+                borrowed = borrow_address_registers(obj.get_target(), insn, f, reg_bindings, mem_bindings, scratch);
+
             bool useless = false; // useless instructions can happen when 
                                   // the destination of this instruction is unused
             for (const Param& p : insn.params) {
-                auto arg = to_x64_arg(obj.get_target(), insn.type, f, reg_bindings, p);
+                auto arg = to_x64_arg(obj.get_target(), insn.type, f, 
+                    borrows && p.kind == PK_MEM ? mem_bindings : reg_bindings, p);
                 if (!arg && insn.opcode != OP_CALL && insn.opcode != OP_SYSCALL) useless = true;
                 else if (!arg) args.push(r64(RSP)); // rsp signifies lack of real parameter
                 else args.push(*arg);
             }
-            if (useless) continue;
-            
-            generate_x64_insn(f, insn, i, args, obj);
+            if (borrows) for (x64::Arg& arg : args) // account for the borrowed registers on the stack
+                if (arg.type >= REGISTER_OFFSET8 && arg.type <= REGISTER_OFFSET64 
+                    && arg.data.register_offset.base == RSP)
+                    arg.data.register_offset.offset += 8 * borrowed.size();
+            if (!useless) generate_x64_insn(f, insn, i, args, obj);
+            else define_x64_label(insn, obj); // the instruction may still be a branch target
+
+            if (borrows) for (i64 j = i64(borrowed.size()) - 1; j >= 0; j --) pop(r64(borrowed[j]));
         }
     }
     
@@ -38,6 +38,7 @@ namespace jasmine {
         OP_ROL, OP_ROR,                             // bitwise rotation
         OP_SYSCALL,                                 // user intrinsics
         OP_LIT, OP_STAT,                            // constants
+        OP_SWITCH,                                  // multiway jump
         NUM_OPS
     };
 
@@ -60,7 +61,8 @@ namespace jasmine {
         MK_REG_OFF,
         MK_LABEL_OFF,
         MK_REG_TYPE,
-        MK_LABEL_TYPE
+        MK_LABEL_TYPE,
+        MK_REG_INDEX
     };
 
     struct Context;
@@ -114,12 +116,16 @@ namespace jasmine {
             // not the byte offset in memory.
             // Label-type has the same characteristics as Register-type, only it uses a label
             // as the base address instead of a register.
+            // Register-index uses 'reg', 'index', 'scale', and 'off' to store
+            // [%reg + %index * scale + off], where scale is 1, 2, 4, or 8.
             struct { 
                 MemKind kind; 
                 Reg reg;
                 Symbol label;
                 Type type;
                 i64 off;
+                Reg index;
+                u8 scale;
             } mem; 
             Symbol label;
         } data;
@@ -166,6 +172,7 @@ namespace jasmine {
         Param m(u64 reg, Type, Symbol field);
         Param m(Symbol label, Type type);
         Param m(Symbol label, Type type, Symbol field);
+        Param m(u64 reg, u64 index, u8 scale, i64 off);
         Param l(Symbol symbol);
         Param l(const char* name);
 
@@ -220,6 +227,7 @@ namespace jasmine {
         void jo(Type type, Symbol symbol, const Param& lhs, const Param& rhs);
         void jno(Type type, Symbol symbol, const Param& lhs, const Param& rhs);
         void jump(Symbol symbol);
+        void switch_(Type type, Symbol otherwise, const Param& value, i64 low, const vector<Symbol>& targets);
         void nop();
         void ceq(Type type, const Param& dest, const Param& lhs, const Param& rhs);
         void cne(Type type, const Param& dest, const Param& lhs, const Param& rhs);
@@ -237,24 +237,16 @@ namespace jasmine {
         loaded_static = alloc_vmem(staticbuf.size());
         loaded_code = alloc_vmem(codebuf.size());
 
-        u8* writer = (u8*)loaded_code;
-        bytebuf copy = codebuf;
-        while (copy.size()) *writer++ = copy.read();
-        writer = (u8*)loaded_data;
-        copy = databuf;
-        while (copy.size()) *writer++ = copy.read();
-        writer = (u8*)loaded_static;
-        copy = staticbuf;
-        while (copy.size()) *writer++ = copy.read();
+        u64 code_size = codebuf.size(), data_size = databuf.size(), static_size = staticbuf.size();
+        codebuf.peek((u8*)loaded_code, code_size);
+        databuf.peek((u8*)loaded_data, data_size);
+        staticbuf.peek((u8*)loaded_static, static_size);
 
         resolve_refs();
 
-        for (u32 i = 0; i < code().size(); i ++) copy.write(((u8*)loaded_code)[i]);
-        codebuf = copy, copy.clear();
-        for (u32 i = 0; i < data().size(); i ++) copy.write(((u8*)loaded_data)[i]);
-        databuf = copy, copy.clear();
-        for (u32 i = 0; i < stat().size(); i ++) copy.write(((u8*)loaded_static)[i]);
-        staticbuf = copy, copy.clear();
+        codebuf.clear(), codebuf.write((const u8*)loaded_code, code_size);
+        databuf.clear(), databuf.write((const u8*)loaded_data, data_size);
+        staticbuf.clear(), staticbuf.write((const u8*)loaded_static, static_size);
 
         protect_exec(loaded_code, codebuf.size());
         protect_data(loaded_data, databuf.size());
@@ -284,12 +276,9 @@ namespace jasmine {
         b.write(little_endian<u64>(databuf.size())); // length of code
         b.write(little_endian<u64>(staticbuf.size())); // length of code
         
-        bytebuf copy = codebuf;
-        while (copy.size()) b.write(copy.read()); // copy over code
-        copy = databuf;
-        while (copy.size()) b.write(copy.read()); // copy over data
-        copy = staticbuf;
-        while (copy.size()) b.write(copy.read()); // copy over static
+        b.append(codebuf); // copy over code
+        b.append(databuf); // copy over data
+        b.append(staticbuf); // copy over static
 
         u32 internal_id = 0;
         map<Symbol, u32> internal_syms;
@@ -332,7 +321,12 @@ namespace jasmine {
             b.write<u32>(internal_syms[p.second.symbol]); // symbol id
         }
 
-        while (b.size()) fputc(b.read(), file);
+        u8 chunk[4096];
+        while (b.size()) {
+            u64 n = b.size() < sizeof(chunk) ? b.size() : sizeof(chunk);
+            b.read(chunk, n);
+            fwrite(chunk, 1, n, file);
+        }
     }
 
     void Object::read(const char* path) {
@@ -345,12 +339,28 @@ namespace jasmine {
         fclose(file);
     }
 
+    // Moves length bytes from one buffer to the end of another, if at least
+    // that many are available.
+    static bool move_bytes(bytebuf& from, bytebuf& to, u64 length) {
+        if (from.size() < length) return false;
+        u8 chunk[4096];
+        to.reserve(length);
+        while (length) {
+            u64 n = length < sizeof(chunk) ? length : sizeof(chunk);
+            from.read(chunk, n);
+            to.write(chunk, n);
+            length -= n;
+        }
+        return true;
+    }
+
     void Object::read(FILE* file) {
         char symbol[1024];
 
         bytebuf b;
-        int ch;
-        while ((ch = fgetc(file)) != EOF) b.write<u8>(ch);
+        u8 chunk[4096];
+        u64 n;
+        while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) b.write(chunk, n);
         u8 shebang[11];
         for (int i = 0; i < 10; i ++) shebang[i] = b.read();
         shebang[10] = '\0';
@@ -383,29 +393,17 @@ namespace jasmine {
         u64 data_length = from_little_endian(b.read<u64>()); // data length
         u64 static_length = from_little_endian(b.read<u64>()); // static length
 
-        while (code_length) {
-            if (!b.size()) {
-                fprintf(stderr, "[ERROR] File contains less code than announced.\n");
-                exit(1);
-            }
-            codebuf.write(b.read()); // read code from file
-            -- code_length;
+        if (!move_bytes(b, codebuf, code_length)) {
+            fprintf(stderr, "[ERROR] File contains less code than announced.\n");
+            exit(1);
         }
-        while (data_length) {
-            if (!b.size()) {
-                fprintf(stderr, "[ERROR] File contains less data than announced.\n");
-                exit(1);
-            }
-            databuf.write(b.read()); // read code from file
-            -- data_length;
+        if (!move_bytes(b, databuf, data_length)) {
+            fprintf(stderr, "[ERROR] File contains less data than announced.\n");
+            exit(1);
         }
-        while (static_length) {
-            if (!b.size()) {
-                fprintf(stderr, "[ERROR] File contains smaller static section than announced.\n");
-                exit(1);
-            }
-            staticbuf.write(b.read()); // read code from file
-            -- static_length;
+        if (!move_bytes(b, staticbuf, static_length)) {
+            fprintf(stderr, "[ERROR] File contains smaller static section than announced.\n");
+            exit(1);
         }
 
         u64 sym_count = from_little_endian(b.read<u64>());
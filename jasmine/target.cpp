@@ -198,9 +198,14 @@ namespace jasmine {
                 case OP_JLE:
                 case OP_JG:
                 case OP_JGE:
-                    if (insn.params[1].kind == PK_IMM && insn.params[2].kind == PK_IMM)
+                    if ((insn.params[1].kind == PK_IMM && insn.params[2].kind == PK_IMM)
+                        || insn.params[1].kind == PK_MEM || insn.params[2].kind == PK_MEM) // in case both are memory
                         clobbers.insert(RAX);
                     break;
+                case OP_SWITCH: // rax holds the table index, and rdx the entry address
+                    clobbers.insert(RAX);
+                    clobbers.insert(RDX);
+                    break;
                 case OP_CALL: {
                     // clobber return value
                     if (auto reg = target.locate_return_value(insn.type.kind).reg) {
@@ -239,18 +244,22 @@ namespace jasmine {
                     // return value hint
                     if (params[0]) params[0]->hint = some<Location>(target.locate_return_value(params[0]->type.kind));
 
-                    const bitset& gp = target.parameter_register_set(K_PTR);
-                    const bitset& fp = target.parameter_register_set(K_F64);
-                    auto gp_it = gp.begin(), fp_it = fp.begin();
+                    // the register lists are in argument order, unlike the register sets
+                    const_slice<GenericRegister> gp = target.parameter_registers(K_PTR);
+                    const_slice<GenericRegister> fp = target.parameter_registers(K_F64);
+                    u32 gp_idx = 0, fp_idx = 0;
                     for (u32 i = 2; i < params.size(); i ++) {
-                        if (params[i]) {
-                            if ((params[i]->type.kind == K_F32 || params[i]->type.kind == K_F64) 
-                                && fp_it != fp.end())
-                                params[i]->hint = some<Location>(loc_reg(*fp_it)), ++ fp_it;
-                            else if ((params[i]->type.kind != K_F32 && params[i]->type.kind != K_F64 && params[i]->type.kind != K_STRUCT) 
-                                && gp_it != gp.end()) 
-                                params[i]->hint = some<Location>(loc_reg(*gp_it)), ++ gp_it;
+                        bool is_fp = params[i] && (params[i]->type.kind == K_F32 || params[i]->type.kind == K_F64);
+                        // parameters keep their own hints, since they're placed by the caller 
+                        // regardless of where the allocator puts them
+                        if (params[i] && !params[i]->param_idx) {
+                            if (is_fp && fp_idx < fp.size())
+                                params[i]->hint = some<Location>(loc_reg(fp[fp_idx]));
+                            else if (!is_fp && params[i]->type.kind != K_STRUCT && gp_idx < gp.size()) 
+                                params[i]->hint = some<Location>(loc_reg(gp[gp_idx]));
                         }
+                        if (is_fp) fp_idx ++;
+                        else if (!params[i] || params[i]->type.kind != K_STRUCT) gp_idx ++;
                     }
                     break;
                 }
@@ -710,7 +710,7 @@ namespace jasmine::x64 {
                 sib |= (dest.data.scaled_index.base & 7);
                 has_sib = true;
             }
-            else if (base_register(dest) == RSP) {
+            else if ((base_register(dest) & 7) == RSP) { // RSP or R12
                 sib |= RSP << 3;
                 sib |= RSP;
                 has_sib = true;
@@ -730,7 +730,7 @@ namespace jasmine::x64 {
                 sib |= (src.data.scaled_index.base & 7);
                 has_sib = true;
             }
-            else if (base_register(src) == RSP) {
+            else if ((base_register(src) & 7) == RSP) {
                 sib |= RSP << 3;
                 sib |= RSP;
                 has_sib = true;
@@ -928,9 +928,10 @@ namespace jasmine::x64 {
         verify_args(dest, src);
         Size src_size = operand_size(src.type);
 
-        if (src_size != WORD && src_size != BYTE) {
+        bool dword = src_size == DWORD && operand_size(dest.type) == QWORD; // movsxd
+        if (src_size != WORD && src_size != BYTE && !dword) {
             fprintf(stderr, "[ERROR] Invalid operand size; source parameter in "
-                "'movsx' instruction must be word or byte-sized.\n");
+                "'movsx' instruction must be word or byte-sized, or dword-sized with a qword destination.\n");
             exit(1);
         }
         if (is_immediate(src.type)) {
@@ -944,11 +945,12 @@ namespace jasmine::x64 {
             exit(1);
         }
 
-        u8 opcode = src_size == WORD ? 0xBF : 0xBE;
-
         emitprefix(dest, src, operand_size(dest.type));
-        target->code().write<u8>(0x0f);
-        target->code().write<u8>(opcode);
+        if (dword) target->code().write<u8>(0x63);
+        else {
+            target->code().write<u8>(0x0f);
+            target->code().write<u8>(src_size == WORD ? 0xBF : 0xBE);
+        }
 
         Arg realsrc = src;
         if (is_label(src.type)) realsrc = riprel64(0);
@@ -1212,11 +1214,21 @@ namespace jasmine::x64 {
         emitargs(src, actual_size, 1);
     }
 
+    // Push and pop default to 64-bit operands, so at that size they only need a REX prefix
+    // to reach r8-r15.
+    void emit_stack_prefix(const Arg& src) {
+        u8 rex = 0x40;
+        if (is_64bit_register(base_register(src))) rex |= 1;
+        if (is_scaled_addressing(src.type) && is_64bit_register(src.data.scaled_index.index)) rex |= 2;
+        if (rex > 0x40) target->code().write(rex);
+    }
+
     void push(const Arg& src, Size size) {
         verify_buffer();
         Size actual_size = resolve_size(src, size);
 
         if (actual_size != QWORD) emitprefix(src, actual_size);
+        else if (!is_immediate(src.type)) emit_stack_prefix(src);
         if (is_immediate(src.type)) {
             if (actual_size == BYTE) target->code().write<u8>(0x6a);
             else target->code().write<u8>(0x68);
@@ -1236,6 +1248,7 @@ namespace jasmine::x64 {
         Size actual_size = resolve_size(src, size);
 
         if (actual_size != QWORD) emitprefix(src, actual_size);
+        else if (!is_immediate(src.type)) emit_stack_prefix(src);
         if (is_immediate(src.type)) {
             fprintf(stderr, "[ERROR] Invalid operand; immediate not permitted "
                 "in 'pop' instruction.\n");
@@ -1488,7 +1501,7 @@ namespace jasmine::x64 {
     void rel32(jasmine::Symbol symbol, ObjectSection section) {
         verify_buffer();
         target->get(section).write<u32>(0);
-        target->reference(symbol, OS_DATA, jasmine::RefType::REL32_LE, -4);
+        target->reference(symbol, section, jasmine::RefType::REL32_LE, -4);
     }
 
     void nop32(u32 val) {
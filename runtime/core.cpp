@@ -26,11 +26,11 @@ extern "C" void write_N6Streamii(i64 io, i64 value) {
 }
 
 extern "C" void write_N6Streamif(i64 io, float value) {
-    // write(io_for_fd(io), value);
+    write_float(io_for_fd(io), value);
 }
 
 extern "C" void write_N6Streamid(i64 io, double value) {
-    // write(io_for_fd(io), value);
+    write_double(io_for_fd(io), value);
 }
 
 extern "C" void write_N6Streamic(i64 io, u32 value) {
@@ -38,7 +38,7 @@ extern "C" void write_N6Streamic(i64 io, u32 value) {
 }
 
 extern "C" void write_N6Streamis(i64 io, const char* value) {
-    write_string(io_for_fd(io), value, *(u32*)(value - 4) - 1);
+    write_string(io_for_fd(io), value, string_length(value));
 }
 
 extern "C" void write_N6Streamin(i64 io, u32 value) {
@@ -59,6 +59,92 @@ extern "C" void write_N6Streamiv(i64 io, i64 value) {
     // write(io_for_fd(io), "()", 2);
 }
 
+extern "C" const char* mapfile_s(const char* path) {
+    return map_file(path);
+}
+
+extern "C" const char* read_N6Streamii(i64 io, i64 n) {
+    return read_direct(io_for_fd(io), n < 0 ? 0 : n);
+}
+
+extern "C" void unmap_s(const char* str) {
+    unmap(str);
+}
+
+extern "C" i64 length_s(const char* str) {
+    return string_chars(str); // code points, as at compile time
+}
+
+extern "C" const char* concat_ss(const char* a, const char* b) {
+    return string_concat(a, b);
+}
+
+extern "C" i64 compare_ss(const char* a, const char* b) {
+    return string_compare(a, b);
+}
+
+extern "C" i64 equal_ss(const char* a, const char* b) {
+    return string_equal(a, b); // widened, since compiled code tests the whole register
+}
+
+extern "C" const char* substr_sii(const char* str, i64 start, i64 end) {
+    return string_slice_chars(str, start, end);
+}
+
+extern "C" i64* array_ii(i64 length, i64 element_size) {
+    if (length < 0) length = 0;
+    if (length > (0x7fffffffffffffffll - 8) / element_size) {
+        const char msg[] = "Array is too large.\n";
+        write_string(io_for_fd(BASIL_STDERR_FD), msg, sizeof(msg) - 1);
+        sys::exit(1);
+    }
+    i64* array = (i64*)alloc(8 + length * element_size);
+    *array = length; // elements follow the length
+    return array;
+}
+
+// Compiled code checks array indices inline, and calls this when one is out of bounds.
+extern "C" void badindex_ii(i64 index, i64 length) {
+    sys::stream& err = io_for_fd(BASIL_STDERR_FD);
+    const char before[] = "Index ", after[] = " is out of bounds for array of length ";
+    write_string(err, before, sizeof(before) - 1);
+    write_int(err, index);
+    write_string(err, after, sizeof(after) - 1);
+    write_int(err, length);
+    write_byte(err, '\n');
+    sys::exit(1);
+}
+
+extern "C" i64* dict_i(i64 capacity) {
+    return (i64*)dict_new(capacity < 0 ? 0 : capacity);
+}
+
+extern "C" u64* dictinsert_ii(i64* d, i64 key) {
+    return dict_insert_word((dict*)d, key);
+}
+
+extern "C" u64* dictinsert_is(i64* d, const char* key) {
+    return dict_insert_string((dict*)d, key);
+}
+
+static void missing_key() {
+    const char msg[] = "Key not found in dictionary.\n";
+    write_string(io_for_fd(BASIL_STDERR_FD), msg, sizeof(msg) - 1);
+    sys::exit(1);
+}
+
+extern "C" u64* dictat_ii(i64* d, i64 key) {
+    u64* value = dict_find_word((dict*)d, key);
+    if (!value) missing_key();
+    return value;
+}
+
+extern "C" u64* dictat_is(i64* d, const char* key) {
+    u64* value = dict_find_string((dict*)d, key);
+    if (!value) missing_key();
+    return value;
+}
+
 extern "C" void exit_i(i64 code) {
     sys::exit(code);
 }
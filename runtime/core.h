@@ -23,6 +23,21 @@ extern "C" void write_N6Streamin(i64 io, u32 value);
 extern "C" void write_N6Streamib(i64 io, bool value);
 extern "C" void write_N6Streamit(i64 io, u32 value);
 extern "C" void write_N6Streamiv(i64 io, i64 value);
+extern "C" const char* mapfile_s(const char* path);
+extern "C" const char* read_N6Streamii(i64 io, i64 n);
+extern "C" void unmap_s(const char* str);
+extern "C" i64 length_s(const char* str);
+extern "C" const char* concat_ss(const char* a, const char* b);
+extern "C" i64 compare_ss(const char* a, const char* b);
+extern "C" i64 equal_ss(const char* a, const char* b);
+extern "C" const char* substr_sii(const char* str, i64 start, i64 end);
+extern "C" i64* array_ii(i64 length, i64 element_size);
+extern "C" void badindex_ii(i64 index, i64 length);
+extern "C" i64* dict_i(i64 capacity);
+extern "C" u64* dictinsert_ii(i64* d, i64 key);
+extern "C" u64* dictinsert_is(i64* d, const char* key);
+extern "C" u64* dictat_ii(i64* d, i64 key);
+extern "C" u64* dictat_is(i64* d, const char* key);
 extern "C" void exit_i(i64 code);
 extern "C" void init_v();
 
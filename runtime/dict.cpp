@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "sys.h"
+
+// Open-addressing hash tables behind runtime dictionaries. Every entry keeps the full
+// hash of its key, with the top bit set so that zero can mark an empty entry. Probing
+// compares hashes before keys, which spares most string comparisons, and growing the
+// table reinserts entries without hashing their keys again. Tables double once they
+// are three-quarters full. Old entry arrays aren't reclaimed, since nothing allocated
+// with alloc() is.
+
+namespace sys {
+    #define DICT_MIN_CAPACITY 8
+    #define HASH_PRESENT 0x8000000000000000ull
+
+    // The splitmix64 finalizer. Every input bit affects every output bit, so keys that
+    // only differ in their high bits still land in different buckets.
+    u64 hash_word(u64 h) {
+        h ^= h >> 30, h *= 0xbf58476d1ce4e5b9ull;
+        h ^= h >> 27, h *= 0x94d049bb133111ebull;
+        return h ^ h >> 31;
+    }
+
+    // Integers and symbols are compared by value.
+    struct word_keys {
+        static u64 hash(u64 key) {
+            return hash_word(key) | HASH_PRESENT;
+        }
+
+        static bool equal(u64 a, u64 b) {
+            return a == b;
+        }
+    };
+
+    // Strings are compared by contents.
+    struct string_keys {
+        static u64 hash(u64 key) {
+            return string_hash((const char*)key) | HASH_PRESENT;
+        }
+
+        static bool equal(u64 a, u64 b) {
+            return string_equal((const char*)a, (const char*)b);
+        }
+    };
+
+    static dict_entry* new_entries(u64 capacity) {
+        return (dict_entry*)alloc(capacity * sizeof(dict_entry));
+    }
+
+    dict* dict_new(u64 capacity) {
+        u64 n = DICT_MIN_CAPACITY;
+        while (n * 3 / 4 < capacity) n *= 2;
+        dict* d = (dict*)alloc(sizeof(dict));
+        d->size = 0;
+        d->mask = n - 1;
+        d->entries = new_entries(n);
+        return d;
+    }
+
+    static void grow(dict* d) {
+        u64 mask = d->mask * 2 + 1;
+        dict_entry* entries = new_entries(mask + 1);
+        for (u64 i = 0; i <= d->mask; i ++) {
+            const dict_entry& e = d->entries[i];
+            if (!e.hash) continue;
+            u64 j = e.hash & mask;
+            while (entries[j].hash) j = (j + 1) & mask;
+            entries[j] = e;
+        }
+        d->mask = mask, d->entries = entries;
+    }
+
+    template<typename Keys>
+    static u64* find(const dict* d, u64 key) {
+        u64 h = Keys::hash(key);
+        for (u64 i = h & d->mask; d->entries[i].hash; i = (i + 1) & d->mask) {
+            dict_entry& e = d->entries[i];
+            if (e.hash == h && Keys::equal(e.key, key)) return &e.value;
+        }
+        return nullptr;
+    }
+
+    template<typename Keys>
+    static u64* insert(dict* d, u64 key) {
+        u64 h = Keys::hash(key);
+        u64 i = h & d->mask;
+        for (; d->entries[i].hash; i = (i + 1) & d->mask) {
+            dict_entry& e = d->entries[i];
+            if (e.hash == h && Keys::equal(e.key, key)) return &e.value;
+        }
+        if (u64(d->size + 1) > (d->mask + 1) * 3 / 4) {
+            grow(d);
+            for (i = h & d->mask; d->entries[i].hash; i = (i + 1) & d->mask);
+        }
+        d->size ++;
+        dict_entry& e = d->entries[i];
+        e.hash = h, e.key = key, e.value = 0;
+        return &e.value;
+    }
+
+    u64* dict_insert_word(dict* d, u64 key) {
+        return insert<word_keys>(d, key);
+    }
+
+    u64* dict_find_word(const dict* d, u64 key) {
+        return find<word_keys>(d, key);
+    }
+
+    u64* dict_insert_string(dict* d, const char* key) {
+        return insert<string_keys>(d, u64(key));
+    }
+
+    u64* dict_find_string(const dict* d, const char* key) {
+        return find<string_keys>(d, u64(key));
+    }
+}
@@ -0,0 +1,557 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "sys.h"
+
+// Conversions between floating-point numbers and text for the runtime. Formatting
+// uses Grisu2, which emits a shortest (in all but rare cases) digit string that reads
+// back as the same value. Parsing takes Clinger's fast path when the digits and
+// exponent are small enough for one exact multiply or divide, and otherwise falls
+// back to exact decimal arithmetic, so the result is always correctly rounded.
+
+namespace sys {
+    union float_bits {
+        float f;
+        u32 u;
+    };
+
+    union double_bits {
+        double d;
+        u64 u;
+    };
+
+    /* * * * * * * * * * * * * * * *
+     *                             *
+     *         Formatting          *
+     *                             *
+     * * * * * * * * * * * * * * * */
+
+    struct diyfp {
+        u64 f;
+        i32 e;
+    };
+
+    // Upper 64 bits of the 128-bit product, rounded.
+    static diyfp diy_mul(diyfp x, diyfp y) {
+        u64 a = x.f >> 32, b = x.f & 0xffffffffu, c = y.f >> 32, d = y.f & 0xffffffffu;
+        u64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+        u64 mid = (bd >> 32) + (ad & 0xffffffffu) + (bc & 0xffffffffu) + (1ull << 31);
+        return { ac + (ad >> 32) + (bc >> 32) + (mid >> 32), x.e + y.e + 64 };
+    }
+
+    static diyfp diy_normalize(diyfp x) {
+        while (!(x.f >> 63)) x.f <<= 1, x.e --;
+        return x;
+    }
+
+    // Computes the normalized value of a nonzero float with the given fields, along with
+    // the boundaries of the interval of reals that round to it. All three share an exponent.
+    static void float_boundaries(u64 fraction, i32 biased_exp, u32 mantissa_bits, i32 bias,
+                                 diyfp& minus, diyfp& v, diyfp& plus) {
+        diyfp w = biased_exp ? diyfp{ fraction | 1ull << mantissa_bits, biased_exp - bias }
+                             : diyfp{ fraction, 1 - bias };
+        bool lower_closer = !fraction && biased_exp > 1; // the gap below a power of two is half as wide
+        plus = diy_normalize({ 2 * w.f + 1, w.e - 1 });
+        minus = lower_closer ? diyfp{ 4 * w.f - 1, w.e - 2 } : diyfp{ 2 * w.f - 1, w.e - 1 };
+        minus.f <<= minus.e - plus.e, minus.e = plus.e;
+        v = diy_normalize(w);
+    }
+
+    struct cached_power {
+        u64 f;
+        i32 e, k; // the power is f * 2^e ~= 10^k
+    };
+
+    // Normalized powers of ten from 10^-300 to 10^324, in steps of 8.
+    static const cached_power CACHED_POWERS[] = {
+        { 0xAB70FE17C79AC6CAull, -1060, -300 }, { 0xFF77B1FCBEBCDC4Full, -1034, -292 },
+        { 0xBE5691EF416BD60Cull, -1007, -284 }, { 0x8DD01FAD907FFC3Cull,  -980, -276 },
+        { 0xD3515C2831559A83ull,  -954, -268 }, { 0x9D71AC8FADA6C9B5ull,  -927, -260 },
+        { 0xEA9C227723EE8BCBull,  -901, -252 }, { 0xAECC49914078536Dull,  -874, -244 },
+        { 0x823C12795DB6CE57ull,  -847, -236 }, { 0xC21094364DFB5637ull,  -821, -228 },
+        { 0x9096EA6F3848984Full,  -794, -220 }, { 0xD77485CB25823AC7ull,  -768, -212 },
+        { 0xA086CFCD97BF97F4ull,  -741, -204 }, { 0xEF340A98172AACE5ull,  -715, -196 },
+        { 0xB23867FB2A35B28Eull,  -688, -188 }, { 0x84C8D4DFD2C63F3Bull,  -661, -180 },
+        { 0xC5DD44271AD3CDBAull,  -635, -172 }, { 0x936B9FCEBB25C996ull,  -608, -164 },
+        { 0xDBAC6C247D62A584ull,  -582, -156 }, { 0xA3AB66580D5FDAF6ull,  -555, -148 },
+        { 0xF3E2F893DEC3F126ull,  -529, -140 }, { 0xB5B5ADA8AAFF80B8ull,  -502, -132 },
+        { 0x87625F056C7C4A8Bull,  -475, -124 }, { 0xC9BCFF6034C13053ull,  -449, -116 },
+        { 0x964E858C91BA2655ull,  -422, -108 }, { 0xDFF9772470297EBDull,  -396, -100 },
+        { 0xA6DFBD9FB8E5B88Full,  -369,  -92 }, { 0xF8A95FCF88747D94ull,  -343,  -84 },
+        { 0xB94470938FA89BCFull,  -316,  -76 }, { 0x8A08F0F8BF0F156Bull,  -289,  -68 },
+        { 0xCDB02555653131B6ull,  -263,  -60 }, { 0x993FE2C6D07B7FACull,  -236,  -52 },
+        { 0xE45C10C42A2B3B06ull,  -210,  -44 }, { 0xAA242499697392D3ull,  -183,  -36 },
+        { 0xFD87B5F28300CA0Eull,  -157,  -28 }, { 0xBCE5086492111AEBull,  -130,  -20 },
+        { 0x8CBCCC096F5088CCull,  -103,  -12 }, { 0xD1B71758E219652Cull,   -77,   -4 },
+        { 0x9C40000000000000ull,   -50,    4 }, { 0xE8D4A51000000000ull,   -24,   12 },
+        { 0xAD78EBC5AC620000ull,     3,   20 }, { 0x813F3978F8940984ull,    30,   28 },
+        { 0xC097CE7BC90715B3ull,    56,   36 }, { 0x8F7E32CE7BEA5C70ull,    83,   44 },
+        { 0xD5D238A4ABE98068ull,   109,   52 }, { 0x9F4F2726179A2245ull,   136,   60 },
+        { 0xED63A231D4C4FB27ull,   162,   68 }, { 0xB0DE65388CC8ADA8ull,   189,   76 },
+        { 0x83C7088E1AAB65DBull,   216,   84 }, { 0xC45D1DF942711D9Aull,   242,   92 },
+        { 0x924D692CA61BE758ull,   269,  100 }, { 0xDA01EE641A708DEAull,   295,  108 },
+        { 0xA26DA3999AEF774Aull,   322,  116 }, { 0xF209787BB47D6B85ull,   348,  124 },
+        { 0xB454E4A179DD1877ull,   375,  132 }, { 0x865B86925B9BC5C2ull,   402,  140 },
+        { 0xC83553C5C8965D3Dull,   428,  148 }, { 0x952AB45CFA97A0B3ull,   455,  156 },
+        { 0xDE469FBD99A05FE3ull,   481,  164 }, { 0xA59BC234DB398C25ull,   508,  172 },
+        { 0xF6C69A72A3989F5Cull,   534,  180 }, { 0xB7DCBF5354E9BECEull,   561,  188 },
+        { 0x88FCF317F22241E2ull,   588,  196 }, { 0xCC20CE9BD35C78A5ull,   614,  204 },
+        { 0x98165AF37B2153DFull,   641,  212 }, { 0xE2A0B5DC971F303Aull,   667,  220 },
+        { 0xA8D9D1535CE3B396ull,   694,  228 }, { 0xFB9B7CD9A4A7443Cull,   720,  236 },
+        { 0xBB764C4CA7A44410ull,   747,  244 }, { 0x8BAB8EEFB6409C1Aull,   774,  252 },
+        { 0xD01FEF10A657842Cull,   800,  260 }, { 0x9B10A4E5E9913129ull,   827,  268 },
+        { 0xE7109BFBA19C0C9Dull,   853,  276 }, { 0xAC2820D9623BF429ull,   880,  284 },
+        { 0x80444B5E7AA7CF85ull,   907,  292 }, { 0xBF21E44003ACDD2Dull,   933,  300 },
+        { 0x8E679C2F5E44FF8Full,   960,  308 }, { 0xD433179D9C8CB841ull,   986,  316 },
+        { 0x9E19DB92B4E31BA9ull,  1013,  324 }
+    };
+
+    #define GRISU_ALPHA -60
+
+    // Picks a cached power c such that multiplying by it brings a diyfp with exponent 'e'
+    // into the exponent range [-60, -32], where digit generation can work in 64 bits.
+    static cached_power cached_power_for(i32 e) {
+        i32 f = GRISU_ALPHA - e - 1;
+        i32 k = (f * 78913) / (1 << 18) + (f > 0); // ceil(f * log10(2))
+        return CACHED_POWERS[(300 + k + 7) / 8];
+    }
+
+    static u32 largest_pow10(u32 n, u32& pow10) {
+        u32 digits = 1;
+        for (pow10 = 1; n / pow10 >= 10; pow10 *= 10) digits ++;
+        return digits;
+    }
+
+    // Nudges the last digit down while that brings the result closer to the exact value.
+    static void grisu_round(char* buf, u32 len, u64 dist, u64 delta, u64 rest, u64 ten_k) {
+        while (rest < dist && delta - rest >= ten_k
+            && (rest + ten_k < dist || dist - rest > rest + ten_k - dist)) {
+            buf[len - 1] --;
+            rest += ten_k;
+        }
+    }
+
+    // Generates as few digits as possible such that digits * 10^exp10 lies in [minus, plus].
+    static u32 grisu_digits(char* buf, i32& exp10, diyfp minus, diyfp w, diyfp plus) {
+        u64 delta = plus.f - minus.f, dist = plus.f - w.f;
+        u32 shift = -plus.e;
+        u64 one = 1ull << shift;
+        u32 p1 = plus.f >> shift; // integral part
+        u64 p2 = plus.f & (one - 1); // fractional part
+        u32 pow10, len = 0;
+        for (u32 n = largest_pow10(p1, pow10); n > 0; pow10 /= 10) {
+            buf[len ++] = '0' + p1 / pow10;
+            p1 %= pow10;
+            n --;
+            u64 rest = ((u64)p1 << shift) + p2;
+            if (rest <= delta) {
+                exp10 += n;
+                grisu_round(buf, len, dist, delta, rest, (u64)pow10 << shift);
+                return len;
+            }
+        }
+        i32 m = 0;
+        do {
+            p2 *= 10;
+            buf[len ++] = '0' + (p2 >> shift);
+            p2 &= one - 1;
+            m ++;
+            delta *= 10, dist *= 10;
+        } while (p2 > delta);
+        exp10 -= m;
+        grisu_round(buf, len, dist, delta, p2, one);
+        return len;
+    }
+
+    static u32 grisu2(char* buf, i32& exp10, diyfp minus, diyfp v, diyfp plus) {
+        cached_power c = cached_power_for(plus.e);
+        diyfp ck = { c.f, c.e };
+        diyfp w = diy_mul(v, ck), w_minus = diy_mul(minus, ck), w_plus = diy_mul(plus, ck);
+        exp10 = -c.k;
+        // shrink the interval by one unit on each side to stay inside it despite rounding
+        return grisu_digits(buf, exp10, { w_minus.f + 1, w_minus.e }, w, { w_plus.f - 1, w_plus.e });
+    }
+
+    // Lays out digits * 10^exp10 in place. Magnitudes in [1e-4, 1e16) are written in
+    // fixed notation and everything else in scientific notation, always with at least
+    // one digit after the point.
+    static u32 layout_digits(char* buf, u32 len, i32 exp10) {
+        i32 point = len + exp10; // position of the decimal point within the digits
+        if (point > 0 && point <= 16) {
+            if (exp10 >= 0) {
+                for (i32 i = 0; i < exp10; i ++) buf[len ++] = '0';
+                buf[len ++] = '.', buf[len ++] = '0';
+                return len;
+            }
+            _sys_memmove(buf + point + 1, buf + point, len - point);
+            buf[point] = '.';
+            return len + 1;
+        }
+        if (point <= 0 && point > -4) {
+            u32 prefix = 2 - point; // "0." and any zeroes before the first digit
+            _sys_memmove(buf + prefix, buf, len);
+            buf[0] = '0', buf[1] = '.';
+            for (u32 i = 2; i < prefix; i ++) buf[i] = '0';
+            return len + prefix;
+        }
+
+        _sys_memmove(buf + 2, buf + 1, len - 1);
+        buf[1] = '.';
+        if (len == 1) buf[2] = '0', len ++;
+        len ++;
+        buf[len ++] = 'e';
+        i32 e = point - 1;
+        if (e < 0) buf[len ++] = '-', e = -e;
+        u32 width = e >= 100 ? 3 : e >= 10 ? 2 : 1;
+        for (u32 i = width; i > 0; i --) buf[len + i - 1] = '0' + e % 10, e /= 10;
+        return len + width;
+    }
+
+    static u32 format_bits(char* buf, bool neg, u64 fraction, i32 biased_exp,
+                           u32 mantissa_bits, i32 max_exp, i32 bias) {
+        u32 n = 0;
+        if (biased_exp == max_exp && fraction) {
+            buf[0] = 'n', buf[1] = 'a', buf[2] = 'n';
+            return 3;
+        }
+        if (neg) buf[n ++] = '-';
+        if (biased_exp == max_exp) {
+            buf[n] = 'i', buf[n + 1] = 'n', buf[n + 2] = 'f';
+            return n + 3;
+        }
+        if (!fraction && !biased_exp) {
+            buf[n] = '0', buf[n + 1] = '.', buf[n + 2] = '0';
+            return n + 3;
+        }
+
+        diyfp minus, v, plus;
+        float_boundaries(fraction, biased_exp, mantissa_bits, bias, minus, v, plus);
+        i32 exp10;
+        u32 len = grisu2(buf + n, exp10, minus, v, plus);
+        return n + layout_digits(buf + n, len, exp10);
+    }
+
+    u32 format_float(char* buf, float f) {
+        float_bits b;
+        b.f = f;
+        return format_bits(buf, b.u >> 31, b.u & 0x7fffff, (b.u >> 23) & 0xff, 23, 0xff, 150);
+    }
+
+    u32 format_double(char* buf, double d) {
+        double_bits b;
+        b.d = d;
+        return format_bits(buf, b.u >> 63, b.u & 0xfffffffffffffull, (b.u >> 52) & 0x7ff, 52, 0x7ff, 1075);
+    }
+
+    /* * * * * * * * * * * * * * * *
+     *                             *
+     *           Parsing           *
+     *                             *
+     * * * * * * * * * * * * * * * */
+
+    static const double EXACT_POWERS[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    #define DECIMAL_DIGITS 800
+    #define MAX_SHIFT 60 // the most we can shift a digit (or running remainder) within a u64
+
+    // An arbitrary-precision decimal 0.d[0]d[1]...d[nd - 1] * 10^dp, with digits stored
+    // as values rather than characters. 'trunc' is set if nonzero digits were dropped.
+    struct decimal {
+        u8 d[DECIMAL_DIGITS];
+        i32 nd, dp;
+        bool trunc;
+    };
+
+    static void trim(decimal& a) {
+        while (a.nd > 0 && !a.d[a.nd - 1]) a.nd --;
+        if (!a.nd) a.dp = 0;
+    }
+
+    // Multiplies by 2^k. Digits are produced from the least significant end into a
+    // scratch buffer, so we don't need to know up front how many there will be.
+    static void left_shift(decimal& a, u32 k) {
+        u8 tmp[DECIMAL_DIGITS + 20];
+        u32 w = sizeof(tmp);
+        u64 n = 0;
+        for (i32 r = a.nd - 1; r >= 0; r --) {
+            n += (u64)a.d[r] << k;
+            tmp[-- w] = n % 10;
+            n /= 10;
+        }
+        while (n) tmp[-- w] = n % 10, n /= 10;
+
+        u32 produced = sizeof(tmp) - w, kept = produced < DECIMAL_DIGITS ? produced : DECIMAL_DIGITS;
+        for (u32 i = 0; i < kept; i ++) a.d[i] = tmp[w + i];
+        for (u32 i = kept; i < produced; i ++) if (tmp[w + i]) a.trunc = true;
+        a.dp += produced - a.nd;
+        a.nd = kept;
+        trim(a);
+    }
+
+    // Divides by 2^k, by long division from the most significant digit.
+    static void right_shift(decimal& a, u32 k) {
+        i32 r = 0, w = 0;
+        u64 n = 0;
+        for (; !(n >> k); r ++) { // pick up enough leading digits to cover the first shift
+            if (r >= a.nd) {
+                if (!n) {
+                    a.nd = 0;
+                    return;
+                }
+                while (!(n >> k)) n *= 10, r ++;
+                break;
+            }
+            n = n * 10 + a.d[r];
+        }
+        a.dp -= r - 1;
+
+        u64 mask = (1ull << k) - 1;
+        for (; r < a.nd; r ++) {
+            u8 c = a.d[r];
+            a.d[w ++] = n >> k;
+            n = (n & mask) * 10 + c;
+        }
+        while (n) {
+            u8 digit = n >> k;
+            if (w < DECIMAL_DIGITS) a.d[w ++] = digit;
+            else if (digit) a.trunc = true;
+            n = (n & mask) * 10;
+        }
+        a.nd = w;
+        trim(a);
+    }
+
+    static void shift(decimal& a, i32 k) {
+        if (!a.nd) return;
+        for (; k > MAX_SHIFT; k -= MAX_SHIFT) left_shift(a, MAX_SHIFT);
+        for (; k < -MAX_SHIFT; k += MAX_SHIFT) right_shift(a, MAX_SHIFT);
+        if (k > 0) left_shift(a, k);
+        else if (k < 0) right_shift(a, -k);
+    }
+
+    // Whether truncating to 'nd' digits should round up, with ties going to even.
+    static bool should_round_up(const decimal& a, i32 nd) {
+        if (nd < 0 || nd >= a.nd) return false;
+        if (a.d[nd] == 5 && nd + 1 == a.nd) { // exactly halfway, as far as we know
+            if (a.trunc) return true;
+            return nd > 0 && a.d[nd - 1] % 2 == 1;
+        }
+        return a.d[nd] >= 5;
+    }
+
+    static u64 rounded_integer(const decimal& a) {
+        if (a.dp > 20) return 0xffffffffffffffffull;
+        u64 n = 0;
+        i32 i = 0;
+        for (; i < a.dp && i < a.nd; i ++) n = n * 10 + a.d[i];
+        for (; i < a.dp; i ++) n *= 10;
+        if (should_round_up(a, a.dp)) n ++;
+        return n;
+    }
+
+    // How far we can shift a decimal with 'dp' integer digits without going below one.
+    static const i32 POWTAB[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };
+
+    // Rounds the decimal to the nearest float with the given layout. 'bias' is the
+    // exponent of the smallest normal number, less one (-1023 for doubles).
+    static u64 decimal_to_bits(decimal& a, bool neg, u32 mantissa_bits, u32 exp_bits, i32 bias) {
+        i32 exp = bias, max_exp = (1 << exp_bits) - 1;
+        u64 mant = 0;
+        bool overflow = false;
+        if (a.nd && a.dp > 310) overflow = true;
+        else if (a.nd && a.dp >= -330) {
+            // scale by powers of two until the decimal is within [0.5, 1)
+            exp = 0;
+            while (a.dp > 0) {
+                i32 n = a.dp >= 9 ? 27 : POWTAB[a.dp];
+                shift(a, -n);
+                exp += n;
+            }
+            while (a.dp < 0 || (a.dp == 0 && a.d[0] < 5)) {
+                i32 n = -a.dp >= 9 ? 27 : POWTAB[-a.dp];
+                shift(a, n);
+                exp -= n;
+            }
+            exp --; // floats are within [1, 2) instead
+
+            if (exp < bias + 1) { // denormal
+                i32 n = bias + 1 - exp;
+                shift(a, -n);
+                exp += n;
+            }
+            if (exp - bias >= max_exp) overflow = true;
+            else {
+                shift(a, 1 + mantissa_bits);
+                mant = rounded_integer(a);
+                if (mant == 2ull << mantissa_bits) { // rounding carried into a new bit
+                    mant >>= 1;
+                    if (++ exp - bias >= max_exp) overflow = true;
+                }
+                if (!(mant & 1ull << mantissa_bits)) exp = bias;
+            }
+        }
+        if (overflow) mant = 0, exp = max_exp + bias;
+
+        u64 bits = mant & ((1ull << mantissa_bits) - 1);
+        bits |= (u64)((exp - bias) & max_exp) << mantissa_bits;
+        if (neg) bits |= 1ull << (mantissa_bits + exp_bits);
+        return bits;
+    }
+
+    static bool is_digit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    static bool starts_with(const char* s, u32 n, const char* word) {
+        u32 i = 0;
+        for (; word[i]; i ++) if (i >= n || (s[i] | 0x20) != word[i]) return false;
+        return true;
+    }
+
+    struct float_layout {
+        u32 mantissa_bits, exp_bits;
+        i32 bias;
+        u64 max_exact; // largest mantissa that converts exactly
+        i32 max_exact_pow; // largest power of ten that converts exactly
+    };
+
+    static const float_layout FLOAT_LAYOUT = { 23, 8, -127, 1ull << 24, 10 };
+    static const float_layout DOUBLE_LAYOUT = { 52, 11, -1023, 1ull << 53, 22 };
+
+    // Parses a decimal number with an optional sign, point and exponent, or 'inf'/'infinity'
+    // or 'nan', producing the bits of the nearest float with the given layout. The exact
+    // fast path is computed in double precision, which is also exact for floats.
+    static u32 parse_bits(const char* s, u32 n, const float_layout& fmt, u64& bits, double& fast, bool& is_fast) {
+        u32 i = 0;
+        bool neg = false;
+        is_fast = false;
+        if (i < n && (s[i] == '-' || s[i] == '+')) neg = s[i ++] == '-';
+        u64 sign = (u64)neg << (fmt.mantissa_bits + fmt.exp_bits);
+        u64 infinity = (((1ull << fmt.exp_bits) - 1) << fmt.mantissa_bits);
+        if (starts_with(s + i, n - i, "inf")) {
+            bits = sign | infinity;
+            return i + (starts_with(s + i, n - i, "infinity") ? 8 : 3);
+        }
+        if (starts_with(s + i, n - i, "nan")) {
+            bits = infinity | 1ull << (fmt.mantissa_bits - 1);
+            return i + 3;
+        }
+
+        // gather up to 19 significant digits, which always fit in a u64
+        u32 start = i;
+        u64 m = 0;
+        i32 digits = 0, exp10 = 0;
+        bool point = false, any = false, trunc = false;
+        for (; i < n; i ++) {
+            char c = s[i];
+            if (c == '.' && !point) {
+                point = true;
+                continue;
+            }
+            if (!is_digit(c)) break;
+            any = true;
+            if (c == '0' && !digits) { // leading zero
+                if (point) exp10 --;
+                continue;
+            }
+            if (digits < 19) {
+                m = m * 10 + (c - '0'), digits ++;
+                if (point) exp10 --;
+            }
+            else {
+                if (c != '0') trunc = true;
+                if (!point) exp10 ++;
+            }
+        }
+        if (!any) return 0;
+        u32 end = i;
+
+        i32 explicit_exp = 0;
+        if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+            u32 j = i + 1;
+            bool eneg = false;
+            if (j < n && (s[j] == '-' || s[j] == '+')) eneg = s[j ++] == '-';
+            if (j < n && is_digit(s[j])) {
+                for (; j < n && is_digit(s[j]); j ++)
+                    if (explicit_exp < 100000) explicit_exp = explicit_exp * 10 + (s[j] - '0');
+                if (eneg) explicit_exp = -explicit_exp;
+                exp10 += explicit_exp;
+                i = j;
+            }
+        }
+
+        if (!trunc && !m) {
+            bits = sign;
+            return i;
+        }
+        if (!trunc && m <= fmt.max_exact && exp10 >= -fmt.max_exact_pow && exp10 <= fmt.max_exact_pow) {
+            fast = exp10 < 0 ? double(m) / EXACT_POWERS[-exp10] : double(m) * EXACT_POWERS[exp10];
+            if (neg) fast = -fast;
+            is_fast = true;
+            return i;
+        }
+
+        // every significant digit before the point counts toward the magnitude, including
+        // the ones past DECIMAL_DIGITS that we can't store
+        decimal a;
+        a.nd = a.dp = 0, a.trunc = false;
+        point = false;
+        for (u32 j = start; j < end; j ++) {
+            if (s[j] == '.') {
+                point = true;
+                continue;
+            }
+            u8 c = s[j] - '0';
+            if (!c && !a.nd) { // leading zero
+                if (point) a.dp --;
+                continue;
+            }
+            if (!point) a.dp ++;
+            if (a.nd < DECIMAL_DIGITS) a.d[a.nd ++] = c;
+            else if (c) a.trunc = true;
+        }
+        a.dp += explicit_exp;
+        trim(a);
+        bits = decimal_to_bits(a, neg, fmt.mantissa_bits, fmt.exp_bits, fmt.bias);
+        return i;
+    }
+
+    u32 parse_float(const char* s, u32 n, float& f) {
+        u64 bits;
+        double fast;
+        bool is_fast;
+        u32 used = parse_bits(s, n, FLOAT_LAYOUT, bits, fast, is_fast);
+        if (!used) return 0;
+        if (is_fast) f = fast;
+        else {
+            float_bits b;
+            b.u = bits;
+            f = b.f;
+        }
+        return used;
+    }
+
+    u32 parse_double(const char* s, u32 n, double& d) {
+        u64 bits;
+        double fast;
+        bool is_fast;
+        u32 used = parse_bits(s, n, DOUBLE_LAYOUT, bits, fast, is_fast);
+        if (!used) return 0;
+        if (is_fast) d = fast;
+        else {
+            double_bits b;
+            b.u = bits;
+            d = b.d;
+        }
+        return used;
+    }
+}
@@ -0,0 +1,126 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "sys.h"
+
+// Operations on runtime strings. Lengths come from the prefix, so nothing here scans
+// for the terminator, and the bulk work is done by the vectorized memory routines.
+
+#if defined(_MSC_VER)
+    typedef u64 string_word;
+#else
+    typedef u64 __attribute__((may_alias, aligned(1))) string_word;
+#endif
+
+namespace sys {
+    u32 string_length(const char* s) {
+        return *(const u32*)(s - 4) - 1;
+    }
+
+    // Reserves a string of 'n' bytes, already terminated since alloc() zeroes memory.
+    static char* reserve(u32 n) {
+        char* s = (char*)alloc(n + 5) + 4;
+        *(u32*)(s - 4) = n + 1;
+        return s;
+    }
+
+    const char* string_new(const char* bytes, u32 n) {
+        if (!n) return empty_string;
+        char* s = reserve(n);
+        _sys_memcpy(s, bytes, n);
+        return s;
+    }
+
+    const char* string_concat(const char* a, const char* b) {
+        u32 m = string_length(a), n = string_length(b);
+        if (!m) return b;
+        if (!n) return a;
+        char* s = reserve(m + n);
+        _sys_memcpy(s, a, m);
+        _sys_memcpy(s + m, b, n);
+        return s;
+    }
+
+    // Bounds are clamped to the string, so out-of-range slices are just shorter.
+    const char* string_slice(const char* s, i64 start, i64 end) {
+        i64 n = string_length(s);
+        if (start < 0) start = 0;
+        if (end > n) end = n;
+        if (start == 0 && end == n) return s;
+        if (start >= end) return empty_string;
+        return string_new(s + start, end - start);
+    }
+
+    // Counts the code points in a string, taking whole words of ASCII at a time.
+    u32 string_chars(const char* s) {
+        const u8* p = (const u8*)s;
+        u32 n = string_length(s), count = 0, i = 0;
+        for (; i + 8 <= n; i += 8) {
+            if (!(*(const string_word*)(p + i) & 0x8080808080808080ull)) count += 8;
+            else for (u32 j = i; j < i + 8; j ++) count += (p[j] & 0xc0) != 0x80;
+        }
+        for (; i < n; i ++) count += (p[i] & 0xc0) != 0x80;
+        return count;
+    }
+
+    // Finds the byte offset of the i'th code point in the first 'n' bytes of 's', or 'n' if
+    // there are fewer than that.
+    static u32 char_offset(const u8* p, u32 n, i64 i) {
+        u32 at = 0;
+        while (at < n) {
+            if (i >= 8 && at + 8 <= n && !(*(const string_word*)(p + at) & 0x8080808080808080ull)) {
+                at += 8, i -= 8;
+                continue;
+            }
+            if ((p[at] & 0xc0) != 0x80) {
+                if (!i) return at;
+                i --;
+            }
+            at ++;
+        }
+        return n;
+    }
+
+    // Same as string_slice, but the bounds count code points rather than bytes.
+    const char* string_slice_chars(const char* s, i64 start, i64 end) {
+        if (start < 0) start = 0;
+        if (start >= end) return empty_string;
+        u32 n = string_length(s), from = char_offset((const u8*)s, n, start);
+        u32 to = from + char_offset((const u8*)s + from, n - from, end - start);
+        return string_slice(s, from, to);
+    }
+
+    // Orders strings by their bytes, with a prefix ordered before anything it starts.
+    i64 string_compare(const char* a, const char* b) {
+        if (a == b) return 0;
+        u32 m = string_length(a), n = string_length(b);
+        i64 diff = _sys_memcmp(a, b, m < n ? m : n);
+        return diff ? diff : i64(m) - i64(n);
+    }
+
+    bool string_equal(const char* a, const char* b) {
+        if (a == b) return true;
+        u32 n = string_length(a);
+        return n == string_length(b) && _sys_memcmp(a, b, n) == 0;
+    }
+
+    // Hashes a word at a time, then folds in the remaining bytes.
+    u64 string_hash(const char* s) {
+        const u8* p = (const u8*)s;
+        u32 n = string_length(s);
+        u64 h = n * 0x9e3779b97f4a7c15ull;
+        for (; n >= 8; p += 8, n -= 8) {
+            h ^= *(const string_word*)p * 0xff51afd7ed558ccdull;
+            h = (h << 31 | h >> 33) * 0xc4ceb9fe1a85ec53ull;
+        }
+        u64 tail = 0;
+        for (u32 i = 0; i < n; i ++) tail |= u64(p[i]) << i * 8;
+        return hash_word(h ^ tail);
+    }
+}
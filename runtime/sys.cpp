@@ -217,10 +217,384 @@ extern "C" i64 _sys_close(i64 fd) {
     #endif
 }
 
+extern "C" i64 _sys_lseek(i64 fd, i64 offset, i64 whence) {
+    #if defined(BASIL_UNIX)
+        #if defined(BASIL_MACOS)
+            #define LSEEK_CODE "0x20000C7"
+        #elif defined(BASIL_LINUX)
+            #define LSEEK_CODE "8"
+        #endif
+
+        i64 ret = 0;
+        asm volatile (
+            "mov $" LSEEK_CODE ", %%rax\n\t"
+            "syscall\n\t"
+            : "=a" (ret)
+            : "D" (fd), "S" (offset), "d" (whence)
+            : "rcx", "r11", "memory"
+        );
+        return ret;
+    #elif defined(BASIL_WINDOWS)
+        LARGE_INTEGER dist, pos;
+        dist.QuadPart = offset;
+        if (!SetFilePointerEx((HANDLE)fd, dist, &pos, (DWORD)whence)) return -1;
+        return pos.QuadPart;
+    #endif
+}
+
+// Maps 'len' bytes of the file 'fd' read-only at exactly 'addr'. Returns false if
+// the file couldn't be mapped, in which case callers should fall back to reading it.
+extern "C" bool _sys_mmap_file(void* addr, u64 len, i64 fd) {
+    #if defined(BASIL_UNIX)
+        #define MAP_FIXED 0x10
+        register i64 file asm("r8") = fd;
+        u64 ret;
+        asm volatile (
+            "mov $" MMAP_CODE ", %%rax\n\t"
+            "mov %%rcx, %%r10\n\t"
+            "xor %%r9, %%r9\n\t"
+            "syscall\n\t"
+            : "=a" (ret)
+            : "D" (addr), "S" (len), "d" (PROT_READ), "c" (MAP_PRIVATE | MAP_FIXED), "r" (file)
+            : "r9", "r10", "r11", "memory"
+        );
+        return ret == (u64)addr;
+    #elif defined(BASIL_WINDOWS)
+        return false; // views can't be placed into an existing allocation on Windows
+    #endif
+}
+
+struct _sys_iovec {
+    const void* base;
+    u64 len;
+};
+
+extern "C" i64 _sys_writev(u64 fd, const _sys_iovec* iov, u64 n) {
+    #if defined(BASIL_UNIX)
+        #if defined(BASIL_MACOS)
+            #define WRITEV_CODE "0x2000079"
+        #elif defined(BASIL_LINUX)
+            #define WRITEV_CODE "20"
+        #endif
+
+        i64 ret = 0;
+        asm volatile (
+            "mov $" WRITEV_CODE ", %%rax\n\t"
+            "syscall\n\t"
+            : "=a" (ret)
+            : "D" (fd), "S" (iov), "d" (n)
+            : "rcx", "r11", "memory"
+        );
+        return ret;
+    #elif defined(BASIL_WINDOWS)
+        i64 total = 0;
+        for (u64 i = 0; i < n; i ++) {
+            i64 amt = _sys_write(fd, (const char*)iov[i].base, iov[i].len);
+            if (amt < 0) return total ? total : amt;
+            total += amt;
+            if ((u64)amt < iov[i].len) break;
+        }
+        return total;
+    #endif
+}
+
+extern "C" bool _sys_isatty(u64 fd) {
+    #if defined(BASIL_UNIX)
+        #if defined(BASIL_MACOS)
+            #define IOCTL_CODE "0x2000036"
+            #define TERMINAL_ATTRS 0x40487413 // TIOCGETA
+        #elif defined(BASIL_LINUX)
+            #define IOCTL_CODE "16"
+            #define TERMINAL_ATTRS 0x5401 // TCGETS
+        #endif
+
+        // fetching terminal attributes only succeeds on terminals
+        u64 termios[16];
+        i64 ret = 0;
+        asm volatile (
+            "mov $" IOCTL_CODE ", %%rax\n\t"
+            "syscall\n\t"
+            : "=a" (ret)
+            : "D" (fd), "S" (TERMINAL_ATTRS), "d" (termios)
+            : "rcx", "r11", "memory"
+        );
+        return ret == 0;
+    #elif defined(BASIL_WINDOWS)
+        return GetFileType((HANDLE)fd) == FILE_TYPE_CHAR;
+    #endif
+}
+
+/* * * * * * * * * * * * * * * *
+ *                             *
+ *      Memory Primitives      *
+ *                             *
+ * * * * * * * * * * * * * * * */
+
+// The runtime doesn't link against libc, so it brings its own block memory routines.
+// Vector copies are done in inline assembly that keeps everything in registers, so
+// short copies never spill to the stack, and everything else works on 8-byte words.
+// AVX2 and 'rep movsb'/'rep stosb' for large blocks are enabled by _sys_detect_cpu().
+
+#if defined(_MSC_VER)
+    #include "intrin.h"
+    typedef u64 _sys_word; // MSVC permits unaligned and type-punned loads on x86-64
+#else
+    #define VECTOR_ASM // MSVC has no inline assembly on x86-64, so it sticks to words
+    typedef u64 __attribute__((may_alias, aligned(1))) _sys_word;
+#endif
+
+#define REP_STRING_THRESHOLD 2048
+#define ONES 0x0101010101010101ull
+#define HIGHS 0x8080808080808080ull
+
+static bool _sys_has_avx2 = false, _sys_has_erms = false;
+
+static void _sys_cpuid(u32 leaf, u32 subleaf, u32* regs) {
+    #if defined(_MSC_VER)
+        __cpuidex((int*)regs, leaf, subleaf);
+    #else
+        asm volatile (
+            "cpuid"
+            : "=a" (regs[0]), "=b" (regs[1]), "=c" (regs[2]), "=d" (regs[3])
+            : "a" (leaf), "c" (subleaf)
+        );
+    #endif
+}
+
+extern "C" void _sys_detect_cpu() {
+    u32 regs[4];
+    _sys_cpuid(0, 0, regs);
+    if (regs[0] < 7) return; // no extended feature leaf
+
+    _sys_cpuid(1, 0, regs);
+    bool avx = regs[2] & (1 << 28), osxsave = regs[2] & (1 << 27);
+    u64 xcr0 = 0;
+    if (osxsave) { // the OS must also save ymm state for us to use AVX
+        #if defined(_MSC_VER)
+            xcr0 = _xgetbv(0);
+        #else
+            u32 lo, hi;
+            asm volatile ("xgetbv" : "=a" (lo), "=d" (hi) : "c" (0));
+            xcr0 = lo | (u64)hi << 32;
+        #endif
+    }
+
+    _sys_cpuid(7, 0, regs);
+    _sys_has_avx2 = avx && (xcr0 & 6) == 6 && (regs[1] & (1 << 5));
+    _sys_has_erms = regs[1] & (1 << 9);
+}
+
+static inline u64 _sys_load(const void* p) {
+    return *(const _sys_word*)p;
+}
+
+static inline void _sys_store(void* p, u64 w) {
+    *(_sys_word*)p = w;
+}
+
+// Nonzero if any byte of 'w' is zero; the lowest set high bit marks the first one.
+static inline u64 _sys_zero_bytes(u64 w) {
+    return (w - ONES) & ~w & HIGHS;
+}
+
+static inline u32 _sys_ctz64(u64 n) {
+    #if defined(_MSC_VER)
+        unsigned long i;
+        _BitScanForward64(&i, n);
+        return i;
+    #else
+        return __builtin_ctzll(n);
+    #endif
+}
+
+// Copies at most 16 bytes. Both words are loaded before either is stored, and the
+// byte loop picks its direction, so overlapping ranges are fine.
+static inline void _sys_copy_small(u8* d, const u8* s, u64 n) {
+    if (n >= 8) {
+        u64 head = _sys_load(s), tail = _sys_load(s + n - 8);
+        _sys_store(d, head), _sys_store(d + n - 8, tail);
+    }
+    else if (d <= s) for (u64 i = 0; i < n; i ++) d[i] = s[i];
+    else for (u64 i = n; i > 0; i --) d[i - 1] = s[i - 1];
+}
+
+// Copies more than 16 bytes front to back. The last block is loaded up front and
+// stored last, and every other store lands below the next load, so this also
+// handles overlapping moves where d < s.
+static void _sys_copy_forward(u8* d, const u8* s, u64 n) {
+    #if defined(VECTOR_ASM)
+        u8* end;
+        if (_sys_has_avx2 && n > 32) asm volatile (
+            "vmovdqu -32(%[s], %[n]), %%ymm1\n\t"
+            "lea -32(%[d], %[n]), %[end]\n\t"
+            "1:\n\t"
+            "vmovdqu (%[s]), %%ymm0\n\t"
+            "vmovdqu %%ymm0, (%[d])\n\t"
+            "add $32, %[s]\n\t"
+            "add $32, %[d]\n\t"
+            "cmp %[end], %[d]\n\t"
+            "jb 1b\n\t"
+            "vmovdqu %%ymm1, (%[end])\n\t"
+            "vzeroupper\n\t"
+            : [d] "+r" (d), [s] "+r" (s), [end] "=&r" (end)
+            : [n] "r" (n)
+            : "xmm0", "xmm1", "cc", "memory"
+        );
+        else asm volatile (
+            "movdqu -16(%[s], %[n]), %%xmm1\n\t"
+            "lea -16(%[d], %[n]), %[end]\n\t"
+            "1:\n\t"
+            "movdqu (%[s]), %%xmm0\n\t"
+            "movdqu %%xmm0, (%[d])\n\t"
+            "add $16, %[s]\n\t"
+            "add $16, %[d]\n\t"
+            "cmp %[end], %[d]\n\t"
+            "jb 1b\n\t"
+            "movdqu %%xmm1, (%[end])\n\t"
+            : [d] "+r" (d), [s] "+r" (s), [end] "=&r" (end)
+            : [n] "r" (n)
+            : "xmm0", "xmm1", "cc", "memory"
+        );
+    #else
+        u64 tail = _sys_load(s + n - 8);
+        for (u64 i = 0; i < n - 8; i += 8) _sys_store(d + i, _sys_load(s + i));
+        _sys_store(d + n - 8, tail);
+    #endif
+}
+
+// Mirror image of _sys_copy_forward(), for overlapping moves where d > s.
+static void _sys_copy_backward(u8* d, const u8* s, u64 n) {
+    #if defined(VECTOR_ASM)
+        asm volatile (
+            "movdqu (%[s]), %%xmm1\n\t"
+            "1:\n\t"
+            "sub $16, %[n]\n\t"
+            "movdqu (%[s], %[n]), %%xmm0\n\t"
+            "movdqu %%xmm0, (%[d], %[n])\n\t"
+            "cmp $16, %[n]\n\t"
+            "ja 1b\n\t"
+            "movdqu %%xmm1, (%[d])\n\t"
+            : [n] "+r" (n)
+            : [d] "r" (d), [s] "r" (s)
+            : "xmm0", "xmm1", "cc", "memory"
+        );
+    #else
+        u64 head = _sys_load(s);
+        while (n > 8) n -= 8, _sys_store(d + n, _sys_load(s + n));
+        _sys_store(d, head);
+    #endif
+}
+
+static inline void _sys_rep_movsb(u8* d, const u8* s, u64 n) {
+    #if defined(_MSC_VER)
+        __movsb(d, s, n);
+    #else
+        asm volatile ("rep movsb" : "+D" (d), "+S" (s), "+c" (n) : : "memory");
+    #endif
+}
+
 extern "C" i64 _sys_memcpy(void* dst, const void* src, size_t size) {
-    i64 i = 0;
-    while (i < size) ((u8*)dst)[i] = ((u8*)src)[i], i ++;
-    return i;
+    u8* d = (u8*)dst;
+    const u8* s = (const u8*)src;
+    if (size <= 16) _sys_copy_small(d, s, size);
+    else if (size >= REP_STRING_THRESHOLD && _sys_has_erms) _sys_rep_movsb(d, s, size);
+    else _sys_copy_forward(d, s, size);
+    return size;
+}
+
+extern "C" void* _sys_memmove(void* dst, const void* src, size_t size) {
+    u8* d = (u8*)dst;
+    const u8* s = (const u8*)src;
+    if (d + size <= s || s + size <= d) _sys_memcpy(d, s, size);
+    else if (size <= 16) _sys_copy_small(d, s, size);
+    else if (d < s) _sys_copy_forward(d, s, size);
+    else if (d > s) _sys_copy_backward(d, s, size);
+    return dst;
+}
+
+extern "C" void* _sys_memset(void* dst, u8 c, size_t size) {
+    u8* d = (u8*)dst;
+    u64 n = size;
+    if (n < 8) {
+        for (u64 i = 0; i < n; i ++) d[i] = c;
+        return dst;
+    }
+    if (n >= REP_STRING_THRESHOLD && _sys_has_erms) {
+        #if defined(_MSC_VER)
+            __stosb(d, c, n);
+        #else
+            asm volatile ("rep stosb" : "+D" (d), "+c" (n) : "a" (c) : "memory");
+        #endif
+        return dst;
+    }
+    u64 w = c * ONES;
+    _sys_store(d, w);
+    for (u8* p = (u8*)((u64)(d + 8) & ~u64(7)); p < d + n - 8; p += 8) _sys_store(p, w);
+    _sys_store(d + n - 8, w);
+    return dst;
+}
+
+// memchr and strlen scan aligned words once they're past the first few bytes. An
+// aligned word never straddles a page, so we may read a little past the end of the
+// range without risking a fault.
+extern "C" const void* _sys_memchr(const void* src, u8 c, size_t size) {
+    const u8* p = (const u8*)src;
+    const u8* end = p + size;
+    for (; p < end && ((u64)p & 7); p ++) if (*p == c) return p;
+
+    u64 pattern = c * ONES;
+    for (; p < end; p += 8) {
+        u64 found = _sys_zero_bytes(_sys_load(p) ^ pattern);
+        if (found) {
+            p += _sys_ctz64(found) / 8;
+            return p < end ? p : nullptr;
+        }
+    }
+    return nullptr;
+}
+
+extern "C" i64 _sys_strlen(const char* str) {
+    const char* p = str;
+    for (; (u64)p & 7; p ++) if (!*p) return p - str;
+
+    u64 found;
+    while (!(found = _sys_zero_bytes(_sys_load(p)))) p += 8;
+    return p + _sys_ctz64(found) / 8 - str;
+}
+
+// Compares 16 bytes at a time with SSE2, which every x86-64 processor has, then finds
+// the first differing byte within the last word. Like the copies above, the vector
+// compare stays in inline assembly and in registers.
+extern "C" i64 _sys_memcmp(const void* a, const void* b, size_t size) {
+    const u8 *x = (const u8*)a, *y = (const u8*)b;
+    u64 i = 0;
+    #if defined(VECTOR_ASM)
+        for (; i + 16 <= size; i += 16) {
+            u32 same;
+            asm volatile (
+                "movdqu (%[x]), %%xmm0\n\t"
+                "movdqu (%[y]), %%xmm1\n\t"
+                "pcmpeqb %%xmm1, %%xmm0\n\t"
+                "pmovmskb %%xmm0, %[same]\n\t"
+                : [same] "=r" (same)
+                : [x] "r" (x + i), [y] "r" (y + i)
+                : "xmm0", "xmm1", "memory"
+            );
+            if (same != 0xffff) {
+                i += _sys_ctz64(~same & 0xffff);
+                return i64(x[i]) - i64(y[i]);
+            }
+        }
+    #endif
+    for (; i + 8 <= size; i += 8) {
+        u64 diff = _sys_load(x + i) ^ _sys_load(y + i);
+        if (diff) {
+            i += _sys_ctz64(diff) / 8;
+            return i64(x[i]) - i64(y[i]);
+        }
+    }
+    for (; i < size; i ++) if (x[i] != y[i]) return i64(x[i]) - i64(y[i]);
+    return 0;
 }
 
 namespace sys {
@@ -228,44 +602,118 @@ namespace sys {
     #include "util/utf8.cpp" // embed subset of utf8 features in sys
     #undef UTF8_MINIMAL
 
-    #define STREAMBUF_SIZE 16368
+    // _sys_mmap() returns a negated error code on failure on Unix, and null on Windows.
+    static bool mmap_failed(const void* p) {
+        return !p || u64(p) > u64(-4096);
+    }
+
+    #define STREAM_SLAB 65536 // buffers are carved out of mappings this large
+    #define STREAM_CHUNK 128 // stream headers are allocated this many at a time
     #define N_STREAMS 65536
 
     struct stream {
         i32 fd;
-        u32 start, end, unused;
-        char buf[STREAMBUF_SIZE];
+        u32 start, end, cap, line_buffered;
+        i32 next_free; // next closed handle, while this one is closed
+        char* buf;
     };
 
-    static stream* _sys_streams[N_STREAMS];
+    static_assert(sizeof(stream) * STREAM_CHUNK == BASIL_STREAMBUF_SMALL);
+
+    // Streams are named by dense handles, which index into chunks of headers that are
+    // allocated as needed and never move. Closed handles go on a free list, and their
+    // buffers on a free list for their size class, so once a program has opened a few
+    // files, opening another one doesn't need any memory from the system.
+    static stream* _sys_stream_chunks[N_STREAMS / STREAM_CHUNK];
+    static i32 _sys_free_handle = -1;
+    static u32 _sys_n_handles = 0;
+    static char* _sys_free_buffers[3]; // small, default and large buffers
+
+    // Buffer sizes go up by a factor of four from one class to the next.
+    static u32 buffer_class(u32 size) {
+        u32 c = 0;
+        while (c < 2 && (u32(BASIL_STREAMBUF_SMALL) << 2 * c) < size) c ++;
+        return c;
+    }
 
-    static_assert(sizeof(stream) == 16384);
+    // Returns null if a new slab was needed and couldn't be mapped.
+    static char* alloc_buffer(u32 c) {
+        if (!_sys_free_buffers[c]) {
+            u32 size = u32(BASIL_STREAMBUF_SMALL) << 2 * c;
+            char* slab = (char*)_sys_mmap(nullptr, STREAM_SLAB, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE);
+            if (mmap_failed(slab)) return nullptr;
+            for (u32 i = STREAM_SLAB; i >= size; i -= size) {
+                *(char**)(slab + i - size) = _sys_free_buffers[c];
+                _sys_free_buffers[c] = slab + i - size;
+            }
+        }
+        char* buf = _sys_free_buffers[c];
+        _sys_free_buffers[c] = *(char**)buf;
+        return buf;
+    }
 
-    stream* new_stream(i32 fd) {
-        stream* s = (stream*)_sys_mmap(nullptr, sizeof(stream), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE);
-        s->fd = fd;
-        s->start = 0;
-        s->end = 0;
-        return s;
+    static void free_buffer(char* buf, u32 size) {
+        u32 c = buffer_class(size);
+        *(char**)buf = _sys_free_buffers[c];
+        _sys_free_buffers[c] = buf;
+    }
+
+    static stream& handle_stream(i64 h) {
+        return _sys_stream_chunks[h / STREAM_CHUNK][h % STREAM_CHUNK];
+    }
+
+    // Claims a handle for 'fd', with a buffer of at least 'size' bytes (up to the
+    // largest class). Returns -1 if we're out of handles or memory.
+    static i64 new_stream(i32 fd, u32 size) {
+        u32 c = buffer_class(size);
+        char* buf = alloc_buffer(c);
+        if (!buf) return -1;
+        i64 h = _sys_free_handle;
+        if (h >= 0) _sys_free_handle = handle_stream(h).next_free;
+        else {
+            stream** chunk = _sys_n_handles < N_STREAMS ? &_sys_stream_chunks[_sys_n_handles / STREAM_CHUNK] : nullptr;
+            if (chunk && !*chunk) *chunk = (stream*)alloc_buffer(0);
+            if (!chunk || !*chunk) {
+                free_buffer(buf, u32(BASIL_STREAMBUF_SMALL) << 2 * c);
+                return -1;
+            }
+            h = _sys_n_handles ++;
+        }
+        stream& s = handle_stream(h);
+        s.fd = fd;
+        s.start = s.end = s.line_buffered = 0;
+        s.next_free = -1;
+        s.cap = u32(BASIL_STREAMBUF_SMALL) << 2 * c;
+        s.buf = buf;
+        return h;
     }
 
     void init_io() {
-        for (u32 i = 0; i < N_STREAMS; i ++) 
-            _sys_streams[i] = nullptr; // ensure zero init
-        _sys_streams[0] = new_stream(0); // stdin
-        _sys_streams[1] = new_stream(1); // stdout
-        _sys_streams[2] = new_stream(2); // stderr
+        _sys_detect_cpu();
+        new_stream(0, BASIL_STREAMBUF_DEFAULT); // stdin
+        new_stream(1, BASIL_STREAMBUF_DEFAULT); // stdout
+        new_stream(2, BASIL_STREAMBUF_SMALL); // stderr
+        set_buffering(handle_stream(BASIL_STDOUT_FD), BASIL_BUFFER_AUTO);
+    }
+
+    void set_buffering(stream& io, i64 mode) {
+        if (mode == BASIL_BUFFER_AUTO) mode = _sys_isatty(io.fd) ? BASIL_BUFFER_LINE : BASIL_BUFFER_FULL;
+        io.line_buffered = mode == BASIL_BUFFER_LINE;
     }
 
     stream& io_for_fd(i64 i) {
-        return *_sys_streams[i];
+        return handle_stream(i);
     }
 
+    static void flush_output(stream& io);
+
     static void flush_input(stream& io) {
-        _sys_memcpy(io.buf, io.buf + io.start, io.end - io.start);
+        // make sure any prompt is visible before we wait on input
+        if (&io == &handle_stream(BASIL_STDIN_FD)) flush_output(handle_stream(BASIL_STDOUT_FD));
+        _sys_memmove(io.buf, io.buf + io.start, io.end - io.start);
         io.end -= io.start, io.start = 0;
-        i64 amt = _sys_read(io.fd, io.buf + io.end, 4096 - (io.end - io.start));
-        io.end += amt;
+        i64 amt = _sys_read(io.fd, io.buf + io.end, io.cap - io.end);
+        if (amt > 0) io.end += amt;
     }
 
     static void flush_output(stream& io) {
@@ -279,32 +727,168 @@ namespace sys {
         _sys_exit(code);
     }
     
-    i64 open(const char* path, i64 flags) {
+    i64 open(const char* path, i64 flags, u32 buffer_size) {
         i64 fd = _sys_open(path, flags);
         if (fd < 0) return -1;
-        else {
-            i64 hnd = -1;
-            for (u32 i = 3; i < N_STREAMS; i ++) { // skip fds 0-2 since they're standard
-                if (!_sys_streams[i]) {
-                    hnd = i;
-                    _sys_streams[i] = new_stream(fd);
-                    break;
-                }
+        i64 h = new_stream(fd, buffer_size);
+        if (h < 0) _sys_close(fd);
+        return h;
+    }
+
+    void close(i64 i) {
+        if (i < 0 || i >= _sys_n_handles || handle_stream(i).fd < 0) return;
+        stream& io = handle_stream(i);
+        if (io.end != io.start) flush_output(io);
+        _sys_close(io.fd);
+        free_buffer(io.buf, io.cap);
+        io.fd = -1;
+        io.next_free = _sys_free_handle;
+        _sys_free_handle = i;
+    }
+
+    // Strings produced by map_file() and read_direct() get a mapping of their own. The
+    // data starts one page in, so that the usual u32 length prefix (and the size of the
+    // whole mapping, for unmap()) can sit just before it. The mapping always extends
+    // past the data to hold a null terminator. A magic word ahead of the size marks the
+    // mapping as ours, so unmap() can leave every other string alone.
+    #define MAPPING_PAGE 4096
+    #define MAPPING_MAX_SIZE 0xfffffffeull
+    #define MAPPING_MAGIC 0x70616d6c69736162ull // "basilmap"
+
+    static const struct {
+        u32 size;
+        char data[4];
+    } _sys_empty_string = { 1, "" };
+
+    const char* const empty_string = _sys_empty_string.data;
+
+    static u64 mapping_size(u64 n) {
+        return MAPPING_PAGE + (n + MAPPING_PAGE) / MAPPING_PAGE * MAPPING_PAGE; // header page + data + null
+    }
+
+    // Returns null if the mapping couldn't be made.
+    static char* new_mapping(u64 n) {
+        u8* base = (u8*)_sys_mmap(nullptr, mapping_size(n), PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE);
+        if (mmap_failed(base)) return nullptr;
+        *(u64*)(base + MAPPING_PAGE - 24) = MAPPING_MAGIC;
+        *(u64*)(base + MAPPING_PAGE - 16) = mapping_size(n);
+        return (char*)base + MAPPING_PAGE;
+    }
+
+    // Only mapped strings start on a page boundary, since every other string follows its
+    // own length prefix, so checking the magic word never reads outside the string's page
+    // or the one before it.
+    static bool is_mapping(const char* str) {
+        return u64(str) % MAPPING_PAGE == 0 && *(const u64*)(str - 24) == MAPPING_MAGIC;
+    }
+
+    static void set_mapping_size(char* str, u64 n) {
+        *(u32*)(str - 4) = n + 1;
+    }
+
+    const char* map_file(const char* path) {
+        i64 fd = _sys_open(path, BASIL_READ);
+        if (fd < 0) return _sys_empty_string.data;
+        i64 size = _sys_lseek(fd, 0, 2); // SEEK_END
+        if (size <= 0 || (u64)size > MAPPING_MAX_SIZE) {
+            _sys_close(fd);
+            return _sys_empty_string.data;
+        }
+
+        char* str = new_mapping(size);
+        if (!str) {
+            _sys_close(fd);
+            return _sys_empty_string.data;
+        }
+        if (!_sys_mmap_file(str, size, fd)) { // fall back to reading the whole file in
+            u64 total = 0;
+            _sys_lseek(fd, 0, 0); // SEEK_SET
+            while (total < (u64)size) {
+                i64 amt = _sys_read(fd, str + total, size - total);
+                if (amt <= 0) break;
+                total += amt;
             }
-            return hnd; // returns -1 if we couldn't find an open stream
+            size = total;
         }
+        _sys_close(fd);
+        set_mapping_size(str, size);
+        return str;
     }
 
-    void close(i64 i) {
-        if (i < 0 || i >= N_STREAMS || !_sys_streams[i]) return;
-        if (_sys_streams[i]->end != _sys_streams[i]->start) flush_output(*_sys_streams[i]);
-        _sys_close(_sys_streams[i]->fd);
-        _sys_munmap(_sys_streams[i], sizeof(stream));
-        _sys_streams[i] = nullptr;
+    const char* read_direct(stream& io, u64 n) {
+        if (n > MAPPING_MAX_SIZE) n = MAPPING_MAX_SIZE;
+        if (!n) return _sys_empty_string.data;
+        char* str = new_mapping(n);
+        if (!str) return _sys_empty_string.data;
+
+        // drain anything already buffered, then read the rest straight into the mapping
+        u64 total = io.end - io.start < n ? io.end - io.start : n;
+        _sys_memcpy(str, io.buf + io.start, total);
+        io.start += total;
+        if (total < n && &io == &handle_stream(BASIL_STDIN_FD)) flush_output(handle_stream(BASIL_STDOUT_FD));
+        while (total < n) {
+            i64 amt = _sys_read(io.fd, str + total, n - total);
+            if (amt <= 0) break;
+            total += amt;
+        }
+        set_mapping_size(str, total);
+        return str;
+    }
+
+    void unmap(const char* str) {
+        if (!is_mapping(str)) return;
+        _sys_munmap((void*)(str - MAPPING_PAGE), *(const u64*)(str - 16));
+    }
+
+    // Runtime objects are carved out of large anonymous regions by bumping a pointer,
+    // and aren't freed yet. Requests too big to share a region get a mapping of their own.
+    #define HEAP_REGION (1 << 20)
+
+    static u8* _sys_heap_next = nullptr;
+    static u8* _sys_heap_end = nullptr;
+
+    static void out_of_memory() {
+        const char msg[] = "Out of memory.\n";
+        write_string(io_for_fd(BASIL_STDERR_FD), msg, sizeof(msg) - 1);
+        exit(1);
+    }
+
+    void* alloc(u64 size) {
+        if (size > ~u64(MAPPING_PAGE - 1) - MAPPING_PAGE) out_of_memory(); // would wrap when rounded up
+        size = (size + 15) & ~15ull;
+        if (size > HEAP_REGION / 4) {
+            void* result = _sys_mmap(nullptr, (size + MAPPING_PAGE - 1) & ~u64(MAPPING_PAGE - 1),
+                PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE);
+            if (mmap_failed(result)) out_of_memory();
+            return result;
+        }
+        if (u64(_sys_heap_end - _sys_heap_next) < size) {
+            u8* region = (u8*)_sys_mmap(nullptr, HEAP_REGION, PROT_READ | PROT_WRITE, MAP_ANONYMOUS | MAP_PRIVATE);
+            if (mmap_failed(region)) out_of_memory();
+            _sys_heap_next = region;
+            _sys_heap_end = _sys_heap_next + HEAP_REGION;
+        }
+        void* result = _sys_heap_next;
+        _sys_heap_next += size;
+        return result;
+    }
+
+    // Writes out any buffered output followed by 'n' bytes of 'str', in as few syscalls
+    // as possible and without copying 'str' into the buffer first.
+    static void write_direct(stream& io, const char* str, u64 n) {
+        _sys_iovec iov[2] = {{ io.buf + io.start, io.end - io.start }, { str, n }};
+        u32 i = iov[0].len ? 0 : 1;
+        while (i < 2) {
+            i64 amt = _sys_writev(io.fd, iov + i, 2 - i);
+            if (amt <= 0) break;
+            while (i < 2 && (u64)amt >= iov[i].len) amt -= iov[i ++].len;
+            if (i < 2) iov[i].base = (const char*)iov[i].base + amt, iov[i].len -= amt;
+        }
+        io.end = io.start;
     }
 
     static inline void push_if_necessary(stream& io, u32 n = 64) {
-        if (STREAMBUF_SIZE - io.end < n) flush_output(io);
+        if (io.cap - io.end < n) flush_output(io);
     }
 
     static inline void pull_if_necessary(stream& io, u32 n = 64) {
@@ -313,7 +897,7 @@ namespace sys {
 
     static inline void put(stream& io, u8 c) {
         io.buf[io.end ++] = c;
-        if (&io == &io_for_fd(BASIL_STDOUT_FD) && c == '\n') flush_output(io);
+        if (io.line_buffered && c == '\n') flush_output(io);
     }
 
     const char* digits[] = {
@@ -331,38 +915,50 @@ namespace sys {
 
     void write_uint(stream& io, u64 u) {
         push_if_necessary(io, 24);
-        if (!u) return put(io, '0');
-        int c = 0, d = 0;
-        u64 p = 1;
-        while (p <= u) p *= 10, ++ c;
-        d = c;
-        while (c >= 2) {
-            *(u16*)(io.buf + io.end + c - 2) = *(u16*)(digits[u % 100]); 
+        char tmp[20];
+        char* p = tmp + 20;
+        while (u >= 100) {
+            p -= 2;
+            *(u16*)p = *(u16*)(digits[u % 100]);
             u /= 100;
-            c -= 2;
         }
-        if (c) io.buf[io.end + c - 1] = "0123456789"[u % 10];
-        io.end += d;
+        if (u >= 10) p -= 2, *(u16*)p = *(u16*)(digits[u]);
+        else *-- p = '0' + u;
+        io.end += _sys_memcpy(io.buf + io.end, p, tmp + 20 - p);
     }
 
     void write_int(stream& io, i64 i) {
         push_if_necessary(io, 24);
-        if (i < 0) put(io, '-'), i = -i;
-        write_uint(io, i); 
+        if (i < 0) put(io, '-');
+        write_uint(io, i < 0 ? 0 - (u64)i : (u64)i); // negating in unsigned handles INT64_MIN
+    }
+
+    void write_float(stream& io, float f) {
+        push_if_necessary(io, 32);
+        io.end += format_float((char*)io.buf + io.end, f);
+    }
+
+    void write_double(stream& io, double d) {
+        push_if_necessary(io, 32);
+        io.end += format_double((char*)io.buf + io.end, d);
     }
 
     void write_string(stream& io, const char* str, u32 n) {
+        // large strings that wouldn't fit are written alongside the buffer, not through it
+        if (n >= io.cap / 4 && n > io.cap - io.end) return write_direct(io, str, n);
+
         u32 i = 0;
-        if (&io == &io_for_fd(BASIL_STDOUT_FD)) for (i = 0; i < n; i ++) {
-            push_if_necessary(io, 1);
-            io.buf[io.end ++] = str[i];
-            if (str[i] == '\n') flush_output(io);
-        }
-        else while (n) {
-            u32 chunk = n > STREAMBUF_SIZE ? STREAMBUF_SIZE : n;
+        while (n) {
+            u32 chunk = n > io.cap ? io.cap : n;
             push_if_necessary(io, chunk);
             u32 written = _sys_memcpy(io.buf + io.end, str + i, chunk);
             io.end += written;
+
+            // line-buffered streams flush once per chunk that ends a line, not per line
+            if (io.line_buffered) for (u32 j = i; j < i + written; j ++) if (str[j] == '\n') {
+                flush_output(io);
+                break;
+            }
             i += written;
             n -= written;
         }
@@ -371,35 +967,91 @@ namespace sys {
     void write_char(stream& io, rune c) {
         push_if_necessary(io, 4);
         io.end += utf8_encode(&c, 1, io.buf + io.end, 4);
-        if (&io == &io_for_fd(BASIL_STDOUT_FD) && c == '\n') flush_output(io);
+        if (io.line_buffered && c == '\n') flush_output(io);
     }
 
     void write_byte(stream& io, u8 c) {
         push_if_necessary(io, 1);
         put(io, c);
-        if (&io == &io_for_fd(BASIL_STDOUT_FD) && c == '\n') flush_output(io);
     }
 
     bool isdigit(char c) {
         return c >= '0' && c <= '9';
     }
 
+    // Checks that all eight bytes of 'w' are ASCII digits: adding 6 carries any byte
+    // above '9' out of the 0x3_ range.
+    static inline bool _sys_eight_digits(u64 w) {
+        return !(((w & 0xf0f0f0f0f0f0f0f0ull)
+            | (((w + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) ^ 0x3333333333333333ull);
+    }
+
+    // Combines eight ASCII digits, most significant first in memory, into their value
+    // by merging adjacent pairs, then quads, then halves.
+    static inline u32 _sys_parse_eight(u64 w) {
+        w -= 0x3030303030303030ull;
+        w = w * 10 + (w >> 8);
+        return ((w & 0x000000ff000000ffull) * (100 + (1000000ull << 32))
+            + ((w >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32))) >> 32;
+    }
+
+    u32 parse_digits(const char* s, u32 n, u64& acc) {
+        u32 i = 0;
+        // eight digits at a time while the result can't overflow
+        while (i + 8 <= n && acc < 100000000000ull && _sys_eight_digits(_sys_load(s + i)))
+            acc = acc * 100000000 + _sys_parse_eight(_sys_load(s + i)), i += 8;
+        for (; i < n && isdigit(s[i]); i ++) {
+            u64 d = s[i] - '0';
+            acc = acc > (0xffffffffffffffffull - d) / 10 ? 0xffffffffffffffffull : acc * 10 + d;
+        }
+        return i;
+    }
+
     u64 read_uint(stream& io) {
         u64 acc = 0;
-        u8 i = 0;
-        while (isdigit(io.buf[io.start]) && i < 18) {
-            acc *= 10;
-            acc += io.buf[io.start] - '0';
-            i ++;
-            io.start ++;
+        pull_if_necessary(io, 32);
+        for (;;) {
+            u32 avail = io.end - io.start, used = parse_digits((const char*)io.buf + io.start, avail, acc);
+            io.start += used;
+            if (!used || used < avail) break;
+
+            // the digits ran up to the end of the buffer, so there may be more to come
+            flush_input(io);
+            if (io.start == io.end) break;
         }
         return acc;
     }
 
     i64 read_int(stream& io) {
-        i64 i = 1;
-        if (io.buf[io.start] == '-') i = -1;
-        return i * read_uint(io);
+        pull_if_necessary(io, 32);
+        bool neg = false;
+        if (io.start < io.end && (io.buf[io.start] == '-' || io.buf[io.start] == '+'))
+            neg = io.buf[io.start ++] == '-';
+        u64 u = read_uint(io);
+        if (neg) return u >= 0x8000000000000000ull ? (i64)0x8000000000000000ull : -(i64)u;
+        return u > 0x7fffffffffffffffull ? 0x7fffffffffffffffll : (i64)u;
+    }
+
+    // Parses a float from the front of the buffer, pulling in more input if the number
+    // might continue past its end.
+    template<typename T>
+    static T read_real(stream& io, u32 (*parse)(const char*, u32, T&)) {
+        T t = 0;
+        pull_if_necessary(io, 64);
+        for (;;) {
+            u32 avail = io.end - io.start, used = parse((const char*)io.buf + io.start, avail, t);
+            if (used < avail) return io.start += used, t;
+            flush_input(io);
+            if (io.end - io.start == avail) return io.start += used, t;
+        }
+    }
+
+    float read_float(stream& io) {
+        return read_real<float>(io, parse_float);
+    }
+
+    double read_double(stream& io) {
+        return read_real<double>(io, parse_double);
     }
 
     void read(stream& io, char* str, u32 n) {
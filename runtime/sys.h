@@ -12,6 +12,15 @@
 
 #include "util/defs.h"
 
+// Freestanding memory routines, used in place of libc's within the runtime.
+extern "C" i64 _sys_memcpy(void* dst, const void* src, size_t size);
+extern "C" void* _sys_memmove(void* dst, const void* src, size_t size);
+extern "C" void* _sys_memset(void* dst, u8 c, size_t size);
+extern "C" const void* _sys_memchr(const void* src, u8 c, size_t size);
+extern "C" i64 _sys_strlen(const char* str);
+extern "C" i64 _sys_memcmp(const void* a, const void* b, size_t size);
+extern "C" void _sys_detect_cpu();
+
 namespace sys {
     struct stream;
 
@@ -30,23 +39,106 @@ namespace sys {
     #define BASIL_WRITE 2
     #define BASIL_APPEND 4
 
-    i64 open(const char* path, i64 flags);
+    // Output buffering modes. Line-buffered streams are flushed after every newline,
+    // fully-buffered ones only when their buffer fills up, on exit, or before reading
+    // from stdin. Auto picks line buffering for terminals and full buffering otherwise,
+    // and is the default for stdout.
+    #define BASIL_BUFFER_LINE 0
+    #define BASIL_BUFFER_FULL 1
+    #define BASIL_BUFFER_AUTO 2
+
+    // Stream buffer sizes. Small buffers suit pipes, sockets and other streams that see
+    // little data at a time, and large ones bulk reads and writes of files. Other
+    // sizes are rounded up to one of these.
+    #define BASIL_STREAMBUF_SMALL 4096
+    #define BASIL_STREAMBUF_DEFAULT 16384
+    #define BASIL_STREAMBUF_LARGE 65536
+
+    i64 open(const char* path, i64 flags, u32 buffer_size = BASIL_STREAMBUF_DEFAULT);
     void close(i64 i);
     void init_io();
     stream& io_for_fd(i64 i);
+    void set_buffering(stream& io, i64 mode);
 
     void write_string(stream& io, const char* str, u32 n);
     void write_char(stream& io, rune c);
     void write_byte(stream& io, u8 c);
     void write_uint(stream& io, u64 u);
     void write_int(stream& io, i64 i);
+    void write_float(stream& io, float f);
+    void write_double(stream& io, double d);
     void read_string(stream& io, char* str, u32 n);
     rune read_char(stream& io);
     u8 read_byte(stream& io);
     u64 read_uint(stream& io);
     i64 read_int(stream& io);
+    float read_float(stream& io);
+    double read_double(stream& io);
+
+    // Text conversions behind the numeric stream functions. Integers past the range
+    // of u64 saturate. The format functions write at most 32 bytes and return how many
+    // they wrote; the parse functions return how many bytes of 's' they consumed, which
+    // is zero if it doesn't start with a number. parse_digits() accumulates onto 'acc'.
+    u32 parse_digits(const char* s, u32 n, u64& acc);
+    u32 format_float(char* buf, float f);
+    u32 format_double(char* buf, double d);
+    u32 parse_float(const char* s, u32 n, float& f);
+    u32 parse_double(const char* s, u32 n, double& d);
 
     void flush(stream& io);
+
+    // Zero-copy and unbuffered input. Both return runtime strings that own a mapping
+    // of their own, to be released with unmap(). map_file() maps the whole file at
+    // 'path' read-only (reading it in instead where that isn't possible), and
+    // read_direct() reads up to 'n' bytes from 'io' without going through its buffer.
+    // Failures produce an empty string. unmap() ignores strings that don't own a mapping.
+    const char* map_file(const char* path);
+    const char* read_direct(stream& io, u64 n);
+    void unmap(const char* str);
+
+    // Allocates 'size' bytes of zeroed memory for a runtime object, aligned to 16 bytes.
+    // Allocations live until the program exits, which it does with an error if memory
+    // runs out.
+    void* alloc(u64 size);
+
+    // Runtime dictionaries, an open-addressing hash table with linear probing. Keys are
+    // either words (integers and symbols, compared by value) or runtime strings (compared
+    // by contents), and each kind has its own hash and equality. Values are one word,
+    // stored in the slot that insert() and find() return a pointer to. The entry count
+    // comes first, so compiled code can read it directly.
+    struct dict_entry {
+        u64 hash, key, value; // hash is zero for empty entries
+    };
+
+    struct dict {
+        i64 size;
+        u64 mask;
+        dict_entry* entries;
+    };
+
+    // Scrambles a word so that every bit of it affects every bit of the hash.
+    u64 hash_word(u64 w);
+
+    dict* dict_new(u64 capacity);
+    u64* dict_insert_word(dict* d, u64 key);
+    u64* dict_find_word(const dict* d, u64 key);
+    u64* dict_insert_string(dict* d, const char* key);
+    u64* dict_find_string(const dict* d, const char* key);
+
+    // Runtime strings point at their first byte, with the length plus one in the four
+    // bytes before it and a null terminator after the last. They're immutable, so these
+    // return one of their arguments instead of a copy wherever the result would be equal.
+    extern const char* const empty_string;
+
+    u32 string_length(const char* s);
+    const char* string_new(const char* bytes, u32 n);
+    const char* string_concat(const char* a, const char* b);
+    const char* string_slice(const char* s, i64 start, i64 end);
+    u32 string_chars(const char* s);
+    const char* string_slice_chars(const char* s, i64 start, i64 end);
+    i64 string_compare(const char* a, const char* b);
+    bool string_equal(const char* a, const char* b);
+    u64 string_hash(const char* s);
 }
 
 #endif
\ No newline at end of file
@@ -9,7 +9,12 @@
 
 #include "driver.h"
 #include "eval.h"
+#include "ssa.h"
 #include "test.h"
+#include "jasmine/jobj.h"
+#include "stdio.h"
+#include "unistd.h"
+#include "sys/wait.h"
 
 using namespace basil;
 
@@ -18,6 +23,38 @@ SETUP {
     get_perf_info().set_max_count(99999); // try and do everything comptime
 }
 
+// Compiles a lowered program to native code, runs it, and returns its result.
+i64 run_step(const rc<AST>& ast_in) {
+    rc<AST> ast = ast_in;
+    if (!ast) return -1;
+    ast->type(root_env());
+    rc<IRFunction> main = ref<IRFunction>(symbol_from(".basil_main"), t_func(T_VOID, T_INT));
+    main->finish(T_INT, ast->gen_ssa(root_env(), main));
+    optimize(main, OPT_FAST);
+
+    jasmine::Object object({ jasmine::JASMINE, jasmine::DEFAULT_OS });
+    jasmine::bc::writeto(object);
+    main->emit(object.get_context());
+    jasmine::Object native = object.retarget(jasmine::DEFAULT_TARGET);
+    init_rt(native);
+    native.load();
+    return ((i64(*)())native.find(jasmine::global(".basil_main")))();
+}
+
+// Compiles and runs a program in a child process, returning its exit status, for programs
+// that are expected to exit from within the runtime.
+i64 run_exit_step(const rc<AST>& ast) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        freopen("/dev/null", "w", stderr);
+        run_step(ast);
+        _exit(0);
+    }
+    int status;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
 TEST(arithmetic) {
     ASSERT_EQUAL(compile("1 + 2 * 3", load_step, lex_step, parse_step, eval_step), v_int({}, 7));
     ASSERT_EQUAL(compile("(1 + 2) * 3", load_step, lex_step, parse_step, eval_step), v_int({}, 9));
@@ -152,4 +189,194 @@ do:
     kw-var kw-bar 3 kw-baz
 )", load_step, lex_step, parse_step, eval_step);
     ASSERT_EQUAL(result, v_int({}, 6));
-}
\ No newline at end of file
+}
+
+TEST(runtime_string_operators) {
+    // mapping a file gives us a string the operators can't be folded on
+    ASSERT_EQUAL(compile(R"(
+do:
+    def ops-text = mapfile "test/compiler/source-example"
+    def ops-abc = substr ops-text 0 3
+    def ops-1 = (if (ops-text length) == 39 then 1 else 0)
+    def ops-2 = (if ((ops-text + "12") length) == 41 then 2 else 0)
+    def ops-3 = (if ops-abc == "abc" then 4 else 0)
+    def ops-4 = (if (substr ops-text 4 7) + "!" == "def!" then 8 else 0)
+    def ops-5 = (if ops-text == "abc" then 16 else 0)
+    def ops-6 = (if ops-text != "abc" then 32 else 0)
+    def ops-7 = (if ops-text < "abd" then 64 else 0)
+    def ops-8 = (if ops-text > "abd" then 128 else 0)
+    def ops-9 = (if ops-abc <= "abc" then 256 else 0)
+    def ops-10 = (if ops-abc >= "abd" then 512 else 0)
+    ops-1 + ops-2 + ops-3 + ops-4 + ops-5 + ops-6 + ops-7 + ops-8 + ops-9 + ops-10
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 1 + 2 + 4 + 8 + 32 + 64 + 256);
+}
+
+TEST(runtime_string_results_as_arguments) {
+    // each result is passed straight to another runtime call, across several statements
+    ASSERT_EQUAL(compile(R"(
+do:
+    def args-text = mapfile "test/compiler/source-example"
+    def len-a = (substr (args-text + "1") 0 4) length
+    def len-b = (substr (args-text + "22") 0 5) length
+    def eq-a = (if (args-text + "1") == "abc" then 10 else 20)
+    def eq-b = (if (args-text + "1") == "abc" then 10 else 20)
+    def less-a = (if (substr args-text 0 3) < "abd" then 100 else 200)
+    def less-b = (if (substr args-text 0 3) < "abd" then 100 else 200)
+    len-a + len-b + eq-a + eq-b + less-a + less-b
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 4 + 5 + 20 + 20 + 100 + 100);
+}
+
+TEST(string_code_points) {
+    // strings are measured and sliced in code points, at compile time as at runtime
+    ASSERT_EQUAL(compile("\"h\u00e9llo\" length", load_step, lex_step, parse_step, eval_step), v_int({}, 5));
+    ASSERT_EQUAL(compile("substr \"h\u00e9llo\" 0 2", load_step, lex_step, parse_step, eval_step), 
+        v_string({}, "h\u00e9"));
+    ASSERT_EQUAL(compile("substr \"h\u00e9llo\" 2 9", load_step, lex_step, parse_step, eval_step), 
+        v_string({}, "llo"));
+    ASSERT_EQUAL(compile(R"(
+do:
+    def cp-text = (mapfile "test/compiler/source-example") + "h\u00E9llo"
+    def cp-1 = (if (cp-text length) == 44 then 1 else 0)
+    def cp-2 = (if (substr cp-text 40 41) == "\u00E9" then 2 else 0)
+    def cp-3 = (if (substr cp-text 41 100) == "llo" then 4 else 0)
+    cp-1 + cp-2 + cp-3
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 1 + 2 + 4);
+}
+
+
+TEST(match_constant_dispatch) {
+    // the scrutinee is only known at runtime, so each constant case is tested in turn
+    ASSERT_EQUAL(compile(R"(
+do:
+    def cd-len = (mapfile "test/compiler/source-example") length
+    def cd-a = (match cd-len with:
+        1 => 10
+        39 => 20
+        x? => 30)
+    def cd-b = (match cd-len + 1 with:
+        1 => 100
+        39 => 200
+        x? => 300)
+    cd-a + cd-b
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 20 + 300);
+}
+
+TEST(match_bool_exhaustive) {
+    // 'true' and 'false' together cover every bool, so no catch-all is needed
+    ASSERT_EQUAL(compile(R"(
+do:
+    def be-len = (mapfile "test/compiler/source-example") length
+    def be-a = (match be-len == 39 with:
+        true => 1
+        false => 2)
+    def be-b = (match be-len == 40 with:
+        true => 10
+        false => 20)
+    be-a + be-b
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 1 + 20);
+}
+
+TEST(match_opaque_operand) {
+    // a pattern naming a runtime variable is compared against its value
+    ASSERT_EQUAL(compile(R"(
+do:
+    def op-len = (mapfile "test/compiler/source-example") length
+    def op-other = op-len - 1
+    def op-a = (match op-len - 1 with:
+        op-other => 1
+        x? => 2)
+    def op-b = (match op-len with:
+        op-other => 10
+        39 => 20
+        x? => 30)
+    op-a + op-b
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 1 + 20);
+}
+
+TEST(match_binding) {
+    // a variable pattern binds the scrutinee in its case body
+    ASSERT_EQUAL(compile(R"(
+do:
+    def bd-len = (mapfile "test/compiler/source-example") length
+    match bd-len with:
+        0 => 0
+        n? => n + 1
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 40);
+}
+
+TEST(match_errors) {
+    // evaluated by hand, since eval_step would report and discard the errors
+    Value non_exhaustive = compile(R"(
+do:
+    def ne-len = (mapfile "test/compiler/source-example") length
+    match ne-len with:
+        1 => 1
+        2 => 2
+)", load_step, lex_step, parse_step);
+    ASSERT_EQUAL(eval(root_env(), non_exhaustive), v_error({}));
+    ASSERT_EQUAL(error_count(), 1); // no case matches anything but 1 or 2
+    discard_errors();
+
+    Value unreachable = compile(R"(
+do:
+    def ur-len = (mapfile "test/compiler/source-example") length
+    match ur-len with:
+        1 => 1
+        x? => 2
+        3 => 3
+)", load_step, lex_step, parse_step);
+    ASSERT_EQUAL(eval(root_env(), unreachable), v_error({}));
+    ASSERT_EQUAL(error_count(), 1); // the catch-all already covers 3
+    discard_errors();
+}
+TEST(runtime_arrays) {
+    // a runtime element makes the whole array a runtime value
+    ASSERT_EQUAL(compile(R"(
+do:
+    def ra-len = (mapfile "test/compiler/source-example") length
+    def ra-xs = array 1 ra-len 3
+    ra-xs[0] = ra-xs[2] * 10
+    ra-xs[2] = ra-xs[ra-len - 38]
+    ra-xs[0] + ra-xs[1] * 100 + ra-xs[2] * 10000 + (ra-xs length) * 1000000
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 30 + 3900 + 390000 + 3000000);
+}
+
+TEST(runtime_array_bounds) {
+    ASSERT_EQUAL(compile(R"(
+do:
+    def rb-len = (mapfile "test/compiler/source-example") length
+    def rb-xs = array 1 rb-len
+    rb-xs[rb-len - 37]
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_exit_step), 1);
+    ASSERT_EQUAL(compile(R"(
+do:
+    def rn-len = (mapfile "test/compiler/source-example") length
+    def rn-xs = array 1 rn-len
+    rn-xs[38 - rn-len] = 0
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_exit_step), 1);
+
+    // evaluated by hand, since eval_step would report and discard the errors
+    Value comptime = compile(R"(
+do:
+    def rc-xs = array 1 2 3
+    rc-xs[3]
+)", load_step, lex_step, parse_step);
+    ASSERT_EQUAL(eval(root_env(), comptime), v_error({}));
+    ASSERT_EQUAL(error_count(), 1);
+    discard_errors();
+}
+
+TEST(runtime_dicts) {
+    // integer, string and symbol keys, each looked up and assigned through at runtime
+    ASSERT_EQUAL(compile(R"(
+do:
+    def rd-len = (mapfile "test/compiler/source-example") length
+    def rd-ints = dict 1 10 rd-len 20 -5 30
+    rd-ints[rd-len] = rd-ints[rd-len] + 1
+    def rd-strs = dict "a" 100 "abc" rd-len
+    def rd-syms = dict :x 1000 :y rd-len
+    rd-syms[:y] = rd-syms[:y] * 2
+    rd-ints[1] + rd-ints[39] + rd-ints[-5] + rd-strs["a"] + rd-strs["abc"] + rd-syms[:x] + rd-syms[:y]
+        + (rd-ints length) * 100000
+)", load_step, lex_step, parse_step, eval_step, ast_step, run_step), 10 + 21 + 30 + 100 + 39 + 1000 + 78 + 300000);
+}
@@ -117,4 +117,41 @@ TEST(shadowing) {
     ASSERT_EQUAL(*m, V1); // if we redefine FOO in e5, a leaf env, e4 should still resolve FOO to 
     ASSERT_EQUAL(*n, V1); // the value in e1.
     ASSERT_EQUAL(*o, V3);
-}
\ No newline at end of file
+}
+
+TEST(clone) {
+    Symbol FOO = symbol_from("foo"), BAR = symbol_from("bar"), BAZ = symbol_from("baz");
+    Value V1 = v_int({}, 1), V2 = v_int({}, 2), V3 = v_int({}, 3);
+
+    rc<Env> e1 = ref<Env>();
+    e1->def(FOO, V1);
+    e1->def(BAR, V2);
+
+    rc<Env> e2 = e1->clone(); // clones should start with all the same definitions
+    ASSERT_EQUAL(*e2->find(FOO), V1);
+    ASSERT_EQUAL(*e2->find(BAR), V2);
+    ASSERT_EQUAL(e2->values.size(), 2);
+    ASSERT_TRUE(&*e2->find(BAR) == &*e1->find(BAR)); // reading shouldn't copy out of the shared layer
+
+    e2->def(FOO, V3); // redefining a variable in the clone shouldn't affect the original
+    e2->def(BAZ, V3);
+    ASSERT_EQUAL(*e1->find(FOO), V1);
+    ASSERT_FALSE(e1->find(BAZ));
+    ASSERT_EQUAL(*e2->find(FOO), V3);
+    ASSERT_EQUAL(e2->values.size(), 3);
+
+    *e1->find_mut(BAR) = V1; // ...and assigning in the original shouldn't affect the clone
+    ASSERT_EQUAL(*e1->find(BAR), V1);
+    ASSERT_EQUAL(*e2->find(BAR), V2);
+    ASSERT_EQUAL(e1->values.size(), 2);
+
+    rc<Env> e3 = e2; // we should see each visible definition exactly once when iterating
+    for (u32 i = 0; i < 20; i ++) e3 = e3->clone(), e3->def(FOO, v_int({}, i));
+    u32 n = 0;
+    for (const auto& [k, v] : e3->values) {
+        if (k == FOO) ASSERT_EQUAL(v, v_int({}, 19));
+        n ++;
+    }
+    ASSERT_EQUAL(n, 3);
+    ASSERT_EQUAL(*e2->find(FOO), V3);
+}
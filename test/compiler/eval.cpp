@@ -192,4 +192,25 @@ TEST(simple_math) {
     Value result = eval(root_env(), code);
 
     ASSERT_EQUAL(result, v_int({}, 3));
-}
\ No newline at end of file
+}
+
+TEST(overload_resolution) {
+    Type int_fn = t_func(T_INT, T_INT), float_fn = t_func(T_FLOAT, T_FLOAT), 
+        string_fn = t_func(T_STRING, T_STRING);
+    vector<Type> overloads = vector_of<Type>(int_fn, float_fn);
+    Type isect = t_intersect(overloads);
+
+    for (u32 i = 0; i < 2; i ++) { // repeated calls should resolve the same way, cached or not
+        auto a = resolve_call(nullptr, isect, overloads, T_INT);
+        ASSERT_TRUE(a.is_left());
+        ASSERT_EQUAL(a.left(), int_fn);
+        auto b = resolve_call(nullptr, isect, overloads, T_STRING);
+        ASSERT_TRUE(b.is_right());
+        ASSERT_FALSE(b.right().ambiguous);
+    }
+
+    overloads.push(string_fn); // extending the overload set should let us find the new case
+    auto c = resolve_call(nullptr, t_intersect(overloads), overloads, T_STRING);
+    ASSERT_TRUE(c.is_left());
+    ASSERT_EQUAL(c.left(), string_fn);
+}
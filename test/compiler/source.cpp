@@ -91,4 +91,34 @@ TEST(view_last) {
     view.read();
     ASSERT_EQUAL(view.peek(), '\0');
     ASSERT_EQUAL(view.last(), '\n');
-}
\ No newline at end of file
+}
+
+TEST(tab_expansion) {
+    buffer b;
+    writeln(b, "\tabc");
+    write(b, "d\te");
+    Source source(b);
+    ASSERT_EQUAL(source.size(), 2);
+    ASSERT_EQUAL(source[0], "    abc\n");
+    ASSERT_EQUAL(source[1], "d    e\n");
+    Source::Pos corr = { 1, 0, 1, 7 };
+    ASSERT_EQUAL(source.line_span(1), corr);
+}
+
+TEST(expand_line) {
+    buffer b;
+    writeln(b, "abc");
+    Source source(b);
+    buffer c;
+    writeln(c, "def");
+    writeln(c, "ghi");
+    Source::View view = source.expand_line(c);
+    ASSERT_EQUAL(source.size(), 2);
+    ASSERT_EQUAL(view.line, 1);
+    ASSERT_EQUAL(view.peek(), 'd');
+    ASSERT_EQUAL(source[0], "abc\n");
+    ASSERT_EQUAL(source[1], "def\n");
+    Source copy = source;
+    ASSERT_EQUAL(copy.size(), 2);
+    ASSERT_EQUAL(copy[1], "def\n");
+}
@@ -81,4 +81,79 @@ do:
 
     enforce_ssa(main);
     println(main);
-}
\ No newline at end of file
+}
+// Builds a function that tests 'x' against each of 'values' in turn, branching to
+// the matching block in 'targets', or to 'rest' if none of them match.
+static rc<IRFunction> if_chain(const vector<i64>& values, vector<rc<IRBlock>>& chain,
+    vector<rc<IRBlock>>& targets, rc<IRBlock>& rest) {
+    rc<IRFunction> func = ref<IRFunction>(symbol_from("chain"), T_INT);
+    IRParam x = ir_var(func, symbol_from("x"));
+    chain.push(func->entry);
+    for (u32 i = 1; i < values.size(); i ++) chain.push(func->new_block());
+    for (u32 i = 0; i < values.size(); i ++) targets.push(func->new_block());
+    rest = func->new_block();
+    for (u32 i = 0; i < values.size(); i ++) {
+        func->set_active(chain[i]);
+        IRParam cond = func->add_insn(ir_eq(func, T_INT, x, ir_int(values[i])));
+        func->add_insn(ir_if(func, cond, targets[i], i + 1 < values.size() ? chain[i + 1] : rest));
+    }
+    return func;
+}
+
+TEST(form_switch) {
+    vector<rc<IRBlock>> chain, targets;
+    rc<IRBlock> rest;
+    rc<IRFunction> func = if_chain(vector_of<i64>(30l, 10l, 50l, 20l, 40l), chain, targets, rest);
+    form_switches(func);
+
+    // the whole chain should collapse into a single switch in the first block
+    rc<IRBlock> head = chain[0];
+    ASSERT_EQUAL(head->insns.size(), 1);
+    rc<IRInsn> insn = head->insns[0];
+    ASSERT_EQUAL(insn->op, IR_SWITCH);
+    ASSERT_EQUAL(insn->src.size(), 7);
+    ASSERT_EQUAL(insn->src[1].data.block, rest->id);
+
+    // cases should be sorted by value, each still leading to its original block
+    ASSERT_EQUAL(insn->src[2].data.block, targets[1]->id); // 10
+    ASSERT_EQUAL(insn->src[3].data.block, targets[3]->id); // 20
+    ASSERT_EQUAL(insn->src[4].data.block, targets[0]->id); // 30
+    ASSERT_EQUAL(insn->src[5].data.block, targets[4]->id); // 40
+    ASSERT_EQUAL(insn->src[6].data.block, targets[2]->id); // 50
+
+    // every target, and the fallback, should now be entered from the head alone
+    ASSERT_EQUAL(head->out.size(), 6);
+    for (u32 i = 0; i < targets.size(); i ++) {
+        ASSERT_TRUE(head->out[i].is(targets[i]));
+        ASSERT_EQUAL(targets[i]->in.size(), 1);
+        ASSERT_TRUE(targets[i]->in[0].is(head));
+    }
+    ASSERT_TRUE(head->out[5].is(rest));
+    ASSERT_EQUAL(rest->in.size(), 1);
+    ASSERT_TRUE(rest->in[0].is(head));
+
+    // the rest of the chain should be left empty and disconnected
+    for (u32 i = 1; i < chain.size(); i ++) {
+        ASSERT_EQUAL(chain[i]->insns.size(), 0);
+        ASSERT_EQUAL(chain[i]->in.size(), 0);
+        ASSERT_EQUAL(chain[i]->out.size(), 0);
+    }
+}
+
+TEST(form_switch_short_chain) {
+    vector<rc<IRBlock>> chain, targets;
+    rc<IRBlock> rest;
+    rc<IRFunction> func = if_chain(vector_of<i64>(3l, 1l, 2l), chain, targets, rest);
+    form_switches(func);
+
+    // three cases aren't enough for a switch, so nothing should change
+    for (u32 i = 0; i < chain.size(); i ++) {
+        ASSERT_EQUAL(chain[i]->insns.size(), 2);
+        ASSERT_EQUAL(chain[i]->insns.back()->op, IR_IF);
+        ASSERT_EQUAL(chain[i]->out.size(), 2);
+        ASSERT_TRUE(chain[i]->out[0].is(targets[i]));
+    }
+    ASSERT_TRUE(chain[1]->in[0].is(chain[0]));
+    ASSERT_TRUE(chain[2]->in[0].is(chain[1]));
+    ASSERT_TRUE(rest->in[0].is(chain[2]));
+}
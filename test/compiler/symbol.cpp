@@ -30,4 +30,24 @@ TEST(no_duplicates) {
 TEST(symbol_to_string) {
     Symbol a = symbol_from("hello");
     ASSERT_EQUAL(string_from(a), "hello");
-}
\ No newline at end of file
+}
+
+TEST(many_symbols) {
+    vector<Symbol> syms;
+    for (u32 i = 0; i < 5000; i ++) syms.push(symbol_from(::format<ustring>("sym", i)));
+    for (u32 i = 0; i < 5000; i ++) {
+        ASSERT_EQUAL(symbol_from(::format<ustring>("sym", i)), syms[i]);
+        ASSERT_EQUAL(string_from(syms[i]), ::format<ustring>("sym", i));
+    }
+    const char* bytes = "hello world";
+    ASSERT_EQUAL(symbol_from(const_slice<u8>(5, (const u8*)bytes)), symbol_from("hello"));
+}
+
+TEST(symbol_bytes) {
+    const char bytes[] = "a\0b";
+    Symbol a = symbol_from(const_slice<u8>(3, (const u8*)bytes));
+    ASSERT_NOT_EQUAL(a, symbol_from("a"));
+    ASSERT_EQUAL(string_from(a).bytes(), 3); // we shouldn't stop at the null byte
+    ASSERT_EQUAL(string_from(a).raw()[2], 'b');
+    ASSERT_EQUAL(string_from(S_NONE).bytes(), 0);
+}
@@ -257,4 +257,26 @@ TEST(block_colon) {
 
     ASSERT_EQUAL(k->kind, TK_INT);
     ASSERT_EQUAL(k->contents, symbol_from("4"));
-}
\ No newline at end of file
+}
+
+TEST(unicode_symbols) {
+    Source src = create_source("héllo wörld2 αβγ x12é");
+    Source::View view(src);
+
+    optional<Token> a = lex(view), b = lex(view), c = lex(view), d = lex(view);
+    ASSERT_EQUAL(error_count(), 0);
+
+    ASSERT_EQUAL(a->kind, TK_SYMBOL);
+    ASSERT_EQUAL(a->contents, symbol_from("héllo"));
+
+    ASSERT_EQUAL(b->kind, TK_SYMBOL);
+    ASSERT_EQUAL(b->contents, symbol_from("wörld2"));
+    Source::Pos pos = { 0, 6, 0, 12 }; // columns count runes, not bytes
+    ASSERT_EQUAL(b->pos, pos);
+
+    ASSERT_EQUAL(c->kind, TK_SYMBOL);
+    ASSERT_EQUAL(c->contents, symbol_from("αβγ"));
+
+    ASSERT_EQUAL(d->kind, TK_SYMBOL);
+    ASSERT_EQUAL(d->contents, symbol_from("x12é"));
+}
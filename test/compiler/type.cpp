@@ -350,4 +350,22 @@ TEST(bound_tvar_coercion) {
 
     ASSERT_TRUE(T_INT.coerces_to_generic(a));
     ASSERT_TRUE(T_INT.coerces_to(a));
-}
\ No newline at end of file
+}
+
+TEST(memoized_coercion) {
+    Type a = t_tuple(T_INT, t_list(T_STRING)), b = t_tuple(T_FLOAT, t_list(T_STRING));
+    for (u32 i = 0; i < 3; i ++) { // asking repeatedly should give the same answers
+        ASSERT_TRUE(a.coerces_to(b));
+        ASSERT_FALSE(b.coerces_to(a));
+        ASSERT_FALSE(a.coerces_to_generic(b));
+    }
+
+    Type c = t_var(), d = t_list(c);
+    ASSERT_TRUE(d.nonbinding_coerces_to(t_list(T_INT)));
+    ASSERT_TRUE(d.nonbinding_coerces_to(t_list(T_STRING)));
+    ASSERT_TRUE(c.coerces_to(T_INT)); // binding c should invalidate what we remembered about d
+    ASSERT_TRUE(d.nonbinding_coerces_to(t_list(T_INT)));
+    ASSERT_FALSE(d.nonbinding_coerces_to(t_list(T_STRING)));
+    t_unbind(c);
+    ASSERT_TRUE(d.nonbinding_coerces_to(t_list(T_STRING)));
+}
@@ -138,6 +138,37 @@ TEST(labeled_branches) {
     ASSERT_EQUAL(a, b);
 }
 
+TEST(switch_round_trip) {
+    buffer in;
+    write(in,
+"foo:\tframe\n"
+"\tparam i64 %0\n"
+"\tswitch i64 _L3 %0, -1 (_L0, _L3, _L1, _L2)\n"
+"_L0:\tret i64 0\n"
+"_L1:\tret i64 1\n"
+"_L2:\tret i64 2\n"
+"_L3:\tret i64 3\n");
+    buffer copy(in);
+    Context ctx;
+    Insn insns[7];
+    for (u8 i = 0; i < 7; i ++) insns[i] = parse_insn(ctx, in);
+    ASSERT_TRUE(insns[2].opcode == OP_SWITCH);
+    ASSERT_EQUAL(insns[2].params.size(), 7);
+    ASSERT_EQUAL(insns[2].params[2].data.imm.val, -1);
+
+    Object object({ JASMINE, UNSUPPORTED_OS });
+    for (u8 i = 0; i < 7; i ++) assemble_insn(ctx, object, insns[i]);
+
+    bytebuf buf = object.code();
+    for (u8 i = 0; i < 7; i ++) insns[i] = disassemble_insn(ctx, buf, object);
+
+    buffer out;
+    for (u8 i = 0; i < 7; i ++) print_insn(ctx, out, insns[i]);
+
+    string a(copy), b(out);
+    ASSERT_EQUAL(a, b);
+}
+
 TEST(x86_arithmetic_spills) {
     onlyin(X86_64);
 
@@ -291,4 +322,315 @@ dot: frame
     obj.load();
     auto foo = (i64(*)(Triple, Triple))obj.find(global("dot"));
     ASSERT_EQUAL(foo({0, 1, 0}, {1, 0, 0}), 0);
-}
\ No newline at end of file
+}
+
+TEST(indexed_round_trip) {
+    buffer in;
+    write(in,
+"\tmov i64 %2, [%0 + %1 * 8 + 8]\n"
+"\tmov i32 [%0 + %1 * 4 - 4], %2\n"
+"\tmov i8 %3, [%0 + %1]\n");
+    buffer copy(in);
+    Context ctx;
+    Insn insns[3];
+    for (u8 i = 0; i < 3; i ++) insns[i] = parse_insn(ctx, in);
+    ASSERT_TRUE(insns[0].params[1].data.mem.kind == MK_REG_INDEX);
+    ASSERT_EQUAL(insns[0].params[1].data.mem.index.id, 1);
+    ASSERT_EQUAL(insns[0].params[1].data.mem.scale, 8);
+    ASSERT_EQUAL(insns[1].params[0].data.mem.off, -4);
+
+    Object object({ JASMINE, UNSUPPORTED_OS });
+    for (u8 i = 0; i < 3; i ++) assemble_insn(ctx, object, insns[i]);
+
+    bytebuf buf = object.code();
+    for (u8 i = 0; i < 3; i ++) insns[i] = disassemble_insn(ctx, buf, object);
+
+    buffer out;
+    for (u8 i = 0; i < 3; i ++) print_insn(ctx, out, insns[i]);
+
+    string a(copy), b(out);
+    ASSERT_EQUAL(a, b);
+}
+
+TEST(x86_indexed_sum) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+sum: frame
+     param i64 %0
+     mov i64 %1, 0
+     mov i64 %2, 0
+     mov i64 %3, [%0]
+loop: jge i64 end %1, %3
+     mov i64 %4, [%0 + %1 * 8 + 8]
+     add i64 %2, %2, %4
+     add i64 %1, %1, 1
+     jump loop
+end: ret i64 %2
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.load();
+    auto sum = (i64(*)(const i64*))obj.find(global("sum"));
+    i64 array[] = { 5, 1, 2, 3, 4, 5 };
+    ASSERT_EQUAL(sum(array), 15);
+}
+
+TEST(x86_indexed_store) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+squares: frame
+     param i64 %0
+     param i64 %1
+     mov i64 %2, 0
+loop: jge i64 end %2, %1
+     mul i32 %3, %2, %2
+     mov i32 [%0 + %2 * 4], %3
+     add i64 %2, %2, 1
+     jump loop
+end: ret i64 %2
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.load();
+    auto squares = (i64(*)(i32*, i64))obj.find(global("squares"));
+    i32 array[10] = {};
+    ASSERT_EQUAL(squares(array, 9), 9);
+    for (u32 i = 0; i < 9; i ++) ASSERT_EQUAL(array[i], i * i);
+    ASSERT_EQUAL(array[9], 0);
+}
+
+TEST(x86_indexed_spills) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+foo: frame
+     param i64 %0
+     param i64 %1
+     mov i64 %2, 2
+     mov i64 %3, 3
+     mov i64 %4, 4
+     mov i64 %5, 5
+     mov i64 %6, 6
+     mov i64 %7, 7
+     mov i64 %8, 8
+     mov i64 %9, 9
+     mov i64 %10, 10
+     mov i64 %11, 11
+     mov i64 %12, 12
+     mov i64 %13, 13
+     mov i64 %14, 14
+     mov i64 %15, 15
+     mov i64 %16, 16
+     mov i64 %17, 17
+     mov i64 %18, %0
+     mov i64 %19, %1
+     mov i64 %20, [%18 + %19 * 8]
+     mov i64 [%18 + %19 * 8 + 8], %20
+     add i64 %21, %2, %20
+     add i64 %21, %21, %3
+     add i64 %21, %21, %4
+     add i64 %21, %21, %5
+     add i64 %21, %21, %6
+     add i64 %21, %21, %7
+     add i64 %21, %21, %8
+     add i64 %21, %21, %9
+     add i64 %21, %21, %10
+     add i64 %21, %21, %11
+     add i64 %21, %21, %12
+     add i64 %21, %21, %13
+     add i64 %21, %21, %14
+     add i64 %21, %21, %15
+     add i64 %21, %21, %16
+     add i64 %21, %21, %17
+     add i64 %21, %21, %1
+     jeq i64 end %0, 0
+end: ret i64 %21
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.load();
+    auto foo = (i64(*)(i64*, i64))obj.find(global("foo"));
+    i64 array[] = { 0, 0, 100, 0 };
+    ASSERT_EQUAL(foo(array, 2), 100 + 152 + 2);
+    ASSERT_EQUAL(array[3], 100);
+}
+
+static i64 cells[4], seen[3], n_seen;
+
+extern "C" i64* new_cells(i64 length, i64 size) {
+    cells[0] = length;
+    return cells;
+}
+
+extern "C" i64 see(i64 value) {
+    return seen[n_seen ++] = value;
+}
+
+TEST(x86_calls_keep_locals) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+f:   frame
+     param i64 %0
+     call i64 %1, new_cells(i64 3, i64 8)
+     mov i64 [%1 + 8], %0
+     mov i64 [%1 + 16], .msg
+     mov i64 [%1 + 24], %0
+     mov i64 %2, %1
+     mov i64 %3, [%2 + 24]
+     call i64 %4, see(i64 %3)
+     call i64 %5, see(i64 10)
+     mov i64 %6, [%2]
+     call i64 %7, see(i64 %6)
+     ret i64 %2
+.msg: lit u8 104
+     lit u8 0
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.define_native(global("new_cells"), (void*)new_cells);
+    obj.define_native(global("see"), (void*)see);
+    obj.load();
+    auto f = (i64*(*)(i64))obj.find(global("f"));
+    ASSERT_EQUAL(f(42), cells);
+    ASSERT_EQUAL(n_seen, 3);
+    ASSERT_EQUAL(seen[0], 42);
+    ASSERT_EQUAL(seen[1], 10);
+    ASSERT_EQUAL(seen[2], 3);
+    ASSERT_EQUAL(cells[1], 42);
+    ASSERT_EQUAL(*(const char*)cells[2], 'h');
+}
+
+TEST(x86_switch) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+foo:  frame
+      param i64 %0
+      mov i64 %1, 100
+      switch i64 other %0, -2 (neg, other, zero, other, other, five)
+neg:  add i64 %1, %1, 1
+      jump end
+zero: add i64 %1, %1, 2
+      jump end
+five: sub i64 %1, %1, %0
+      jump end
+other: mov i64 %1, %0
+end:  ret i64 %1
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.load();
+    auto foo = (i64(*)(i64))obj.find(global("foo"));
+    ASSERT_EQUAL(foo(-2), 101);
+    ASSERT_EQUAL(foo(0), 102);
+    ASSERT_EQUAL(foo(3), 97);
+    const i64 others[] = { -3, -1, 1, 2, 4, 1l << 40, -(1l << 40) };
+    for (i64 i : others) ASSERT_EQUAL(foo(i), i);
+}
+
+TEST(x86_memory_operands) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+foo:  frame
+      param i64 %0
+      mov i64 %1, [%0 + 8]
+      add i64 [%0], %1, [%0 + 16]
+      sub i64 [%0 + 8], [%0 + 16], [%0]
+      jl i64 less [%0 + 8], [%0 + 16]
+      ret i64 0
+less: ret i64 1
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.load();
+    auto foo = (i64(*)(i64*))obj.find(global("foo"));
+    i64 cells[3] = { 0, 3, 4 };
+    ASSERT_EQUAL(foo(cells), 1);
+    ASSERT_EQUAL(cells[0], 7);
+    ASSERT_EQUAL(cells[1], -3);
+    ASSERT_EQUAL(cells[2], 4);
+}
+
+extern "C" i64 digits(i64 a, i64 b, i64 c) {
+    return a * 100 + b * 10 + c;
+}
+
+TEST(x86_shuffled_arguments) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+foo:  frame
+      param i64 %0
+      param i64 %1
+      param i64 %2
+      call i64 %3, digits(i64 %1, i64 %2, i64 %0)
+      call i64 %4, digits(i64 %2, i64 %0, i64 %1)
+      call i64 %5, digits(i64 %1, i64 %0, i64 %2)
+      call i64 %6, digits(i64 %2, i64 7, i64 %0)
+      add i64 %7, %3, %4
+      add i64 %7, %7, %5
+      add i64 %7, %7, %6
+      ret i64 %7
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.define_native(global("digits"), (void*)digits);
+    obj.load();
+    auto foo = (i64(*)(i64, i64, i64))obj.find(global("foo"));
+    ASSERT_EQUAL(foo(1, 2, 3), 231 + 312 + 213 + 371);
+}
+
+static u32 misaligned_calls = 0;
+
+// The frame address is rsp on entry less the return address, so it's 16-byte aligned
+// exactly when the call site was.
+extern "C" i64 aligned_id(i64 a) {
+    if ((u64)__builtin_frame_address(0) % 16) misaligned_calls ++;
+    return a;
+}
+
+extern "C" i64 aligned_sum(i64 a, i64 b, i64 c, i64 d, i64 e, i64 f, i64 g, i64 h) {
+    if ((u64)__builtin_frame_address(0) % 16) misaligned_calls ++;
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f + 7 * g + 8 * h;
+}
+
+TEST(x86_aligned_calls) {
+    onlyin(X86_64);
+    buffer in;
+    write(in,R"(
+foo:  frame
+      param i64 %0
+      call i64 %1, aligned_id(i64 %0)
+      call i64 %2, aligned_sum(i64 %0, i64 %1, i64 1, i64 1, i64 1, i64 1, i64 1, i64 2)
+      call i64 %3, aligned_id(i64 %2)
+      add i64 %4, %3, %0
+      add i64 %4, %4, %1
+      ret i64 %4
+bar:  frame
+      param i64 %5
+      call i64 %6, aligned_id(i64 %5)
+      ret i64 %6
+)");
+    Context ctx;
+    vector<Insn> insns = parse_all_insns(ctx, in);
+    Object obj = compile_jasmine(ctx, insns, DEFAULT_TARGET);
+    obj.define_native(global("aligned_id"), (void*)aligned_id);
+    obj.define_native(global("aligned_sum"), (void*)aligned_sum);
+    obj.load();
+    auto foo = (i64(*)(i64))obj.find(global("foo"));
+    auto bar = (i64(*)(i64))obj.find(global("bar"));
+    ASSERT_EQUAL(foo(5), 56 + 5 + 5);
+    ASSERT_EQUAL(bar(9), 9);
+    ASSERT_EQUAL(misaligned_calls, 0);
+}
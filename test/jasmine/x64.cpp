@@ -123,11 +123,16 @@ TEST(extends) {
         movsx(r16(RAX), r8(RAX));
         movzx(r32(RAX), r16(RAX));
         ret();
+    label(global("widen"), OS_CODE);
+        mov(r64(RAX), imm(-1));
+        movsx(r64(RAX), r32(RDI));
+        ret();
 
     obj.load();
     auto add_zerox = (i32(*)(i8, i8))obj.find(global("add_zerox"));
     auto add_signx = (i32(*)(i8, i8))obj.find(global("add_signx"));
     auto foo = (i32(*)())obj.find(global("foo"));
+    auto widen = (i64(*)(i32))obj.find(global("widen"));
 
     ASSERT_EQUAL(add_zerox(0, 0), 0);
     ASSERT_EQUAL(add_zerox(10, 20), 30);
@@ -135,6 +140,8 @@ TEST(extends) {
     ASSERT_EQUAL(add_zerox(64, 64), 128);
     ASSERT_EQUAL(add_signx(64, 64), -128);
     ASSERT_EQUAL(foo(), 65535);
+    ASSERT_EQUAL(widen(7), 7);
+    ASSERT_EQUAL(widen(-7), -7);
 }
 
 TEST(indexing) {
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "runtime/sys.h"
+#include "test.h"
+#include "string.h"
+#include "stdio.h"
+
+// Lays out 'str' the way the runtime expects, with its length plus one in the four
+// bytes before it.
+static const char* runtime_string(const char* str) {
+    u32 n = strlen(str);
+    char* buf = (char*)sys::alloc(n + 5) + 4;
+    *(u32*)(buf - 4) = n + 1;
+    memcpy(buf, str, n);
+    return buf;
+}
+
+TEST(word_keys) {
+    sys::dict* d = sys::dict_new(0);
+    ASSERT_EQUAL(d->size, 0);
+    ASSERT_EQUAL(sys::dict_find_word(d, 0), nullptr);
+    for (u64 i = 0; i < 10000; i ++) *sys::dict_insert_word(d, i << 32) = i * 3;
+    ASSERT_EQUAL(d->size, 10000);
+    for (u64 i = 0; i < 10000; i ++) {
+        u64* value = sys::dict_find_word(d, i << 32);
+        ASSERT_NOT_EQUAL(value, nullptr);
+        ASSERT_EQUAL(*value, i * 3);
+    }
+    ASSERT_EQUAL(sys::dict_find_word(d, 1), nullptr);
+    ASSERT_EQUAL(sys::dict_find_word(d, 10000ull << 32), nullptr);
+}
+
+TEST(insert_existing_key) {
+    sys::dict* d = sys::dict_new(4);
+    *sys::dict_insert_word(d, 42) = 1;
+    u64* slot = sys::dict_insert_word(d, 42);
+    ASSERT_EQUAL(*slot, 1);
+    *slot = 2;
+    ASSERT_EQUAL(d->size, 1);
+    ASSERT_EQUAL(*sys::dict_find_word(d, 42), 2);
+}
+
+TEST(string_keys) {
+    sys::dict* d = sys::dict_new(0);
+    char buf[64];
+    for (u32 i = 0; i < 2000; i ++) {
+        snprintf(buf, sizeof(buf), "key number %u", i);
+        *sys::dict_insert_string(d, runtime_string(buf)) = i;
+    }
+    *sys::dict_insert_string(d, runtime_string("")) = 12345;
+    ASSERT_EQUAL(d->size, 2001);
+    for (u32 i = 0; i < 2000; i ++) {
+        snprintf(buf, sizeof(buf), "key number %u", i);
+        u64* value = sys::dict_find_string(d, runtime_string(buf)); // same contents, different pointer
+        ASSERT_NOT_EQUAL(value, nullptr);
+        ASSERT_EQUAL(*value, i);
+    }
+    ASSERT_EQUAL(*sys::dict_find_string(d, runtime_string("")), 12345);
+    ASSERT_EQUAL(sys::dict_find_string(d, runtime_string("key number")), nullptr);
+    ASSERT_EQUAL(sys::dict_find_string(d, runtime_string("key number 2000")), nullptr);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "runtime/sys.h"
+#include "test.h"
+#include "string.h"
+
+static u8 src[8192], dst[8192], expected[8192];
+
+SETUP {
+    _sys_detect_cpu();
+    for (u32 i = 0; i < sizeof(src); i ++) src[i] = i * 7 + 3;
+}
+
+TEST(memcpy_sizes_and_alignments) {
+    const u32 sizes[] = {0, 1, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 100, 255, 2047, 2048, 4000};
+    for (u32 n : sizes)
+        for (u32 off = 0; off < 33; off ++) {
+            memset(dst, 0, sizeof(dst));
+            memset(expected, 0, sizeof(expected));
+            memcpy(expected + off, src + 5, n);
+            ASSERT_EQUAL(_sys_memcpy(dst + off, src + 5, n), n);
+            ASSERT_EQUAL(memcmp(dst, expected, sizeof(dst)), 0);
+        }
+}
+
+TEST(memmove_overlapping) {
+    const u32 sizes[] = {3, 12, 20, 32, 40, 100, 3000};
+    const i32 shifts[] = {-17, -16, -3, -1, 1, 3, 16, 33};
+    for (u32 n : sizes)
+        for (i32 shift : shifts) {
+            memcpy(dst, src, sizeof(dst));
+            memcpy(expected, src, sizeof(expected));
+            memmove(expected + 100 + shift, expected + 100, n);
+            ASSERT_EQUAL(_sys_memmove(dst + 100 + shift, dst + 100, n), dst + 100 + shift);
+            ASSERT_EQUAL(memcmp(dst, expected, sizeof(dst)), 0);
+        }
+}
+
+TEST(memset_bounds) {
+    const u32 sizes[] = {0, 1, 7, 8, 9, 16, 17, 40, 2048, 3001};
+    for (u32 n : sizes)
+        for (u32 off = 0; off < 17; off ++) {
+            memcpy(dst, src, sizeof(dst));
+            memcpy(expected, src, sizeof(expected));
+            memset(expected + off, 0xab, n);
+            _sys_memset(dst + off, 0xab, n);
+            ASSERT_EQUAL(memcmp(dst, expected, sizeof(dst)), 0);
+        }
+}
+
+TEST(memchr_respects_length) {
+    u8 buf[128] = {};
+    for (u32 off = 0; off < 16; off ++)
+        for (u32 pos = 0; pos < 64; pos ++) {
+            buf[off + pos] = 'x';
+            ASSERT_EQUAL(_sys_memchr(buf + off, 'x', 64), buf + off + pos);
+            ASSERT_EQUAL(_sys_memchr(buf + off, 'x', pos), nullptr); // match just past the end
+            ASSERT_EQUAL(_sys_memchr(buf + off, 'y', 64), nullptr);
+            buf[off + pos] = 0;
+        }
+}
+
+TEST(strlen_alignments) {
+    char buf[128];
+    memset(buf, 'a', sizeof(buf));
+    for (u32 off = 0; off < 16; off ++)
+        for (u32 len = 0; len < 80; len ++) {
+            buf[off + len] = '\0';
+            ASSERT_EQUAL(_sys_strlen(buf + off), len);
+            buf[off + len] = 'a';
+        }
+}
+
+TEST(alloc_aligned_and_zeroed) {
+    u8* prev = nullptr;
+    for (u32 size = 1; size < 5000; size += 97) {
+        u8* p = (u8*)sys::alloc(size);
+        ASSERT_EQUAL(u64(p) % 16, 0);
+        for (u32 i = 0; i < size; i ++) ASSERT_EQUAL(p[i], 0);
+        memset(p, 0xab, size);
+        if (prev) ASSERT_NOT_EQUAL(p, prev);
+        prev = p;
+    }
+    u8* big = (u8*)sys::alloc(3 << 20); // gets its own mapping
+    big[0] = big[(3 << 20) - 1] = 1;
+    ASSERT_EQUAL(u64(big) % 16, 0);
+}
+
+TEST(memcmp_finds_first_difference) {
+    memcpy(dst, src, sizeof(dst));
+    ASSERT_EQUAL(_sys_memcmp(dst, src, sizeof(dst)), 0);
+    for (u32 n = 1; n < 80; n ++)
+        for (u32 pos = 0; pos < n; pos ++) {
+            dst[pos] = src[pos] ^ 0x10;
+            ASSERT_EQUAL(_sys_memcmp(dst, src, n), i64(dst[pos]) - i64(src[pos]));
+            ASSERT_EQUAL(_sys_memcmp(src, dst, n), i64(src[pos]) - i64(dst[pos]));
+            ASSERT_EQUAL(_sys_memcmp(dst, src, pos), 0); // difference just past the end
+            dst[pos] = src[pos];
+        }
+}
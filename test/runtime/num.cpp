@@ -0,0 +1,196 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "runtime/sys.h"
+#include "test.h"
+#include "string.h"
+#include "stdlib.h"
+#include "stdio.h"
+
+static u64 state = 0x9e3779b97f4a7c15ull;
+
+static u64 next() {
+    state ^= state << 13, state ^= state >> 7, state ^= state << 17;
+    return state;
+}
+
+static u64 bits_of(double d) {
+    u64 u;
+    memcpy(&u, &d, 8);
+    return u;
+}
+
+static double double_of(u64 u) {
+    double d;
+    memcpy(&d, &u, 8);
+    return d;
+}
+
+static bool formats_as(double d, const char* expected) {
+    char buf[32];
+    u32 n = sys::format_double(buf, d);
+    return n == strlen(expected) && !memcmp(buf, expected, n);
+}
+
+static u32 significant_digits(const char* s) {
+    u32 first = 0, last = 0, i = 0;
+    for (; s[i] && s[i] != 'e'; i ++) if (s[i] >= '1' && s[i] <= '9') {
+        if (!first) first = i + 1;
+        last = i + 1;
+    }
+    u32 n = 0;
+    for (i = first - 1; i < last; i ++) if (s[i] != '.') n ++;
+    return n;
+}
+
+TEST(parse_digits_full_range) {
+    const char* inputs[] = {"0", "7", "12345678", "123456789", "18446744073709551615", "18446744073709551616",
+                            "99999999999999999999999", "00000000000000000042x"};
+    const u64 values[] = {0, 7, 12345678, 123456789, 0xffffffffffffffffull, 0xffffffffffffffffull,
+                          0xffffffffffffffffull, 42};
+    for (u32 i = 0; i < sizeof(values) / sizeof(u64); i ++) {
+        u64 acc = 0;
+        u32 n = strlen(inputs[i]);
+        ASSERT_EQUAL(sys::parse_digits(inputs[i], n, acc), inputs[i][n - 1] == 'x' ? n - 1 : n);
+        ASSERT_EQUAL(acc, values[i]);
+    }
+    for (u32 i = 0; i < 10000; i ++) {
+        u64 u = next() >> (next() % 64);
+        char buf[32];
+        u32 n = snprintf(buf, sizeof(buf), "%llu", (unsigned long long)u), acc_len;
+        u64 acc = 0;
+        acc_len = sys::parse_digits(buf, n, acc);
+        ASSERT_EQUAL(acc_len, n);
+        ASSERT_EQUAL(acc, u);
+    }
+}
+
+TEST(format_double_layout) {
+    ASSERT_TRUE(formats_as(0.0, "0.0"));
+    ASSERT_TRUE(formats_as(-0.0, "-0.0"));
+    ASSERT_TRUE(formats_as(3.0, "3.0"));
+    ASSERT_TRUE(formats_as(0.5, "0.5"));
+    ASSERT_TRUE(formats_as(0.1, "0.1"));
+    ASSERT_TRUE(formats_as(-2.75, "-2.75"));
+    ASSERT_TRUE(formats_as(0.0001, "0.0001"));
+    ASSERT_TRUE(formats_as(1e-7, "1.0e-7"));
+    ASSERT_TRUE(formats_as(1e16, "1.0e16"));
+    ASSERT_TRUE(formats_as(1.5e300, "1.5e300"));
+    ASSERT_TRUE(formats_as(123456789012345.0, "123456789012345.0"));
+    ASSERT_TRUE(formats_as(5e-324, "5.0e-324"));
+    ASSERT_TRUE(formats_as(1.7976931348623157e308, "1.7976931348623157e308"));
+    ASSERT_TRUE(formats_as(double_of(0x7ff0000000000000ull), "inf"));
+    ASSERT_TRUE(formats_as(double_of(0xfff0000000000000ull), "-inf"));
+    ASSERT_TRUE(formats_as(double_of(0x7ff8000000000000ull), "nan"));
+
+    char buf[32];
+    u32 n = sys::format_float(buf, 0.1f);
+    ASSERT_EQUAL(n, 3);
+    ASSERT_EQUAL(memcmp(buf, "0.1", 3), 0);
+}
+
+TEST(format_double_round_trips) {
+    char buf[40];
+    u32 longer = 0;
+    for (u32 i = 0; i < 100000; i ++) {
+        u64 u = next();
+        if ((u >> 52 & 0x7ff) == 0x7ff) continue;
+        u32 n = sys::format_double(buf, double_of(u));
+        buf[n] = '\0';
+        ASSERT_EQUAL(bits_of(strtod(buf, nullptr)), u);
+
+        // grisu2 misses the shortest string that round-trips in a small fraction of cases
+        u32 shortest = 1;
+        for (char tmp[40]; shortest < 17; shortest ++) {
+            snprintf(tmp, sizeof(tmp), "%.*e", shortest - 1, double_of(u));
+            if (bits_of(strtod(tmp, nullptr)) == u) break;
+        }
+        ASSERT_TRUE(significant_digits(buf) <= 17);
+        if (significant_digits(buf) > shortest) longer ++;
+    }
+    ASSERT_TRUE(longer < 200);
+    for (u32 i = 0; i < 100000; i ++) {
+        u32 u = next();
+        float f;
+        memcpy(&f, &u, 4);
+        if ((u >> 23 & 0xff) == 0xff) continue;
+        u32 n = sys::format_float(buf, f);
+        buf[n] = '\0';
+        float g = strtof(buf, nullptr);
+        ASSERT_EQUAL(memcmp(&f, &g, 4), 0);
+    }
+}
+
+TEST(parse_double_matches_strtod) {
+    const char* inputs[] = {
+        "0", "-0.0", "1", "3.14159", "1e10", "1E-10", "2.2250738585072011e-308", "2.2250738585072014e-308",
+        "4.9406564584124654e-324", "2.4703282292062327e-324", "2.4703282292062328e-324", "1.7976931348623157e308",
+        "1.7976931348623159e308", "1e309", "1e-400", "9007199254740993", "123456789012345678901234567890",
+        "0.000000000000000000000000000001", "7.038531e-26", "8.988465674311579e307", ".5", "5.", "00012.5000",
+        "1.00000000000000011102230246251565404236316680908203125",
+        "1.00000000000000011102230246251565404236316680908203124",
+        "1.00000000000000011102230246251565404236316680908203126"
+    };
+    for (const char* input : inputs) {
+        double d = 1.0;
+        ASSERT_EQUAL(sys::parse_double(input, strlen(input), d), strlen(input));
+        ASSERT_EQUAL(bits_of(d), bits_of(strtod(input, nullptr)));
+    }
+
+    char buf[64];
+    for (u32 i = 0; i < 100000; i ++) {
+        u32 n = snprintf(buf, sizeof(buf), "%.*e", (int)(next() % 20), double_of(next() & 0x7fefffffffffffffull));
+        double d;
+        ASSERT_EQUAL(sys::parse_double(buf, n, d), n);
+        ASSERT_EQUAL(bits_of(d), bits_of(strtod(buf, nullptr)));
+    }
+    for (u32 i = 0; i < 100000; i ++) {
+        u32 n = snprintf(buf, sizeof(buf), "%.*e", (int)(next() % 12), double_of(next() & 0x7fefffffffffffffull));
+        float f;
+        ASSERT_EQUAL(sys::parse_float(buf, n, f), n);
+        float g = strtof(buf, nullptr);
+        ASSERT_EQUAL(memcmp(&f, &g, 4), 0);
+    }
+}
+
+TEST(parse_double_long_inputs) {
+    // more digits than the parser keeps, both before and after the point
+    static char buf[2048];
+    const char* suffixes[] = { "e-700", "e-809", "e-1000", "", ".5e-500" };
+    const char digits[] = { '1', '9', '5' };
+    for (char digit : digits) for (const char* suffix : suffixes) {
+        u32 n = 0;
+        for (u32 i = 0; i < 810; i ++) buf[n ++] = digit;
+        n += snprintf(buf + n, sizeof(buf) - n, "%s", suffix);
+        double d;
+        ASSERT_EQUAL(sys::parse_double(buf, n, d), n);
+        ASSERT_EQUAL(bits_of(d), bits_of(strtod(buf, nullptr)));
+    }
+
+    u32 n = snprintf(buf, sizeof(buf), "0.");
+    for (u32 i = 0; i < 900; i ++) buf[n ++] = i < 300 ? '0' : '3';
+    buf[n] = '\0';
+    double d;
+    ASSERT_EQUAL(sys::parse_double(buf, n, d), n);
+    ASSERT_EQUAL(bits_of(d), bits_of(strtod(buf, nullptr)));
+}
+
+TEST(parse_double_stops_at_end) {
+    double d;
+    ASSERT_EQUAL(sys::parse_double("12.5e3x", 7, d), 6);
+    ASSERT_EQUAL(d, 12500.0);
+    ASSERT_EQUAL(sys::parse_double("2e+", 3, d), 1);
+    ASSERT_EQUAL(d, 2.0);
+    ASSERT_EQUAL(sys::parse_double("1.5", 2, d), 2);
+    ASSERT_EQUAL(d, 1.0);
+    ASSERT_EQUAL(sys::parse_double("-inf", 4, d), 4);
+    ASSERT_EQUAL(bits_of(d), 0xfff0000000000000ull);
+    ASSERT_EQUAL(sys::parse_double("abc", 3, d), 0);
+    ASSERT_EQUAL(sys::parse_double(".", 1, d), 0);
+}
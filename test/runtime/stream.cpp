@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "runtime/sys.h"
+#include "test.h"
+#include "string.h"
+#include "stdio.h"
+#include "unistd.h"
+
+SETUP {
+    sys::init_io();
+}
+
+TEST(handles_are_reused) {
+    unlink("/tmp/basil_stream_reuse");
+    i64 a = sys::open("/tmp/basil_stream_reuse", BASIL_READ | BASIL_WRITE);
+    ASSERT_GREATER(a, BASIL_STDERR_FD);
+    sys::close(a);
+    i64 b = sys::open("/tmp/basil_stream_reuse", BASIL_READ, BASIL_STREAMBUF_LARGE);
+    ASSERT_EQUAL(a, b);
+    sys::close(b);
+    sys::close(b); // closing twice does nothing
+    ASSERT_EQUAL(sys::open("/tmp/basil_stream_missing/file", BASIL_READ), -1);
+}
+
+TEST(many_open_streams) {
+    i64 handles[300];
+    unlink("/tmp/basil_stream_many");
+    for (u32 i = 0; i < 300; i ++) {
+        handles[i] = sys::open("/tmp/basil_stream_many", BASIL_READ | BASIL_WRITE, i % 2 ? BASIL_STREAMBUF_SMALL : 0);
+        ASSERT_GREATER(handles[i], BASIL_STDERR_FD);
+        for (u32 j = 0; j < i; j ++) ASSERT_NOT_EQUAL(handles[i], handles[j]);
+    }
+    for (u32 i = 0; i < 300; i ++) sys::close(handles[i]);
+    for (u32 i = 0; i < 300; i ++) {
+        i64 h = sys::open("/tmp/basil_stream_many", BASIL_READ);
+        bool reused = false;
+        for (u32 j = 0; j < 300; j ++) if (h == handles[j]) reused = true;
+        ASSERT_TRUE(reused);
+    }
+}
+
+TEST(buffer_sizes_preserve_output) {
+    const u32 sizes[] = {1, BASIL_STREAMBUF_SMALL, BASIL_STREAMBUF_DEFAULT, BASIL_STREAMBUF_LARGE, 1000000};
+    static char expected[1 << 20];
+    for (u32 size : sizes) {
+        char path[64];
+        snprintf(path, sizeof(path), "/tmp/basil_stream_size_%u", size);
+        unlink(path);
+        i64 h = sys::open(path, BASIL_READ | BASIL_WRITE, size);
+        u32 n = 0;
+        for (u32 i = 0; i < 50000; i ++) {
+            sys::write_uint(sys::io_for_fd(h), i * 7919);
+            sys::write_byte(sys::io_for_fd(h), ' ');
+            n += snprintf(expected + n, sizeof(expected) - n, "%u ", i * 7919);
+        }
+        sys::close(h);
+
+        const char* contents = sys::map_file(path);
+        ASSERT_EQUAL(*(const u32*)(contents - 4) - 1, n);
+        ASSERT_EQUAL(memcmp(contents, expected, n), 0);
+        sys::unmap(contents);
+    }
+}
+
+TEST(unmap_ignores_unmapped_strings) {
+    unlink("/tmp/basil_stream_unmap");
+    i64 h = sys::open("/tmp/basil_stream_unmap", BASIL_WRITE);
+    sys::write_string(sys::io_for_fd(h), "hello", 5);
+    sys::close(h);
+    const char* mapped = sys::map_file("/tmp/basil_stream_unmap");
+    ASSERT_EQUAL(sys::string_length(mapped), 5);
+
+    const char* joined = sys::string_concat(mapped, mapped);
+    const char* part = sys::string_slice(mapped, 1, 3);
+    alignas(4096) static char page[8192]; // page-aligned, but not one of ours
+    *(u32*)(page + 4092) = 2;
+    page[4096] = 'x';
+    sys::unmap(joined);
+    sys::unmap(part);
+    sys::unmap(page + 4096);
+    sys::unmap(sys::empty_string);
+    ASSERT_EQUAL(memcmp(joined, "hellohello", 10), 0);
+    ASSERT_EQUAL(memcmp(part, "el", 2), 0);
+    ASSERT_EQUAL(page[4096], 'x');
+    sys::unmap(mapped);
+}
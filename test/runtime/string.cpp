@@ -0,0 +1,79 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "runtime/sys.h"
+#include "test.h"
+#include "string.h"
+
+static const char* str(const char* s, u32 n) {
+    return sys::string_new(s, n);
+}
+
+static const char* str(const char* s) {
+    return str(s, strlen(s));
+}
+
+SETUP {
+    _sys_detect_cpu();
+}
+
+TEST(new_and_length) {
+    const char* s = str("hello");
+    ASSERT_EQUAL(sys::string_length(s), 5);
+    ASSERT_EQUAL(s[5], '\0');
+    ASSERT_EQUAL(memcmp(s, "hello", 5), 0);
+    ASSERT_EQUAL(str(""), sys::empty_string);
+}
+
+TEST(concat) {
+    const char *a = str("a fairly long string, "), *b = str("followed by another one");
+    const char* c = sys::string_concat(a, b);
+    ASSERT_EQUAL(sys::string_length(c), 45);
+    ASSERT_TRUE(sys::string_equal(c, str("a fairly long string, followed by another one")));
+    ASSERT_EQUAL(c[45], '\0');
+    ASSERT_EQUAL(sys::string_concat(a, sys::empty_string), a); // shared, not copied
+    ASSERT_EQUAL(sys::string_concat(sys::empty_string, b), b);
+}
+
+TEST(compare) {
+    ASSERT_EQUAL(sys::string_compare(str("abc"), str("abc")), 0);
+    ASSERT_LESS(sys::string_compare(str("abc"), str("abd")), 0);
+    ASSERT_GREATER(sys::string_compare(str("abd"), str("abc")), 0);
+    ASSERT_LESS(sys::string_compare(str("ab"), str("abc")), 0); // prefixes come first
+    ASSERT_LESS(sys::string_compare(sys::empty_string, str("a")), 0);
+    ASSERT_GREATER(sys::string_compare(str("0123456789abcdefghij"), str("0123456789abcdefghiJ")), 0);
+    ASSERT_FALSE(sys::string_equal(str("abc"), str("abcd")));
+    ASSERT_TRUE(sys::string_equal(str("0123456789abcdefghij"), str("0123456789abcdefghij")));
+}
+
+TEST(slice) {
+    const char* s = str("hello world");
+    ASSERT_TRUE(sys::string_equal(sys::string_slice(s, 6, 11), str("world")));
+    ASSERT_EQUAL(sys::string_slice(s, 0, 11), s);
+    ASSERT_EQUAL(sys::string_slice(s, -4, 100), s); // bounds are clamped
+    ASSERT_EQUAL(sys::string_slice(s, 7, 3), sys::empty_string);
+    ASSERT_EQUAL(sys::string_slice(s, 2, 5)[3], '\0');
+}
+
+TEST(code_points) {
+    const char* s = str("na\xc3\xafve caf\xc3\xa9, and some more ascii text");
+    ASSERT_EQUAL(sys::string_chars(s), 36);
+    ASSERT_EQUAL(sys::string_chars(sys::empty_string), 0);
+    ASSERT_TRUE(sys::string_equal(sys::string_slice_chars(s, 2, 4), str("\xc3\xafv")));
+    ASSERT_TRUE(sys::string_equal(sys::string_slice_chars(s, 6, 10), str("caf\xc3\xa9")));
+    ASSERT_TRUE(sys::string_equal(sys::string_slice_chars(s, 26, 100), str("ascii text")));
+    ASSERT_EQUAL(sys::string_slice_chars(s, -1, 36), s);
+    ASSERT_EQUAL(sys::string_slice_chars(s, 40, 50), sys::empty_string);
+}
+
+TEST(hash) {
+    ASSERT_EQUAL(sys::string_hash(str("some key")), sys::string_hash(str("some key")));
+    ASSERT_NOT_EQUAL(sys::string_hash(str("some key")), sys::string_hash(str("some kez")));
+    ASSERT_NOT_EQUAL(sys::string_hash(str("ab")), sys::string_hash(str("ab\0", 3)));
+}
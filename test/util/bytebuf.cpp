@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "util/bytebuf.h"
+#include "test.h"
+
+TEST(typed_round_trip) {
+    bytebuf b;
+    b.write<u8>(1);
+    b.write<u32>(0xdeadbeef);
+    b.write<i64>(-42);
+    b.write<double>(2.5);
+    ASSERT_EQUAL(b.size(), 21);
+    ASSERT_EQUAL(b.read<u8>(), 1);
+    ASSERT_EQUAL(b.read<u32>(), 0xdeadbeef);
+    ASSERT_EQUAL(b.read<i64>(), -42);
+    ASSERT_EQUAL(b.read<double>(), 2.5);
+    ASSERT_EQUAL(b.size(), 0);
+    ASSERT_EQUAL(b.read<u32>(), 0); // empty buffer reads as zeroes
+}
+
+TEST(bulk_wraparound) {
+    bytebuf b;
+    u8 in[100], out[100];
+    for (u32 i = 0; i < 100; i ++) in[i] = i;
+    b.write(in, 20);
+    b.read(out, 15);
+    b.write(in + 20, 20); // wraps around the end of the initial 32 bytes
+    ASSERT_EQUAL(b.size(), 25);
+    b.write(in + 40, 60); // grows while wrapped
+    ASSERT_EQUAL(b.size(), 85);
+    b.read(out + 15, 85);
+    for (u32 i = 0; i < 100; i ++) ASSERT_EQUAL(out[i], i);
+}
+
+TEST(append) {
+    bytebuf a, b;
+    a.write("hello ", 6);
+    b.write("world", 5);
+    a.append(b);
+    a.append(a);
+    ASSERT_EQUAL(b.size(), 5);
+    char out[23] = {0};
+    a.read(out, 22);
+    ASSERT_EQUAL(string(out), "hello worldhello world");
+}
+
+TEST(varints) {
+    bytebuf b;
+    u64 values[] = { 0, 1, 127, 128, 300, 0xffffffff, 0xffffffffffffffffull };
+    for (u64 v : values) b.write_varint(v);
+    b.write_svarint(-1);
+    b.write_svarint(-1000000);
+    b.write_svarint(63);
+    ASSERT_EQUAL(b.size(), 1 + 1 + 1 + 2 + 2 + 5 + 10 + 1 + 3 + 1);
+    for (u64 v : values) ASSERT_EQUAL(b.read_varint(), v);
+    ASSERT_EQUAL(b.read_svarint(), -1);
+    ASSERT_EQUAL(b.read_svarint(), -1000000);
+    ASSERT_EQUAL(b.read_svarint(), 63);
+}
+
+TEST(reader) {
+    bytebuf b;
+    b.write<u16>(7);
+    b.write_varint(1000);
+    b.write("abc", 3);
+    u8 bytes[32];
+    u64 n = b.size();
+    b.peek(bytes, n);
+    ASSERT_EQUAL(b.size(), n); // peek doesn't consume
+
+    bytereader r(bytes, n);
+    ASSERT_EQUAL(r.read<u16>(), 7);
+    ASSERT_EQUAL(r.read_varint(), 1000);
+    const u8* abc = r.view(3);
+    ASSERT_TRUE(abc == bytes + n - 3);
+    ASSERT_EQUAL(r.size(), 0);
+    ASSERT_TRUE(r.view(1) == nullptr);
+    ASSERT_EQUAL(r.read(), 0);
+}
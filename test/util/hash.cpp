@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "test.h"
+#include "util/hash.h"
+
+TEST(empty_map) {
+    map<u32, u32> m;
+    ASSERT_EQUAL(m.size(), 0);
+    ASSERT_FALSE(m.contains(0));
+    ASSERT_TRUE(m.begin() == m.end());
+}
+
+TEST(put_and_overwrite) {
+    map<ustring, i64> m;
+    m.put("a", 1);
+    m.put("b", 2);
+    m["c"] = 3;
+    m.put("a", 4);
+    ASSERT_EQUAL(m.size(), 3);
+    ASSERT_EQUAL(m["a"], 4);
+    ASSERT_EQUAL(m["b"], 2);
+    ASSERT_EQUAL(m["c"], 3);
+}
+
+TEST(many_elements) {
+    set<u64> s;
+    for (u64 i = 0; i < 10000; i ++) s.insert(i * 7);
+    ASSERT_EQUAL(s.size(), 10000);
+    for (u64 i = 0; i < 70000; i ++) ASSERT_EQUAL(s.contains(i), i % 7 == 0);
+
+    u64 count = 0, sum = 0;
+    for (u64 i : s) count ++, sum += i;
+    ASSERT_EQUAL(count, 10000);
+    ASSERT_EQUAL(sum, 7 * (9999 * 10000 / 2));
+}
+
+TEST(erase_and_reinsert) {
+    map<u32, u32> m;
+    for (u32 round = 0; round < 20; round ++) { // lots of churn should reuse deleted slots, not grow forever
+        for (u32 i = 0; i < 100; i ++) m.put(round * 100 + i, i);
+        for (u32 i = 0; i < 100; i ++) m.erase(round * 100 + i);
+        ASSERT_EQUAL(m.size(), 0);
+    }
+    ASSERT_TRUE(m.capacity() <= 256);
+    for (u32 i = 0; i < 100; i ++) m.put(i, i * 2);
+    for (u32 i = 0; i < 100; i += 2) m.erase(i);
+    for (u32 i = 0; i < 100; i ++) {
+        ASSERT_EQUAL(m.contains(i), i % 2 == 1);
+        if (i % 2) ASSERT_EQUAL(m[i], i * 2);
+    }
+}
+
+TEST(copy_and_move) {
+    map<ustring, ustring> a;
+    for (u32 i = 0; i < 50; i ++) a.put(::format<ustring>(i), ::format<ustring>("value ", i));
+    map<ustring, ustring> b = a;
+    b.put("0", "changed");
+    ASSERT_EQUAL(a["0"], "value 0");
+    ASSERT_EQUAL(b["0"], "changed");
+    ASSERT_EQUAL(b["49"], "value 49");
+
+    map<ustring, ustring> c = static_cast<map<ustring, ustring>&&>(b);
+    ASSERT_EQUAL(c.size(), 50);
+    ASSERT_EQUAL(b.size(), 0);
+    ASSERT_EQUAL(c["49"], "value 49");
+}
+
+TEST(raw_hash_lengths) {
+    // every prefix, across the short, medium and bulk paths, hashes differently
+    u8 bytes[100];
+    for (u32 i = 0; i < 100; i ++) bytes[i] = 'a';
+    set<u64> hashes;
+    for (u32 i = 0; i <= 100; i ++) hashes.insert(raw_hash(bytes, i));
+    ASSERT_EQUAL(hashes.size(), 101);
+    ASSERT_EQUAL(raw_hash(bytes, 50), raw_hash(bytes + 50, 50));
+    ASSERT_NOT_EQUAL(raw_hash(u32(1)), raw_hash(u32(2)));
+    ASSERT_EQUAL(raw_hash(u64(7)), word_hash(7));
+}
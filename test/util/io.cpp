@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "util/io.h"
+#include "util/str.h"
+#include "test.h"
+
+TEST(format_integers) {
+    ASSERT_EQUAL(format<string>(0), "0");
+    ASSERT_EQUAL(format<string>(7u), "7");
+    ASSERT_EQUAL(format<string>(10), "10");
+    ASSERT_EQUAL(format<string>(-305), "-305");
+    ASSERT_EQUAL(format<string>(u64(18446744073709551615ull)), "18446744073709551615");
+    ASSERT_EQUAL(format<string>(i64(-9223372036854775807ll - 1)), "-9223372036854775808");
+}
+
+TEST(format_floats) {
+    ASSERT_EQUAL(format<string>(1.5), "1.5");
+    ASSERT_EQUAL(format<string>(-2.0), "-2.0");
+    ASSERT_EQUAL(format<string>(0.25f), "0.25");
+    ASSERT_EQUAL(format<string>(100.001), "100.001");
+}
+
+TEST(buffer_bulk) {
+    buffer b;
+    u8 in[40], out[40];
+    for (u32 i = 0; i < 40; i ++) in[i] = 'a' + i % 26;
+    b.write(in, 5);
+    ASSERT_EQUAL(b.read(out, 3), 3);
+    b.write(in + 5, 35); // grows while wrapped around
+    ASSERT_EQUAL(b.size(), 37);
+    ASSERT_EQUAL(b.read(out + 3, 40), 37);
+    for (u32 i = 0; i < 40; i ++) ASSERT_EQUAL(out[i], in[i]);
+}
+
+TEST(write_wrapped_buffer) {
+    buffer a, b;
+    write(a, "abcdef");
+    a.read(), a.read(), a.read();
+    write(a, "ghi"); // wraps around the end of the inline storage
+    write(b, a);
+    ASSERT_EQUAL(string(b), "defghi");
+}
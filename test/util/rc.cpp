@@ -8,7 +8,9 @@
  */
 
 #include "util/rc.h"
+#include "util/str.h"
 #include "test.h"
+#include "string.h"
 
 TEST(dereference) {
     auto a = ref(1), b = ref(2);
@@ -76,4 +78,73 @@ TEST(inheritance) {
     a = c;
     ASSERT_TRUE(a);
     ASSERT_EQUAL(a->foo(), 2);
-}
\ No newline at end of file
+}
+
+TEST(region_alloc) {
+    rc<int> outer = ref(1);
+    vector<rc<int>> inner;
+    {
+        region r;
+        for (int i = 0; i < 10000; i ++) inner.push(ref(i)); // should span several blocks
+        rc<int> temp = ref(42);
+        ASSERT_EQUAL(*temp, 42);
+        outer = ref(2);
+    }
+    ASSERT_EQUAL(*outer, 2); // refcells should stay valid after their region is gone
+    for (int i = 0; i < 10000; i ++) ASSERT_EQUAL(*inner[i], i);
+    inner.clear(); // frees every block but the one holding 'outer'
+    ASSERT_EQUAL(*outer, 2);
+}
+
+struct Shared {
+    int x;
+};
+
+template<>
+struct rc_shared<Shared> {
+    static constexpr const bool value = true;
+};
+
+TEST(shared_counts) {
+    rc<Shared> a;
+    {
+        region r; // shared cells bypass regions
+        a = ref<Shared>(Shared{ 3 });
+    }
+    ASSERT_EQUAL(a.count(), 1);
+    rc<Shared> b = a, c = b;
+    ASSERT_EQUAL(a.count(), 3);
+    b = nullptr;
+    ASSERT_EQUAL(a.count(), 2);
+    ASSERT_EQUAL(c->x, 3);
+}
+
+struct Tracked {
+    int x;
+};
+
+TEST(stats_counts) {
+#ifdef BASIL_RC_STATS
+    rc_stats* stats = rc_stats_for<Tracked>();
+    vector<rc<Tracked>> cells;
+    for (int i = 0; i < 10; i ++) cells.push(ref<Tracked>(Tracked{ i }));
+    ASSERT_EQUAL(stats->live, 10);
+    ASSERT_EQUAL(stats->peak, 10);
+    cells.clear();
+    ASSERT_EQUAL(stats->live, 0);
+    {
+        region r; // cells from regions are counted the same way
+        rc<Tracked> a = ref<Tracked>(Tracked{ 1 }), b = a;
+        ASSERT_EQUAL(stats->live, 1);
+    }
+    ASSERT_EQUAL(stats->live, 0);
+    ASSERT_EQUAL(stats->peak, 10);
+    ASSERT_EQUAL(stats->total, 11);
+    ASSERT_TRUE(stats->registered);
+
+    buffer b;
+    write_rc_stats(b);
+    string table(b);
+    ASSERT_TRUE(strstr((const char*)table.raw(), "Tracked"));
+#endif
+}
@@ -114,4 +114,50 @@ TEST(clear) {
     ASSERT_FALSE(b.contains(1));
     ASSERT_FALSE(b.contains(2));
     ASSERT_FALSE(b.contains(3));
-}
\ No newline at end of file
+}
+
+TEST(set_operations) {
+    bitset a, b;
+    for (u32 i = 0; i < 300; i += 3) a.insert(i);
+    for (u32 i = 0; i < 200; i += 2) b.insert(i);
+
+    bitset u = a;
+    ASSERT_TRUE(u |= b);
+    ASSERT_FALSE(u |= b); // nothing new the second time
+    ASSERT_EQUAL(u.count(), 100 + 100 - 34);
+
+    bitset x = a;
+    ASSERT_TRUE(x &= b);
+    ASSERT_FALSE(x &= b);
+    ASSERT_EQUAL(x.count(), 34);
+    for (u32 i : x) ASSERT_EQUAL(i % 6, 0);
+
+    bitset d = a;
+    ASSERT_TRUE(d -= b);
+    ASSERT_FALSE(d -= b);
+    ASSERT_EQUAL(d.count(), 100 - 34);
+    ASSERT_FALSE(d.contains(6));
+    ASSERT_TRUE(d.contains(297));
+}
+
+TEST(equality_across_sizes) {
+    bitset a, b;
+    a.insert(5);
+    b.insert(5);
+    b.insert(1000);
+    ASSERT_TRUE(a != b);
+    b.erase(1000);
+    ASSERT_TRUE(a == b); // trailing empty words don't matter
+    ASSERT_TRUE(b.erase(5));
+    ASSERT_TRUE(b.empty());
+    ASSERT_FALSE(b.erase(5000));
+}
+
+TEST(sparse_iteration) {
+    bitset b;
+    u32 elements[] = { 0, 63, 64, 700, 4095 };
+    for (u32 e : elements) b.insert(e);
+    u32 i = 0;
+    for (u32 e : b) ASSERT_EQUAL(e, elements[i ++]);
+    ASSERT_EQUAL(i, 5);
+}
@@ -132,4 +132,18 @@ TEST(slice) {
     ASSERT_EQUAL(b, "def");
     ASSERT_EQUAL(c, "abc");
     ASSERT_EQUAL(c + b, "abcdef");
-}
\ No newline at end of file
+}
+
+TEST(move_small) {
+    string a = "short";
+    string b = static_cast<string&&>(a);
+    ASSERT_EQUAL(b, "short");
+    ASSERT_EQUAL(a.size(), 0);
+    a = "x";
+    string c = "this string is too long to fit inline";
+    c = static_cast<string&&>(b);
+    ASSERT_EQUAL(c, "short");
+    c += " and then some more characters";
+    ASSERT_EQUAL(c, "short and then some more characters");
+    ASSERT_EQUAL(a, "x");
+}
@@ -76,4 +76,35 @@ TEST(iterate) {
     ASSERT_EQUAL(runes[7], 0x0064);
     ASSERT_EQUAL(runes[8], 0x0065);
     ASSERT_EQUAL(runes[9], 0x0066);
-}
\ No newline at end of file
+}
+
+TEST(move_small) {
+    ustring a = "的了";
+    ustring b = static_cast<ustring&&>(a);
+    ASSERT_EQUAL(b, "的了");
+    ASSERT_EQUAL(b.size(), 2);
+    ASSERT_EQUAL(a.size(), 0);
+    ustring c = "a string long enough to live on the heap";
+    c = static_cast<ustring&&>(b);
+    ASSERT_EQUAL(c, "的了");
+    c += "和";
+    ASSERT_EQUAL(c.size(), 3);
+}
+
+TEST(embedded_null) {
+    ustring a(const_slice<u8>{5, (const u8*)"ab\0cd"});
+    ASSERT_EQUAL(a.bytes(), 5);
+    ustring b = a; // copy constructor
+    ASSERT_EQUAL(b.bytes(), 5);
+    ASSERT_EQUAL(b.size(), 5);
+    ASSERT_EQUAL(b.raw()[3], 'c');
+    ASSERT_TRUE(a == b);
+    ASSERT_TRUE(a != ustring("ab"));
+    ASSERT_TRUE(ustring("ab") < a); // a prefix comes first
+    ASSERT_TRUE(a < ustring(const_slice<u8>{5, (const u8*)"ab\0ce"}));
+    for (u32 i = 0; i < 4; i ++) b += b; // grows through the heap
+    ASSERT_EQUAL(b.bytes(), 80);
+    ASSERT_EQUAL(b.size(), 80);
+    ASSERT_EQUAL(b.raw()[78], 'c');
+    ASSERT_EQUAL(b.raw()[80], '\0');
+}
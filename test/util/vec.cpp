@@ -8,6 +8,7 @@
  */
 
 #include "util/vec.h"
+#include "util/str.h"
 #include "test.h"
 
 TEST(push) {
@@ -168,4 +169,61 @@ TEST(large_vector) {
     vector<int> w;
     for (int i = 0; i < 1000; i ++) w.push(v[1000 - i - 1]);
     for (int i = 0, j = 999; i < j; i ++, j --) ASSERT_EQUAL(v[i], w[j]);
-}
\ No newline at end of file
+}
+struct Movable {
+    int* copies;
+    Movable(int* copies): copies(copies) {}
+
+    Movable(const Movable& other): copies(other.copies) {
+        *copies += 1;
+    }
+
+    Movable(Movable&& other): copies(other.copies) {}
+};
+
+TEST(grow_moves) {
+    int copies = 0;
+    vector<Movable> v;
+    for (int i = 0; i < 100; i ++) v.emplace(&copies);
+    ASSERT_EQUAL(copies, 0);
+    Movable m(&copies);
+    v.push(m);
+    ASSERT_EQUAL(copies, 1);
+    vector<Movable> w = static_cast<vector<Movable>&&>(v);
+    ASSERT_EQUAL(copies, 1);
+    ASSERT_EQUAL(w.size(), 101);
+    ASSERT_EQUAL(v.size(), 0);
+}
+
+TEST(reserve_capacity) {
+    vector<int> v;
+    for (int i = 0; i < 8; i ++) v.push(i);
+    ASSERT_EQUAL(v.capacity(), 8); // fills the inline buffer exactly
+    v.reserve(100);
+    ASSERT_GREATER_OR_EQUAL(v.capacity(), 100);
+    const int* before = v.begin();
+    for (int i = 8; i < 100; i ++) v.push(i);
+    ASSERT_TRUE(v.begin() == before);
+    for (int i = 0; i < 100; i ++) ASSERT_EQUAL(v[i], i);
+}
+
+TEST(push_own_element) {
+    vector<string> v;
+    for (int i = 0; i < 8; i ++) v.push("element");
+    v.push(v[0]); // grows while referencing an existing element
+    ASSERT_EQUAL(v.size(), 9);
+    ASSERT_EQUAL(v[8], "element");
+}
+
+TEST(move_inline_elements) {
+    int counter = 0;
+    {
+        vector<Destructible> v;
+        v.emplace(&counter);
+        v.emplace(&counter);
+        vector<Destructible> w = static_cast<vector<Destructible>&&>(v);
+        ASSERT_EQUAL(w.size(), 2);
+        counter = 0;
+    }
+    ASSERT_EQUAL(counter, 2); // each element destroyed exactly once
+}
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#include "arena.h"
+#include "io.h"
+#include "vec.h"
+
+static const u64 BLOCK_SIZE = 65536;
+static const u64 MAX_REGION_ALLOC = BLOCK_SIZE / 8; // larger cells go straight to the heap
+
+// Region-allocated cells are laid out as [block pointer] [refcell header] [value], where
+// the refcell header is 16-byte aligned to match what we'd get from the heap.
+struct region::block {
+    u64 live;       // number of cells allocated from this block that haven't been freed
+    bool retired;   // whether the owning region has moved on from this block
+    u8 *top, *end;  // bump pointer and limit
+};
+
+static region* active = nullptr;
+
+region::block* region::new_block() {
+    u8* mem = new u8[BLOCK_SIZE];
+    block* b = (block*)mem;
+    b->live = 0;
+    b->retired = false;
+    b->top = mem + sizeof(block);
+    b->end = mem + BLOCK_SIZE;
+    return b;
+}
+
+region::region(): current(nullptr), prev(active) {
+    active = this;
+}
+
+region::~region() {
+    retire();
+    active = prev;
+}
+
+void region::retire() {
+    if (!current) return;
+    if (!current->live) delete[] (u8*)current;
+    else current->retired = true;
+    current = nullptr;
+}
+
+static void init_header(u8* data, u64 count) {
+    *(u64*)data = count;
+#ifdef BASIL_RC_STATS
+    ((rc_stats**)data)[1] = nullptr; // untracked until rc_track says otherwise
+#endif
+}
+
+u8* rc_alloc(u64 size, bool shared) {
+    if (!active || shared || size > MAX_REGION_ALLOC) {
+        u8* data = new u8[RC_HEADER_SIZE + size];
+        init_header(data, 1);
+        return data;
+    }
+
+    region::block* b = active->current;
+    u8* data = nullptr;
+    if (b) {
+        data = (u8*)((u64(b->top) + sizeof(region::block*) + 15) & ~u64(15));
+        if (data + RC_HEADER_SIZE + size > b->end) data = nullptr, active->retire();
+    }
+    if (!data) {
+        b = active->current = region::new_block();
+        data = (u8*)((u64(b->top) + sizeof(region::block*) + 15) & ~u64(15));
+    }
+    b->top = data + ((RC_HEADER_SIZE + size + 7) & ~u64(7));
+    b->live ++;
+    ((region::block**)data)[-1] = b;
+    init_header(data, 1 | RC_REGION_BIT);
+    return data;
+}
+
+void rc_free(u8* data) {
+#ifdef BASIL_RC_STATS
+    rc_stats* stats = ((rc_stats**)data)[1];
+    if (stats) rc_atomic_add(&stats->live, -1);
+#endif
+    if (!(*(u64*)data & RC_REGION_BIT)) {
+        delete[] data;
+        return;
+    }
+    region::block* b = ((region::block**)data)[-1];
+    if (-- b->live) return;
+    if (b->retired) delete[] (u8*)b;
+    else b->top = (u8*)b + sizeof(region::block); // nothing left alive, so start over
+}
+
+static rc_stats* all_stats = nullptr;
+
+#ifdef BASIL_RC_STATS
+// Adds stats to the list of all statistics the first time any thread tracks a cell of
+// its type. Types are never unregistered, so the list only ever grows at its head.
+static void register_stats(rc_stats* stats) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    if (_InterlockedExchange8((volatile char*)&stats->registered, 1)) return;
+    rc_stats* head = all_stats;
+    for (;;) {
+        stats->next = head;
+        rc_stats* prev = (rc_stats*)_InterlockedCompareExchangePointer((void* volatile*)&all_stats, stats, head);
+        if (prev == head) break;
+        head = prev;
+    }
+#else
+    if (__atomic_exchange_n(&stats->registered, true, __ATOMIC_ACQ_REL)) return;
+    rc_stats* head = __atomic_load_n(&all_stats, __ATOMIC_ACQUIRE);
+    do stats->next = head;
+    while (!__atomic_compare_exchange_n(&all_stats, &head, stats, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE));
+#endif
+}
+
+// Raises the peak to live, unless another thread has already raised it further.
+static void raise_peak(rc_stats* stats, u64 live) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    u64 peak = stats->peak;
+    while (live > peak) {
+        u64 prev = _InterlockedCompareExchange64((volatile long long*)&stats->peak, live, peak);
+        if (prev == peak) break;
+        peak = prev;
+    }
+#else
+    u64 peak = __atomic_load_n(&stats->peak, __ATOMIC_RELAXED);
+    while (live > peak && !__atomic_compare_exchange_n(&stats->peak, &peak, live, true, 
+        __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+#endif
+}
+#endif
+
+void rc_track(u8* data, rc_stats* stats) {
+#ifdef BASIL_RC_STATS
+    register_stats(stats);
+    raise_peak(stats, rc_atomic_add(&stats->live, 1));
+    rc_atomic_add(&stats->total, 1);
+    ((rc_stats**)data)[1] = stats;
+#endif
+}
+
+void write_rc_stats(stream& io) {
+#ifndef BASIL_RC_STATS
+    writeln(io, "Refcell statistics are only collected when built with BASIL_RC_STATS.");
+#else
+    vector<rc_stats*> sorted;
+#if defined(_MSC_VER) && !defined(__clang__)
+    rc_stats* head = (rc_stats*)_InterlockedCompareExchangePointer((void* volatile*)&all_stats, nullptr, nullptr);
+#else
+    rc_stats* head = __atomic_load_n(&all_stats, __ATOMIC_ACQUIRE);
+#endif
+    for (rc_stats* stats = head; stats; stats = stats->next) sorted.push(stats);
+    for (u32 i = 1; i < sorted.size(); i ++) // insertion sort by live bytes, descending
+        for (u32 j = i; j > 0 && sorted[j]->live * sorted[j]->size > sorted[j - 1]->live * sorted[j - 1]->size; j --) {
+            rc_stats* tmp = sorted[j];
+            sorted[j] = sorted[j - 1], sorted[j - 1] = tmp;
+        }
+    writeln(io, "live\tbytes\tpeak\ttotal\ttype");
+    for (rc_stats* stats : sorted) 
+        writeln(io, stats->live, "\t", stats->live * stats->size, "\t", stats->peak, "\t", stats->total, "\t", stats->name);
+#endif
+}
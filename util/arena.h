@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2021, the Basil authors
+ * All rights reserved.
+ *
+ * This source code is licensed under the 3-Clause BSD License, the full text
+ * of which can be found in the LICENSE file in the root directory
+ * of this project.
+ */
+
+#ifndef BASIL_ARENA_H
+#define BASIL_ARENA_H
+
+#include "defs.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include "intrin.h"
+#endif
+
+// Refcell headers are a single 64-bit word. The low 63 bits hold the reference count,
+// while the top bit marks cells that were allocated from a region instead of the heap.
+constexpr const u64 RC_REGION_BIT = 1ull << 63;
+constexpr const u64 RC_COUNT_MASK = ~RC_REGION_BIT;
+
+// Per-type allocation statistics for refcells, collected when built with BASIL_RC_STATS.
+// In that configuration the header grows to two words, the second pointing to the
+// statistics of the type the cell was allocated as. Either way, values start 16 bytes
+// from the (16-byte aligned) start of the cell or 8 bytes from it, so any type with an
+// alignment of at most 8 is properly aligned.
+struct rc_stats {
+    const char* name;
+    u64 size;           // size in bytes of one value
+    u64 live, peak;     // number of cells currently alive, and the most ever alive at once
+    u64 total;          // number of cells ever allocated
+    bool registered;
+    rc_stats* next;
+};
+
+#ifdef BASIL_RC_STATS
+constexpr const u64 RC_HEADER_SIZE = 16;
+#else
+constexpr const u64 RC_HEADER_SIZE = 8;
+#endif
+
+// Atomically adds n to the word at p, returning the new value.
+inline u64 rc_atomic_add(u64* p, u64 n) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _InterlockedExchangeAdd64((volatile long long*)p, (long long)n) + n;
+#else
+    return __atomic_add_fetch(p, n, __ATOMIC_ACQ_REL);
+#endif
+}
+
+// A region is a scoped bump allocator for refcells. While a region is active, every
+// refcell allocation is carved out of one of its blocks instead of making an individual
+// heap allocation. Each block tracks how many of its cells are still alive, and is 
+// freed all at once as soon as the region has moved past it and its last cell dies.
+// Cells that outlive the region are therefore still safe to use - they just keep their
+// block around a bit longer.
+//
+// Regions nest: constructing one makes it the active region until it's destroyed, at
+// which point the previously-active region (if any) is restored.
+class region {
+    struct block;
+
+    block* current;
+    region* prev;
+
+    // Retires the current block, freeing it immediately if nothing in it is alive.
+    void retire();
+
+    static block* new_block();
+
+    friend u8* rc_alloc(u64 size, bool shared);
+    friend void rc_free(u8* data);
+public:
+    region();
+    ~region();
+    region(const region&) = delete;
+    region& operator=(const region&) = delete;
+};
+
+// Allocates space for a refcell header followed by 'size' bytes, from the active region
+// if there is one or the heap otherwise. The header is initialized to a count of one.
+// Cells shared between threads are always allocated from the heap, since regions are 
+// not thread-safe.
+u8* rc_alloc(u64 size, bool shared = false);
+
+// Frees a refcell allocated with rc_alloc. Does not run any destructors.
+void rc_free(u8* data);
+
+// Attributes a newly-allocated refcell to the provided statistics, registering them
+// on first use. Safe to call from several threads at once. Does nothing unless built
+// with BASIL_RC_STATS.
+void rc_track(u8* data, rc_stats* stats);
+
+// Writes a table of live refcells and bytes by type, largest first. When built with
+// BASIL_RC_STATS, the compiler writes this to stderr as it exits.
+void write_rc_stats(stream& io);
+
+#endif
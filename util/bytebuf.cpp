@@ -8,6 +8,7 @@
  */
 
 #include "bytebuf.h"
+#include "string.h"
 
 template<>
 float big_endian(float f) {
@@ -69,10 +70,7 @@ bytebuf::~bytebuf() {
 bytebuf::bytebuf(const bytebuf& other):
     _start(other._start), _end(other._end), 
     _capacity(other._capacity), _data(new u8[_capacity]) {
-
-    // copies memory from start to end
-    for (u64 i = _start; i != _end; i = (i + 1) & (_capacity - 1))
-        _data[i] = other._data[i];
+    memcpy(_data, other._data, _capacity);
 }
 
 bytebuf& bytebuf::operator=(const bytebuf& other) {
@@ -85,12 +83,30 @@ bytebuf& bytebuf::operator=(const bytebuf& other) {
         _end = other._end;
         _capacity = other._capacity;
         _data = new u8[_capacity];
-        for (u64 i = _start; i != _end; i = (i + 1) & (_capacity - 1))
-            _data[i] = other._data[i];
+        memcpy(_data, other._data, _capacity);
     }
     return *this;
 }
 
+void bytebuf::grow(u64 needed) {
+    u64 size = bytebuf::size(), capacity = _capacity;
+    while (size + needed >= capacity) capacity *= 2;
+
+    // move contents to the front of the new buffer
+    u8* data = new u8[capacity];
+    peek(data, size);
+    delete[] _data;
+    _data = data;
+    _capacity = capacity;
+    _start = 0;
+    _end = size;
+}
+
+void bytebuf::reserve(u64 length) {
+    // one slot is always left empty to tell a full buffer from an empty one
+    if (size() + length >= _capacity) grow(length);
+}
+
 u8 bytebuf::peek() const {
     // empty buffer returns null char
     if (_start == _end) return '\0';
@@ -99,6 +115,20 @@ u8 bytebuf::peek() const {
     return _data[_start];
 }
 
+void bytebuf::peek(u8* buffer, u64 length) const {
+    u64 n = size();
+    if (n > length) n = length;
+
+    // contents may wrap around the end of the array
+    u64 first = _capacity - _start;
+    if (first > n) first = n;
+    memcpy(buffer, _data + _start, first);
+    memcpy(buffer + first, _data, n - first);
+
+    // missing bytes read as null chars, like read()
+    if (n < length) memset(buffer + n, 0, length - n);
+}
+
 u8 bytebuf::read() {
     // empty buffer returns null char
     if (_start == _end) return '\0';
@@ -109,41 +139,49 @@ u8 bytebuf::read() {
     return byte;
 }
 
+void bytebuf::read(u8* buffer, u64 length) {
+    u64 n = size();
+    if (n > length) n = length;
+    peek(buffer, length);
+    _start = (_start + n) & (_capacity - 1);
+}
+
 void bytebuf::read(char* buffer, u64 length) {
-    for (u64 i = 0; i < length; i ++)
-        buffer[i] = read();
+    read((u8*)buffer, length);
 }
 
 void bytebuf::write(u8 byte) {
-    u64 new_end = (_end + 1) & (_capacity - 1);
-    if (new_end == _start) {
-        // hold onto old buffer
-        u64 old_start = _start, old_end = _end, old_capacity = _capacity;
-        u8* old_data = _data;
-
-        // grow and clear buffer
-        _start = 0;
-        _end = 0;
-        _capacity *= 2;
-        _data = new u8[_capacity];
-
-        // copy from old buffer
-        while (old_start != old_end) {
-            write(old_data[old_start]);
-            old_start = (old_start + 1) & (old_capacity - 1);
-        }
-
-        // free old buffer
-        delete[] old_data;
-    }
-
+    if (((_end + 1) & (_capacity - 1)) == _start) grow(1);
     _data[_end] = byte;
     _end = (_end + 1) & (_capacity - 1);
 }
 
+void bytebuf::write(const u8* bytes, u64 length) {
+    reserve(length);
+
+    // copy up to the end of the array, then wrap around to the front
+    u64 first = _capacity - _end;
+    if (first > length) first = length;
+    memcpy(_data + _end, bytes, first);
+    memcpy(_data, bytes + first, length - first);
+    _end = (_end + length) & (_capacity - 1);
+}
+
 void bytebuf::write(const char* string, u64 length) {
-    for (u64 i = 0; i < length; i ++)
-        write((u8)string[i]);
+    write((const u8*)string, length);
+}
+
+void bytebuf::append(const bytebuf& other) {
+    if (this == &other) {
+        bytebuf copy = other;
+        return append(copy);
+    }
+    u64 length = other.size();
+    reserve(length);
+    u64 first = other._capacity - other._start;
+    if (first > length) first = length;
+    write(other._data + other._start, first);
+    write(other._data, length - first);
 }
 
 u64 bytebuf::size() const {
@@ -154,4 +192,93 @@ u64 bytebuf::size() const {
 
 void bytebuf::clear() {
     _start = _end;
-}
\ No newline at end of file
+}
+
+// Varints are LEB128: seven bits per byte, low bits first, with the high
+// bit set on every byte but the last. Signed values are zigzag-encoded so
+// that small negative numbers stay short.
+
+static u32 encode_varint(u8* out, u64 value) {
+    u32 n = 0;
+    while (value >= 0x80) out[n ++] = u8(value) | 0x80, value >>= 7;
+    out[n ++] = u8(value);
+    return n;
+}
+
+static u64 zigzag(i64 value) {
+    return (u64(value) << 1) ^ u64(value >> 63);
+}
+
+static i64 unzigzag(u64 value) {
+    return i64(value >> 1) ^ -i64(value & 1);
+}
+
+void bytebuf::write_varint(u64 value) {
+    u8 bytes[10];
+    write(bytes, encode_varint(bytes, value));
+}
+
+void bytebuf::write_svarint(i64 value) {
+    write_varint(zigzag(value));
+}
+
+u64 bytebuf::read_varint() {
+    u64 value = 0;
+    for (u32 shift = 0; shift < 64; shift += 7) {
+        u8 byte = read();
+        value |= u64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+i64 bytebuf::read_svarint() {
+    return unzigzag(read_varint());
+}
+
+bytereader::bytereader(const u8* data, u64 length):
+    _pos(data), _end(data + length) {}
+
+u8 bytereader::peek() const {
+    return _pos == _end ? '\0' : *_pos;
+}
+
+u8 bytereader::read() {
+    return _pos == _end ? '\0' : *_pos ++;
+}
+
+void bytereader::read(u8* buffer, u64 length) {
+    u64 n = size() < length ? size() : length;
+    memcpy(buffer, _pos, n);
+    if (n < length) memset(buffer + n, 0, length - n);
+    _pos += n;
+}
+
+const u8* bytereader::view(u64 length) {
+    if (length > size()) return nullptr;
+    const u8* start = _pos;
+    _pos += length;
+    return start;
+}
+
+void bytereader::skip(u64 length) {
+    _pos += size() < length ? size() : length;
+}
+
+u64 bytereader::size() const {
+    return _end - _pos;
+}
+
+u64 bytereader::read_varint() {
+    u64 value = 0;
+    for (u32 shift = 0; shift < 64; shift += 7) {
+        u8 byte = read();
+        value |= u64(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) break;
+    }
+    return value;
+}
+
+i64 bytereader::read_svarint() {
+    return unzigzag(read_varint());
+}
@@ -83,6 +83,8 @@ class bytebuf {
     u64 _end;
     u64 _capacity;
     u8* _data;
+
+    void grow(u64 needed);
 public:
     bytebuf();
     ~bytebuf();
@@ -90,27 +92,36 @@ public:
     bytebuf& operator=(const bytebuf& other);
 
     u8 peek() const;
+    void peek(u8* buffer, u64 length) const;
     u8 read();
+    void read(u8* buffer, u64 length);
     void read(char* buffer, u64 length);
     void write(u8 byte);
+    void write(const u8* bytes, u64 length);
     void write(const char* string, u64 length);
+    void append(const bytebuf& other);
+    void reserve(u64 length);
     u64 size() const;
     void clear();
 
+    void write_varint(u64 value);
+    void write_svarint(i64 value);
+    u64 read_varint();
+    i64 read_svarint();
+
     template<typename T>
     T read() {
         // serializes object from lowest to highest address
-        static u8 buffer[sizeof(T)];
-        for (u32 i = 0; i < sizeof(T); i ++) 
-          buffer[i] = bytebuf::read();
-        return *(T*)buffer;
+        T value;
+        read((u8*)&value, sizeof(T));
+        return value;
     }
     
     template<typename T>
     void write(const T& value) {
         // deserializes object, assuming first byte is lowest address
-        const u8* data = (const u8*)&value;
-        for (u32 i = 0; i < sizeof(T); i ++) write(data[i]);
+        if (sizeof(T) == 1) write(*(const u8*)&value);
+        else write((const u8*)&value, sizeof(T));
     }
 
     template<typename... Args>
@@ -120,4 +131,30 @@ public:
     }
 };
 
+// Reads bytes in place from a region of memory owned by someone else,
+// with the same interface as reading from a bytebuf.
+class bytereader {
+    const u8* _pos;
+    const u8* _end;
+public:
+    bytereader(const u8* data, u64 length);
+
+    u8 peek() const;
+    u8 read();
+    void read(u8* buffer, u64 length);
+    const u8* view(u64 length);
+    void skip(u64 length);
+    u64 size() const;
+
+    u64 read_varint();
+    i64 read_svarint();
+
+    template<typename T>
+    T read() {
+        T value;
+        read((u8*)&value, sizeof(T));
+        return value;
+    }
+};
+
 #endif
\ No newline at end of file
@@ -85,12 +85,21 @@ typedef int64_t i64;
 
 // hash.h
 
-template<typename T, int N = 8>
+template<typename T>
+struct set_hash;
+
+template<typename T>
+struct set_equals;
+
+template<typename T, typename Hash = set_hash<T>, typename Eq = set_equals<T>>
 class set;
 
 template<typename K, typename V>
 class map;
 
+template<typename K, typename V>
+class overlay_map;
+
 // io.h
 
 class stream;
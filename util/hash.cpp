@@ -8,6 +8,15 @@
  */
 
 #include "hash.h"
+#include "string.h"
+#if defined(_MSC_VER) && defined(_M_X64)
+    #include "intrin.h"
+#endif
+
+const i8 EMPTY_CTRL_GROUP[CTRL_GROUP_WIDTH] = {
+    CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY,
+    CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY, CTRL_EMPTY
+};
 
 u64 rotl(u64 u, u64 n) {
 	return (u << n) | ((u >> (64 - n)) & ~(-1 << n));
@@ -17,6 +26,8 @@ u64 rotr(u64 u, u64 n) {
 	return (u >> n) | ((u << (64 - n)) & (-1 & ~(-1 << n)));
 }
 
+#ifdef BASIL_MURMUR_HASH
+
 // MurmurHash, 64-bit version, unaligned by Austin Appleby (https://sites.google.com/site/murmurhash/)
 // The source has been slightly modified, using basil typedefs, and a fixed seed (a 64-bit prime).
 
@@ -57,6 +68,90 @@ u64 raw_hash(const void* input, u64 size){
 	return h;
 } 
 
+#else
+
+// wyhash by Wang Yi (https://github.com/wangyi-fudan/wyhash, public domain), using basil
+// typedefs and a fixed seed. It consumes 16 to 48 bytes per step using 64x64->128-bit
+// multiplies, and handles keys of up to 16 bytes with at most two overlapping reads.
+
+static const u64 WY_SECRET[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+// Multiplies a and b, leaving the low half of the 128-bit product in a and the high half in b.
+static inline void wy_mum(u64* a, u64* b) {
+#if defined(__SIZEOF_INT128__)
+    __uint128_t r = __uint128_t(*a) * *b;
+    *a = u64(r), *b = u64(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    *a = _umul128(*a, *b, b);
+#else
+    u64 ha = *a >> 32, hb = *b >> 32, la = u32(*a), lb = u32(*b);
+    u64 rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    u64 lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo, *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline u64 wy_mix(u64 a, u64 b) {
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline u64 wy_r8(const u8* p) {
+    u64 v;
+    memcpy(&v, p, 8);
+    return v;
+}
+
+static inline u64 wy_r4(const u8* p) {
+    u32 v;
+    memcpy(&v, p, 4);
+    return v;
+}
+
+static inline u64 wy_r3(const u8* p, u64 k) {
+    return (u64(p[0]) << 16) | (u64(p[k >> 1]) << 8) | p[k - 1];
+}
+
+u64 raw_hash(const void* input, u64 size) {
+    const u8* p = (const u8*)input;
+    u64 seed = 7576351903513440497ull ^ wy_mix(7576351903513440497ull ^ WY_SECRET[0], WY_SECRET[1]);
+    u64 a, b;
+    if (size <= 16) {
+        if (size >= 4) {
+            a = (wy_r4(p) << 32) | wy_r4(p + ((size >> 3) << 2));
+            b = (wy_r4(p + size - 4) << 32) | wy_r4(p + size - 4 - ((size >> 3) << 2));
+        }
+        else if (size > 0) a = wy_r3(p, size), b = 0;
+        else a = b = 0;
+    }
+    else {
+        u64 i = size;
+        if (i > 48) {
+            u64 see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_r8(p) ^ WY_SECRET[1], wy_r8(p + 8) ^ seed);
+                see1 = wy_mix(wy_r8(p + 16) ^ WY_SECRET[2], wy_r8(p + 24) ^ see1);
+                see2 = wy_mix(wy_r8(p + 32) ^ WY_SECRET[3], wy_r8(p + 40) ^ see2);
+                p += 48, i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_r8(p) ^ WY_SECRET[1], wy_r8(p + 8) ^ seed);
+            p += 16, i -= 16;
+        }
+        a = wy_r8(p + i - 16), b = wy_r8(p + i - 8);
+    }
+    a ^= WY_SECRET[1], b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ WY_SECRET[0] ^ size, b ^ WY_SECRET[1]);
+}
+
+#endif
+
 template<>
 u64 hash(const char* const& s) {
     u32 size = 0;
@@ -16,6 +16,13 @@
 #include "slice.h"
 #include "io.h"
 #include "panic.h"
+#include "rc.h"
+#include "string.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+    #define BASIL_SSE2
+    #include "emmintrin.h"
+#endif
 
 template<typename T>
 bool equals(const T& a, const T& b) {
@@ -30,10 +37,30 @@ bool key_equals(const T& a, const T& b) {
 u64 rotl(u64 u, u64 n);
 u64 rotr(u64 u, u64 n);
 
+// Hashes a range of bytes. Uses wyhash by default, or MurmurHash64A if built with
+// BASIL_MURMUR_HASH defined.
 u64 raw_hash(const void* t, uint64_t size);
 
+// Hashes a single machine word with one multiply and xor-shift.
+inline u64 word_hash(u64 w) {
+    w = (w ^ 0x2d358dccaa6c78a5ull) * 0x9e3779b97f4a7c15ull;
+    return w ^ (w >> 29);
+}
+
+// Hashes the bytes of t. Four- and eight-byte values, like ids, kinds and
+// pointers, take the word_hash fast path instead of the general byte hash.
 template<typename T>
 u64 raw_hash(const T& t) {
+    if (sizeof(T) == 8) {
+        u64 w;
+        memcpy(&w, &t, 8);
+        return word_hash(w);
+    }
+    if (sizeof(T) == 4) {
+        u32 w;
+        memcpy(&w, &t, 4);
+        return word_hash(w);
+    }
     return raw_hash(&t, sizeof(T));
 }
 
@@ -60,191 +87,307 @@ u64 key_hash(const T& a) {
     return ::hash(a.first);
 }
 
-// Open-addressed general-purpose hash table based on robin-hood hashing, with a 
-// fixed stack-allocated buffer of N elements.
-template<typename T, int N>
-class set {
-    enum bucket_status : u8 {
-        EMPTY, GHOST, FILLED
-    };
+// Control bytes track the state of each slot in a set. Full slots store the low seven
+// bits of their element's hash, so empty and deleted slots are the only negative ones.
+enum : i8 {
+    CTRL_EMPTY = -128,
+    CTRL_DELETED = -2
+};
 
-    struct bucket {
-        u8 data[sizeof(T)];
-        bucket_status status;
+// Slots are probed in aligned groups of this many at a time.
+constexpr u32 CTRL_GROUP_WIDTH = 16;
 
-        bucket(): status(EMPTY) {
-            //
-        }
+// Control bytes for a table with no slots, so empty sets don't need to allocate.
+extern const i8 EMPTY_CTRL_GROUP[CTRL_GROUP_WIDTH];
 
-        ~bucket() {
-            if (status == FILLED) (*(T*)data).~T();
-        }
+// Returns the index of the lowest set bit in a nonzero mask.
+inline u32 lowest_bit(u32 mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctz(mask);
+#else
+    u32 i = 0;
+    while (!(mask & 1)) mask >>= 1, ++ i;
+    return i;
+#endif
+}
 
-        bucket(const bucket& other): status(other.status) {
-            if (status == FILLED) new(data) T(*(T*)other.data);
-        }
+// Loads a group of control bytes, and finds the ones meeting some criteria. Each query
+// returns a mask with bit i set if byte i of the group matched.
+struct ctrl_group {
+#ifdef BASIL_SSE2
+    __m128i ctrl;
 
-        bucket& operator=(const bucket& other) {
-            if (this != &other) {
-                evict();
-                status = other.status;
-                if (status == FILLED) new(data) T(*(T*)other.data);
-            }
-            return *this;
-        }
+    ctrl_group(const i8* ptr): ctrl(_mm_loadu_si128((const __m128i*)ptr)) {}
 
-        inline const T& value() const {
-            return *(const T*)data;
-        }
+    u32 match(i8 h2) const {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl));
+    }
 
-        inline T& value() {
-            return *(T*)data;
-        }
+    u32 match_free() const { // empty or deleted
+        return _mm_movemask_epi8(ctrl);
+    }
+#else
+    const i8* ctrl;
 
-        inline void fill(const T& value) {
-            if (status != FILLED) {
-                status = FILLED, new(data) T(value);
-            }
-            else this->value() = value;
-        }
+    ctrl_group(const i8* ptr): ctrl(ptr) {}
 
-        inline void evict() {
-            if (status == FILLED) {
-                (*(T*)data).~T();
-                status = GHOST;
-            }
-        }
+    u32 match(i8 h2) const {
+        u32 mask = 0;
+        for (u32 i = 0; i < CTRL_GROUP_WIDTH; ++ i) mask |= u32(ctrl[i] == h2) << i;
+        return mask;
+    }
 
-        inline void clear() {
-            if (status == FILLED) (*(T*)data).~T();
-            status = EMPTY;
-        }
-    };
+    u32 match_free() const { // empty or deleted
+        u32 mask = 0;
+        for (u32 i = 0; i < CTRL_GROUP_WIDTH; ++ i) mask |= u32(ctrl[i] < 0) << i;
+        return mask;
+    }
+#endif
 
-    bucket* data;
-    u32 _size, _capacity, _mask;
-    bool (*equals)(const T&, const T&);
-    u64 (*hash)(const T&);
-    bucket fixed[N];
+    u32 match_empty() const {
+        return match(CTRL_EMPTY);
+    }
+};
 
-    void init(u32 size) {
-        _size = 0, _capacity = size;
-        data = _capacity <= N ? fixed : new bucket[size];
+// Spreads entropy from all bits of a hash into the high and low bits we use for probing,
+// since some of our hash functions (like the ones for integers) don't.
+inline u64 mix_hash(u64 h) {
+    h *= 0x9e3779b97f4a7c15ul;
+    return h ^ (h >> 32);
+}
+
+// Default hash and equality for sets, using ::hash and operator==.
+template<typename T>
+struct set_hash {
+    u64 operator()(const T& t) const {
+        return ::hash(t);
+    }
+};
+
+template<typename T>
+struct set_equals {
+    bool operator()(const T& a, const T& b) const {
+        return a == b;
     }
+};
 
-    void swap(T& a, T& b) {
-        T t = a;
-        a = b;
-        b = t;
+// Open-addressed general-purpose hash table. Alongside its slots, the table keeps one
+// control byte per slot, and lookups compare a whole group of control bytes against the
+// hash at once (using SSE2 where we have it), only comparing elements when seven bits
+// of their hashes match. Hash and Eq may accept key types other than T, in which case
+// find, erase and contains can look elements up by those keys directly.
+template<typename T, typename Hash, typename Eq>
+class set {
+    i8* ctrl;
+    T* slots;
+    u32 _size, _capacity, growth_left;
+    Hash hasher;
+    Eq eq;
+
+    void init(u32 capacity) {
+        _size = 0, _capacity = capacity;
+        growth_left = capacity - capacity / 8; // keep the load factor under 7/8
+        if (!capacity) {
+            ctrl = (i8*)EMPTY_CTRL_GROUP, slots = nullptr;
+            return;
+        }
+        u8* block = new u8[capacity + capacity * sizeof(T)]; // capacity is a multiple of 16, so slots are aligned
+        ctrl = (i8*)block, slots = (T*)(block + capacity);
+        for (u32 i = 0; i < capacity; ++ i) ctrl[i] = CTRL_EMPTY;
     }
 
     void free() {
-        if (_capacity > N) delete[] data;
+        if (!_capacity) return;
+        for (u32 i = 0; i < _capacity; ++ i) if (ctrl[i] >= 0) slots[i].~T();
+        delete[] (u8*)ctrl;
     }
 
-    void copy(const bucket* bs) {
+    void copy(const set& other) {
+        init(other._capacity);
+        _size = other._size, growth_left = other.growth_left;
         for (u32 i = 0; i < _capacity; ++ i) {
-            data[i] = bs[i];
+            ctrl[i] = other.ctrl[i];
+            if (ctrl[i] >= 0) new(slots + i) T(other.slots[i]);
         }
     }
 
-    void grow() {
-        bucket* old = data;
-        u32 oldsize = _capacity;
-        init(_capacity * 2);
-        _mask = (_mask << 1) | 1;
-        for (u32 i = 0; i < oldsize; ++ i) {
-            if (old[i].status == FILLED) insert(old[i].value());
+    void steal(set& other) {
+        ctrl = other.ctrl, slots = other.slots;
+        _size = other._size, _capacity = other._capacity, growth_left = other.growth_left;
+        other.init(0);
+    }
+
+    // Finds a free slot for an element with the provided (mixed) hash, and marks it full.
+    // The caller is responsible for constructing the element.
+    u32 claim(u64 h) {
+        u32 gmask = _capacity / CTRL_GROUP_WIDTH - 1, g = (h >> 7) & gmask;
+        for (u32 step = 1; ; ++ step) {
+            u32 free_mask = ctrl_group(ctrl + g * CTRL_GROUP_WIDTH).match_free();
+            if (free_mask) {
+                u32 i = g * CTRL_GROUP_WIDTH + lowest_bit(free_mask);
+                if (ctrl[i] == CTRL_EMPTY) -- growth_left;
+                ctrl[i] = h & 0x7f;
+                ++ _size;
+                return i;
+            }
+            g = (g + step) & gmask; // triangular probing visits every group
+        }
+    }
+
+    // Moves every element to a new table, doubling its size unless most of the
+    // used-up slots were only deleted.
+    void rehash() {
+        i8* old_ctrl = ctrl;
+        T* old_slots = slots;
+        u32 old_capacity = _capacity;
+        init(!old_capacity ? CTRL_GROUP_WIDTH : _size * 2 >= old_capacity - old_capacity / 8 ? old_capacity * 2 : old_capacity);
+        for (u32 i = 0; i < old_capacity; ++ i) {
+            if (old_ctrl[i] < 0) continue;
+            new(slots + claim(mix_hash(hasher(old_slots[i])))) T(static_cast<T&&>(old_slots[i]));
+            old_slots[i].~T();
+        }
+        if (old_capacity) delete[] (u8*)old_ctrl;
+    }
+
+    void erase_at(u32 i) {
+        slots[i].~T();
+        -- _size;
+        // If this slot's group still has an empty slot, no probe ever continues past it,
+        // so we can free the slot entirely instead of leaving a tombstone.
+        if (ctrl_group(ctrl + i / CTRL_GROUP_WIDTH * CTRL_GROUP_WIDTH).match_empty()) 
+            ctrl[i] = CTRL_EMPTY, ++ growth_left;
+        else ctrl[i] = CTRL_DELETED;
+    }
+protected:
+    // Returns the index of the slot holding an element equal to the provided key, or
+    // -1 if there isn't one.
+    template<typename Q>
+    i64 index_of(const Q& key) const {
+        if (!_size) return -1;
+        u64 h = mix_hash(hasher(key));
+        i8 h2 = h & 0x7f;
+        u32 gmask = _capacity / CTRL_GROUP_WIDTH - 1, g = (h >> 7) & gmask;
+        for (u32 step = 1; ; ++ step) {
+            ctrl_group group(ctrl + g * CTRL_GROUP_WIDTH);
+            for (u32 m = group.match(h2); m; m &= m - 1) {
+                u32 i = g * CTRL_GROUP_WIDTH + lowest_bit(m);
+                if (eq(slots[i], key)) return i;
+            }
+            if (group.match_empty()) return -1;
+            g = (g + step) & gmask;
         }
-        if (oldsize > N) delete[] old;
     }
 
+    // Adds an element known not to be in the set yet, returning a reference to it.
+    T& insert_new(const T& t) {
+        if (!growth_left) rehash();
+        return *new(slots + claim(mix_hash(hasher(t)))) T(t);
+    }
+
+    T& at(u32 i) {
+        return slots[i];
+    }
+
+    const T& at(u32 i) const {
+        return slots[i];
+    }
 public:
-    set(bool (*equals_in)(const T&, const T&) = ::equals,
-        u64 (*hash_in)(const T&) = ::hash<T>): 
-        equals(equals_in), hash(hash_in) {
-        init(8);
-        _mask = 7;
+    set() {
+        init(0);
     }
 
     ~set() {
         free();
     }
 
-    set(const set& other): set(other.equals, other.hash) {
-        init(other._capacity);
-        _size = other._size, _mask = other._mask;
-        copy(other.data);
+    set(const set& other) {
+        copy(other);
+    }
+
+    set(set&& other) {
+        steal(other);
     }
 
     set& operator=(const set& other) {
         if (this != &other) {
             free();
-            init(other._capacity);
-            hash = other.hash, equals = other.equals;
-            _size = other._size, _mask = other._mask;
-            copy(other.data);
+            copy(other);
+        }
+        return *this;
+    }
+
+    set& operator=(set&& other) {
+        if (this != &other) {
+            free();
+            steal(other);
         }
         return *this;
     }
 
     class const_iterator {
-        const bucket *ptr, *end;
+        const i8 *ctrl, *end;
+        const T* slot;
         friend class set;
     public:
-        const_iterator(const bucket* ptr_in, const bucket* end_in): 
-            ptr(ptr_in), end(end_in) {
-            //
+        const_iterator(): ctrl(nullptr), end(nullptr), slot(nullptr) {}
+
+        const_iterator(const i8* ctrl_in, const i8* end_in, const T* slot_in): 
+            ctrl(ctrl_in), end(end_in), slot(slot_in) {
+            while (ctrl != end && *ctrl < 0) ++ ctrl, ++ slot;
         }
 
         const T& operator*() const {
-            return ptr->value();
+            return *slot;
         }
 
         const T* operator->() const {
-            return &(ptr->value());
+            return slot;
         }
 
         const_iterator& operator++() {
-            if (ptr != end) ++ ptr;
-            while (ptr != end && ptr->status != FILLED) ++ ptr;
+            if (ctrl != end) ++ ctrl, ++ slot;
+            while (ctrl != end && *ctrl < 0) ++ ctrl, ++ slot;
             return *this;
         }
 
         const_iterator operator++(int) {
-            iterator it = *this;
+            const_iterator it = *this;
             operator++();
             return it;
         }
 
         bool operator==(const const_iterator& other) const {
-            return ptr == other.ptr;
+            return ctrl == other.ctrl;
         }
 
         bool operator!=(const const_iterator& other) const {
-            return ptr != other.ptr;
+            return ctrl != other.ctrl;
         }
     };
 
     class iterator {
-        bucket *ptr, *end;
+        const i8 *ctrl, *end;
+        T* slot;
         friend class set;
     public:
-        iterator(bucket* ptr_in, bucket* end_in): ptr(ptr_in), end(end_in) {
-            //
+        iterator(): ctrl(nullptr), end(nullptr), slot(nullptr) {}
+
+        iterator(const i8* ctrl_in, const i8* end_in, T* slot_in): 
+            ctrl(ctrl_in), end(end_in), slot(slot_in) {
+            while (ctrl != end && *ctrl < 0) ++ ctrl, ++ slot;
         }
 
         T& operator*() {
-            return ptr->value();
+            return *slot;
         }
 
         T* operator->() {
-            return &(ptr->value());
+            return slot;
         }
 
         iterator& operator++() {
-            if (ptr != end) ++ ptr;
-            while (ptr != end && ptr->status != FILLED) ++ ptr;
+            if (ctrl != end) ++ ctrl, ++ slot;
+            while (ctrl != end && *ctrl < 0) ++ ctrl, ++ slot;
             return *this;
         }
 
@@ -255,130 +398,93 @@ public:
         }
 
         bool operator==(const iterator& other) const {
-            return ptr == other.ptr;
+            return ctrl == other.ctrl;
         }
 
         bool operator!=(const iterator& other) const {
-            return ptr != other.ptr;
+            return ctrl != other.ctrl;
         }
 
         operator const_iterator() const {
-            return const_iterator(ptr, end);
+            return const_iterator(ctrl, end, slot);
         }
     };
 
     iterator begin() {
-        bucket *start = data, *end = data + _capacity;
-        while (start != end && start->status != FILLED) ++ start;
-        return iterator(start, end);
+        return iterator(ctrl, ctrl + _capacity, slots);
     }
 
     const_iterator begin() const {
-        const bucket *start = data, *end = data + _capacity;
-        while (start != end && start->status != FILLED) ++ start;
-        return const_iterator(start, end);
+        return const_iterator(ctrl, ctrl + _capacity, slots);
     }
 
     iterator end() {
-        return iterator(data + _capacity, data + _capacity);
+        return iterator(ctrl + _capacity, ctrl + _capacity, slots + _capacity);
     }
 
     const_iterator end() const {
-        return const_iterator(data + _capacity, data + _capacity);
+        return const_iterator(ctrl + _capacity, ctrl + _capacity, slots + _capacity);
     }
 
     void clear() {
-        for (u64 i = 0; i < _capacity; i ++) {
-            if (data[i].status == FILLED) data[i].clear();
+        for (u32 i = 0; i < _capacity; ++ i) {
+            if (ctrl[i] >= 0) slots[i].~T();
+            ctrl[i] = CTRL_EMPTY;
         }
-        _size = 0;
+        _size = 0, growth_left = _capacity - _capacity / 8;
     }
 
+    // Adds an element to the set, replacing any existing element equal to it.
     void insert(const T& t) {
-        if (double(_size + 1) / double(_capacity) > 0.625) grow();
-        u64 h = hash(t);
-        u64 dist = 0;
-        u64 i = h & _mask;
-        T item = t;
-        while (true) {
-            if (data[i].status == EMPTY || data[i].status == GHOST) {
-                data[i].fill(item);
-                ++ _size;
-                return;
-            }
-
-            if (data[i].status == FILLED && equals(data[i].value(), item)) {
-                data[i].value() = t; // potentially redundant assignment allows for overwriting existing values
-                return;
-            }
-
-            u64 other_dist = (i - (hash(data[i].value()) & _mask)) & _mask;
-            if (other_dist < dist) {
-                if (data[i].status == GHOST) {
-                    data[i].fill(item);
-                    ++ _size;
-                    return;
-                }
-                swap(item, data[i].value());
-                dist = other_dist;
-            }
-            i = (i + 1) & _mask;
-            ++ dist;
-        }
+        i64 i = index_of(t);
+        if (i >= 0) slots[i] = t;
+        else insert_new(t);
     }
 
     void erase(const T& t) {
-        u64 h = hash(t);
-        u64 i = h & _mask;
-        while (true) {
-            if (data[i].status == EMPTY) return;
-            if (data[i].status == FILLED && equals(data[i].value(), t)) {
-                data[i].evict();
-                -- _size;
-                return;
-            }
-            i = (i + 1) & _mask;
-        }
+        i64 i = index_of(t);
+        if (i >= 0) erase_at(i);
+    }
+
+    template<typename Q>
+    void erase(const Q& key) {
+        i64 i = index_of(key);
+        if (i >= 0) erase_at(i);
     }
 
     const_iterator find(const T& t) const {
-        u64 h = hash(t);
-        u64 i = h & _mask;
-        while (true) {
-            if (data[i].status == EMPTY) return end();
-            if (data[i].status != GHOST) {
-                u64 dist = (i - h) & _mask;
-                u64 oh = hash(data[i].value());
-                u64 other_dist = (i - (oh & _mask)) & _mask;
-                if (other_dist < dist) return end();
-            }
-            if (data[i].status == FILLED && equals(data[i].value(), t)) {
-                return const_iterator(data + i, data + _capacity);
-            }
-            i = (i + 1) & _mask;
-        }
+        i64 i = index_of(t);
+        if (i < 0) return end();
+        return const_iterator(ctrl + i, ctrl + _capacity, slots + i);
+    }
+
+    template<typename Q>
+    const_iterator find(const Q& key) const {
+        i64 i = index_of(key);
+        if (i < 0) return end();
+        return const_iterator(ctrl + i, ctrl + _capacity, slots + i);
     }
 
     iterator find(const T& t) {
-        u64 h = hash(t);
-        u64 i = h & _mask;
-        while (true) {
-            if (data[i].status == EMPTY) return end();
-            if (data[i].status != GHOST) {
-                u64 dist = (i - h) & _mask;
-                u64 oh = hash(data[i].value());
-                u64 other_dist = (i - (oh & _mask)) & _mask;
-                if (other_dist < dist) return end();
-            }
-            if (data[i].status == FILLED && equals(data[i].value(), t)) {
-                return iterator(data + i, data + _capacity);
-            }
-            i = (i + 1) & _mask;
-        }
+        i64 i = index_of(t);
+        if (i < 0) return end();
+        return iterator(ctrl + i, ctrl + _capacity, slots + i);
+    }
+
+    template<typename Q>
+    iterator find(const Q& key) {
+        i64 i = index_of(key);
+        if (i < 0) return end();
+        return iterator(ctrl + i, ctrl + _capacity, slots + i);
     }
 
     bool contains(const T& t) const {
-        return find(t) != end();
+        return index_of(t) >= 0;
+    }
+
+    template<typename Q>
+    bool contains(const Q& key) const {
+        return index_of(key) >= 0;
     }
 
     u32 size() const {
@@ -390,50 +496,220 @@ public:
     }
 };
 
+// Hashes and compares map entries by their keys, and also accepts bare keys, so maps can
+// find entries without building a pair around the key.
+template<typename K, typename V>
+struct map_key_hash {
+    u64 operator()(const pair<K, V>& entry) const {
+        return ::hash(entry.first);
+    }
+
+    u64 operator()(const K& key) const {
+        return ::hash(key);
+    }
+};
+
+template<typename K, typename V>
+struct map_key_equals {
+    bool operator()(const pair<K, V>& a, const pair<K, V>& b) const {
+        return a.first == b.first;
+    }
+
+    bool operator()(const pair<K, V>& a, const K& key) const {
+        return a.first == key;
+    }
+};
+
 // Key-value map backed by a hashset.
 template<typename K, typename V>
-class map : public set<pair<K, V>> {
+class map : public set<pair<K, V>, map_key_hash<K, V>, map_key_equals<K, V>> {
+    using base = set<pair<K, V>, map_key_hash<K, V>, map_key_equals<K, V>>;
 public:
-    map(): set<pair<K, V>>(::key_equals<pair<K, V>>, ::key_hash<pair<K, V>>) {
-        //
-    }
+    using typename base::iterator;
+    using typename base::const_iterator;
 
     void put(const K& key, const V& value) {
-        set<pair<K, V>>::insert({ key, value });
+        i64 i = base::index_of(key);
+        if (i >= 0) base::at(i).second = value;
+        else base::insert_new({ key, value });
     }
 
     void erase(const K& key) {
-        set<pair<K, V>>::erase({ key, V() });
+        base::erase(key);
     }
 
     V& operator[](const K& key) {
-        pair<K, V> dummy = { key, V() };
-        auto it = set<pair<K, V>>::find(dummy);
-        if (it == set<pair<K, V>>::end()) {
-            set<pair<K, V>>::insert(dummy);
-        }
-        return set<pair<K, V>>::find(dummy)->second;
+        i64 i = base::index_of(key);
+        if (i >= 0) return base::at(i).second;
+        return base::insert_new({ key, V() }).second;
     }
 
     const V& operator[](const K& key) const {
-        pair<K, V> dummy = { key, V() };
-        auto it = set<pair<K, V>>::find(dummy);
-        if (it == set<pair<K, V>>::end()) {
-            panic("Tried to access nonexistent map key!");
+        i64 i = base::index_of(key);
+        if (i < 0) panic("Tried to access nonexistent map key!");
+        return base::at(i).second;
+    }
+
+    const_iterator find(const K& key) const {
+        return base::find(key);
+    }
+
+    iterator find(const K& key) {
+        return base::find(key);
+    }
+
+    bool contains(const K& key) const {
+        return base::contains(key);
+    }
+};
+
+// Key-value map with constant-time copies, built from a stack of copy-on-write layers.
+// Writes always go to the topmost layer. Copying the map shares all of its layers; the
+// next write to either copy first pushes a fresh private layer on top, so the shared
+// layers are never modified after they are shared. Lookups search from the top layer
+// down, so entries in higher layers shadow entries with the same key below them.
+template<typename K, typename V>
+class overlay_map {
+    // Maximum number of layers we allow before squashing them into one.
+    static constexpr u32 MAX_DEPTH = 8;
+
+    struct layer {
+        map<K, V> entries;
+        rc<layer> below;
+        u32 depth;
+    };
+
+    rc<layer> top;
+
+    // Ensures the top layer is exclusively owned by this map, and can be written to.
+    void own() {
+        if (!top) top = ref<layer>(layer{ map<K, V>(), nullptr, 1 });
+        else if (top.count() > 1) {
+            if (top->depth >= MAX_DEPTH) flatten();
+            else top = ref<layer>(layer{ map<K, V>(), top, top->depth + 1 });
         }
-        return set<pair<K, V>>::find(dummy)->second;
     }
 
-    typename set<pair<K, V>>::const_iterator find(const K& key) const {
-        return set<pair<K, V>>::find({ key, V() });
+    // Replaces all layers with a single private layer containing every visible entry.
+    void flatten() {
+        rc<layer> flat = ref<layer>(layer{ map<K, V>(), nullptr, 1 });
+        for (const auto& [k, v] : *this) flat->entries.put(k, v);
+        top = flat;
     }
 
-    typename set<pair<K, V>>::iterator find(const K& key) {
-        return set<pair<K, V>>::find({ key, V() });
+    const V* lookup_in(const layer* l, const K& key) const {
+        for (; l; l = l->below.raw()) {
+            auto it = l->entries.find(key);
+            if (it != l->entries.end()) return &it->second;
+        }
+        return nullptr;
+    }
+public:
+    class const_iterator {
+        const layer *top, *l;
+        typename map<K, V>::const_iterator it;
+        friend class overlay_map;
+
+        // Returns whether the current entry is hidden by an entry in a higher layer.
+        bool shadowed() const {
+            for (const layer* s = top; s != l; s = s->below.raw())
+                if (s->entries.contains(it->first)) return true;
+            return false;
+        }
+
+        // Advances until we reach a visible entry, or the end of the bottom layer.
+        void settle() {
+            while (l) {
+                if (it == l->entries.end()) {
+                    l = l->below.raw();
+                    if (l) it = l->entries.begin();
+                }
+                else if (shadowed()) ++ it;
+                else return;
+            }
+        }
+    public:
+        const_iterator(const layer* top_in, const layer* l_in): 
+            top(top_in), l(l_in) {
+            if (l) it = l->entries.begin(), settle();
+        }
+
+        const pair<K, V>& operator*() const {
+            return *it;
+        }
+
+        const pair<K, V>* operator->() const {
+            return &*it;
+        }
+
+        const_iterator& operator++() {
+            ++ it;
+            settle();
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator copy = *this;
+            operator++();
+            return copy;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return l == other.l && (!l || it == other.it);
+        }
+
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+    };
+
+    const_iterator begin() const {
+        return const_iterator(top.raw(), top.raw());
+    }
+
+    const_iterator end() const {
+        return const_iterator(top.raw(), nullptr);
+    }
+
+    // Binds a key to a value in the top layer, replacing any existing entry for it.
+    void put(const K& key, const V& value) {
+        own();
+        top->entries.put(key, value);
+    }
+
+    // Returns a pointer to the value bound to a key, or null if no layer contains it.
+    const V* lookup(const K& key) const {
+        return lookup_in(top.raw(), key);
+    }
+
+    // Returns a mutable pointer to the value bound to a key, or null if no layer contains
+    // it. If the value currently lives in a shared layer, it's copied into the top layer 
+    // first so the modification isn't visible to other copies of the map. Since this may
+    // write to the map, use lookup() for plain reads.
+    V* lookup_mut(const K& key) {
+        if (top && top.count() == 1) {
+            auto it = top->entries.find(key);
+            if (it != top->entries.end()) return &it->second;
+        }
+        const V* found = lookup_in(top.raw(), key);
+        if (!found) return nullptr;
+        V value = *found;
+        own();
+        top->entries.put(key, value);
+        return &top->entries.find(key)->second;
     }
 
     bool contains(const K& key) const {
-        return set<pair<K, V>>::contains({ key, V() });
+        return lookup(key);
+    }
+
+    // Returns the number of distinct keys visible in the map.
+    u32 size() const {
+        if (!top) return 0;
+        if (!top->below) return top->entries.size();
+        u32 n = 0;
+        for (auto it = begin(); it != end(); ++ it) n ++;
+        return n;
     }
 };
 
@@ -10,6 +10,7 @@
 #include "io.h"
 #include "str.h"
 #include "panic.h"
+#include "string.h"
 
 bool exists(const char* path) {
     FILE* f = fopen(path, "r");
@@ -17,25 +18,68 @@ bool exists(const char* path) {
     else return fclose(f), true;
 }
 
+void stream::write(const u8* bytes, u64 length) {
+    for (u64 i = 0; i < length; i ++) write(bytes[i]);
+}
+
+u64 stream::read(u8* bytes, u64 length) {
+    for (u64 i = 0; i < length; i ++) {
+        if (!*this) return i;
+        bytes[i] = read();
+    }
+    return length;
+}
+
+void stream::flush() {
+    //
+}
+
+static const u32 FILE_BUFFER_SIZE = 4096;
+
 file::file(const char* fname, const char* flags): 
     file(fopen(fname, flags)) {
     //
 }
 
-file::file(FILE* f_in): f(f_in), done(!f) {
-    //
+// Output to the standard streams isn't buffered here, since compiled code
+// and the C library write to them too and their output must stay in order.
+file::file(FILE* f_in): f(f_in), done(!f), out(nullptr), out_size(0) {
+    if (f && f != stdin && f != stdout && f != stderr) out = new u8[FILE_BUFFER_SIZE];
 }
 
 file::~file() {
+    flush_output();
+    delete[] out;
     if (f && f != stdin && f != stdout) fclose(f);
 }
 
+void file::flush_output() {
+    if (out_size) fwrite(out, 1, out_size, f), out_size = 0;
+}
+
 void file::write(u8 c) {
-    fputc(c, f);
+    if (!out) {
+        fputc(c, f);
+        return;
+    }
+    if (out_size == FILE_BUFFER_SIZE) flush_output();
+    out[out_size ++] = c;
+}
+
+void file::write(const u8* bytes, u64 length) {
+    if (out && out_size + length <= FILE_BUFFER_SIZE) {
+        memcpy(out + out_size, bytes, length);
+        out_size += length;
+        return;
+    }
+    flush_output();
+    if (out && length < FILE_BUFFER_SIZE) memcpy(out, bytes, length), out_size = length;
+    else fwrite(bytes, 1, length, f);
 }
 
 u8 file::read() {
     if (done) return '\0';
+    flush_output();
     int i = fgetc(f);
     if (i == EOF) {
         done = true;
@@ -44,8 +88,17 @@ u8 file::read() {
     return i;
 }
 
+u64 file::read(u8* bytes, u64 length) {
+    if (done) return 0;
+    flush_output();
+    u64 n = fread(bytes, 1, length, f);
+    if (n < length) done = true;
+    return n;
+}
+
 u8 file::peek() const {
     if (done) return '\0';
+    const_cast<file*>(this)->flush_output();
     int i = fgetc(f);
     ungetc(i, f);
     if (i == EOF) return '\0';
@@ -53,12 +106,19 @@ u8 file::peek() const {
 }
 
 void file::unget(u8 c) {
+    flush_output();
     ungetc(c, f);
 }
 
+void file::flush() {
+    flush_output();
+    if (f) fflush(f);
+}
+
 file::operator bool() {
 	if (!f) return false;
     if (done) return false;
+    flush_output();
     int i = fgetc(f);
     ungetc(i, f);
     if (i == EOF) done = true;
@@ -91,6 +151,10 @@ void buffer::grow() {
     if (oldcap > 8) delete[] old;
 }
 
+void buffer::reserve(u32 length) {
+    while (size() + length >= _capacity) grow();
+}
+
 buffer::buffer() {
     init(8);
 }
@@ -131,6 +195,26 @@ u8 buffer::peek() const {
     return data[_start];
 }
 
+void buffer::write(const u8* bytes, u64 length) {
+    reserve(length);
+    u32 first = _capacity - _end;
+    if (first > length) first = length;
+    memcpy(data + _end, bytes, first);
+    memcpy(data, bytes + first, length - first);
+    _end = (_end + length) & (_capacity - 1);
+}
+
+u64 buffer::read(u8* bytes, u64 length) {
+    u32 n = size();
+    if (n > length) n = length;
+    u32 first = _capacity - _start;
+    if (first > n) first = n;
+    memcpy(bytes, data + _start, first);
+    memcpy(bytes + first, data, n - first);
+    _start = (_start + n) & (_capacity - 1);
+    return n;
+}
+
 void buffer::unget(u8 c) {
     _start = (_start - 1) & (_capacity - 1);
     while (_start == _end) grow(), _start = (_start - 1) & (_capacity - 1);
@@ -176,21 +260,44 @@ void setprecision(u32 p) {
     precision = p;
 }
 
+static const char DIGIT_PAIRS[201] =
+    "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+    "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+// Formats n in decimal so that it ends just before 'end', two digits at a
+// time, and returns a pointer to the first digit.
+static u8* format_unsigned(u8* end, u64 n) {
+    while (n >= 100) {
+        const char* pair = DIGIT_PAIRS + n % 100 * 2;
+        *-- end = pair[1], *-- end = pair[0];
+        n /= 100;
+    }
+    if (n >= 10) *-- end = DIGIT_PAIRS[n * 2 + 1], *-- end = DIGIT_PAIRS[n * 2];
+    else *-- end = '0' + n;
+    return end;
+}
+
 static void print_unsigned(stream& io, u64 n) {
-    u64 m = n, p = 1;
-    while (m / 10) m /= 10, p *= 10;
-    while (p) io.write('0' + (n / p % 10)), p /= 10;
+    u8 digits[20];
+    u8* start = format_unsigned(digits + 20, n);
+    io.write(start, digits + 20 - start);
 }
 
 static void print_signed(stream& io, i64 n) {
-    if (n < 0) io.write('-'), n = -n;
-    print_unsigned(io, n);
+    u8 digits[21];
+    u8* start = format_unsigned(digits + 21, n < 0 ? 0 - u64(n) : u64(n));
+    if (n < 0) *-- start = '-';
+    io.write(start, digits + 21 - start);
 }
 
 static void print_rational(stream& io, double d) {
-    if (d < 0) io.write('-'), d = -d;
-    print_unsigned(io, u64(d));
-    io.write('.');
+    u8 digits[64];
+    u32 n = 0;
+    if (d < 0) digits[n ++] = '-', d = -d;
+    u8* start = format_unsigned(digits + 21, u64(d));
+    while (start != digits + 21) digits[n ++] = *start ++;
+    digits[n ++] = '.';
     double r = d - u64(d);
     u32 p = precision, zeroes = 0;
     bool isZero = r == 0;
@@ -198,14 +305,19 @@ static void print_rational(stream& io, double d) {
         r *= 10;
         if (u8(r)) {
             isZero = false;
-            while (zeroes) io.write('0'), -- zeroes;
-            io.write('0' + u8(r));
+            while (zeroes) {
+                if (n == sizeof(digits)) io.write(digits, n), n = 0;
+                digits[n ++] = '0', -- zeroes;
+            }
+            if (n == sizeof(digits)) io.write(digits, n), n = 0;
+            digits[n ++] = '0' + u8(r);
         }
         else ++ zeroes;
         r -= u8(r);
         -- p;
     }
-    if (isZero) io.write('0');
+    if (isZero) digits[n ++] = '0';
+    io.write(digits, n);
 }
 
 void write(stream& io) {}
@@ -259,15 +371,19 @@ void write(stream& io, bool b) {
 }
 
 void write(stream& io, const u8* s) {
-    while (*s) io.write(*(s ++));
+    io.write(s, strlen((const char*)s));
 }
 
 void write(stream& io, const char* s) {
-    while (*s) io.write(*(s ++));
+    io.write((const u8*)s, strlen(s));
 }
 
 void write(stream& io, const buffer& b) {
-    for (u8 c : b) io.write(c);
+    if (b._start <= b._end) io.write(b.data + b._start, b._end - b._start);
+    else {
+        io.write(b.data + b._start, b._capacity - b._start);
+        io.write(b.data, b._end);
+    }
 }
 
 bool isspace(u8 c) {
@@ -20,6 +20,12 @@ public:
     virtual u8 peek() const = 0;
     virtual void unget(u8 c) = 0;
     virtual operator bool() = 0;
+
+    // Bulk operations. By default these go through the per-byte methods
+    // above; streams override them when they can move many bytes at once.
+    virtual void write(const u8* bytes, u64 length);
+    virtual u64 read(u8* bytes, u64 length);
+    virtual void flush();
 };
 
 bool exists(const char* path);
@@ -27,6 +33,10 @@ bool exists(const char* path);
 class file : public stream {
     FILE* f;
     bool done;
+    u8* out; // pending output, only for files other than the standard streams
+    u32 out_size;
+
+    void flush_output();
 public:
     file(const char* fname, const char* flags);
     file(FILE* f_in);
@@ -39,6 +49,9 @@ public:
     u8 peek() const override;
     void unget(u8 c) override;
     operator bool() override;
+    void write(const u8* bytes, u64 length) override;
+    u64 read(u8* bytes, u64 length) override;
+    void flush() override;
 };
 
 class buffer : public stream {
@@ -50,6 +63,8 @@ class buffer : public stream {
     void free();
     void copy(u8* other, u32 size, u32 start, u32 end);
     void grow();
+    void reserve(u32 length);
+    friend void write(stream& io, const buffer& b);
 public:
     buffer();
     ~buffer();
@@ -60,6 +75,8 @@ public:
     u8 read() override;
     u8 peek() const override;
     void unget(u8 c) override;
+    void write(const u8* bytes, u64 length) override;
+    u64 read(u8* bytes, u64 length) override;
     u32 size() const;
     u32 capacity() const;
     operator bool() override;
@@ -13,26 +13,57 @@
 #include "defs.h"
 #include "io.h"
 #include "panic.h"
+#include "arena.h"
+
+// Specialize this to true for types whose refcells may be shared between threads. Their
+// counts are updated atomically, and they are never allocated from regions. A type and
+// any types its refcells are converted to must agree on this.
+template<typename T>
+struct rc_shared {
+  static constexpr const bool value = false;
+};
+
+// Returns the allocation statistics for refcells of type T.
+template<typename T>
+rc_stats* rc_stats_for() {
+#if defined(_MSC_VER) && !defined(__clang__)
+  static rc_stats stats = { __FUNCSIG__, sizeof(T), 0, 0, 0, false, nullptr };
+#else
+  static rc_stats stats = { __PRETTY_FUNCTION__, sizeof(T), 0, 0, 0, false, nullptr };
+#endif
+  return &stats;
+}
 
 template<typename T>
 class rc final {
   inline void inc() const {
-    if (_data) (*(u64*)_data) ++;
+    if (!_data) return;
+    if (rc_shared<T>::value) rc_atomic_add((u64*)_data, 1);
+    else ++ *(u64*)_data;
   }
 
   inline void dec() {
-    if (_data) if (!(-- *(u64*)_data)) {
+    if (!_data) return;
+    u64 count = rc_shared<T>::value ? rc_atomic_add((u64*)_data, -1) : -- *(u64*)_data;
+    if (!(count & RC_COUNT_MASK)) {
       value()->~T();
-      delete[] _data;
+      rc_free(_data);
     }
   }
 
   inline T* value() {
-    return (T*)(_data + sizeof(u64));
+    return (T*)(_data + RC_HEADER_SIZE);
   }
 
   inline const T* value() const {
-    return (const T*)(_data + sizeof(u64));
+    return (const T*)(_data + RC_HEADER_SIZE);
+  }
+
+  // Null checks are only made in debug builds.
+  inline void check() const {
+#ifndef BASIL_RELEASE
+    if (!_data) panic("Attempted to dereference null refcell!");
+#endif
   }
 
 public:
@@ -43,8 +74,11 @@ public:
   rc(Copy copy): _data(copy.ptr) { inc(); }
   rc(): _data(nullptr) {}
 
-  rc(const T& t): _data(new uint8_t[sizeof(u64) + sizeof(T)]) {
-    *(u64*)_data = 1;
+  rc(const T& t): _data(rc_alloc(sizeof(T), rc_shared<T>::value)) {
+    static_assert(alignof(T) <= RC_HEADER_SIZE, "Refcell values must fit the header's alignment!");
+#ifdef BASIL_RC_STATS
+    rc_track(_data, rc_stats_for<T>());
+#endif
     new(value()) T(t); // copy value into place
   }
 
@@ -79,26 +113,22 @@ public:
   }
 
   const T& operator*() const {
-    if (!_data) panic("Attempted to dereference null refcell!");
+    check();
     return *value();
   }
 
   T& operator*() {
-    if (!_data) panic("Attempted to dereference null refcell!");
+    check();
     return *value();
   }
 
   const T* operator->() const {
-    if (!_data) {
-      panic("Attempted to dereference null refcell!");
-    }
+    check();
     return value();
   }
 
   T* operator->() {
-    if (!_data) {
-      panic("Attempted to dereference null refcell!");
-    }
+    check();
     return value();
   }
 
@@ -117,15 +147,17 @@ public:
   }
 
   u64 count() const {
-    return _data ? *(u64*)_data : 0;
+    return _data ? *(u64*)_data & RC_COUNT_MASK : 0;
   }
 
   void manual_inc() {
-    if (_data) ++ *(u64*)_data;
+    inc();
   }
 
   void manual_dec() {
-    if (_data) -- *(u64*)_data;
+    if (!_data) return;
+    if (rc_shared<T>::value) rc_atomic_add((u64*)_data, -1);
+    else -- *(u64*)_data;
   }
 
   const T* raw() const {
@@ -135,6 +167,7 @@ public:
 
   template<typename U>
   operator rc<U>() const {
+    static_assert(rc_shared<T>::value == rc_shared<U>::value, "Can't share refcells between atomic and non-atomic types!");
     return rc<U>(typename rc<U>::Copy{_data});
   }
 };
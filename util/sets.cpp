@@ -12,6 +12,38 @@
 #include "panic.h"
 #include "string.h"
 
+#if defined(_MSC_VER) && !defined(__clang__)
+    #include "intrin.h"
+#endif
+
+static u32 popcount64(u64 w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(w);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    return __popcnt64(w);
+#else
+    w = w - ((w >> 1) & 0x5555555555555555ull);
+    w = (w & 0x3333333333333333ull) + ((w >> 2) & 0x3333333333333333ull);
+    w = (w + (w >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (w * 0x0101010101010101ull) >> 56;
+#endif
+}
+
+// Index of the lowest set bit. w must be nonzero.
+static u32 ctz64(u64 w) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(w);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, w);
+    return i;
+#else
+    u32 i = 0;
+    while (!(w & 1)) w >>= 1, i ++;
+    return i;
+#endif
+}
+
 void bitset::grow(u32 n) {
     u64 new_capacity = n;
     new_capacity += 64; // round up to nearest 64
@@ -19,8 +51,8 @@ void bitset::grow(u32 n) {
     new_capacity *= 64;
     u64* old_data = data;
     data = new u64[new_capacity / 64];
-    for (u32 i = 0; i < new_capacity / 64; i ++) data[i] = 0;
-    for (u32 i = 0; i < size / 64; i ++) data[i] = old_data[i];
+    memcpy(data, old_data, size / 8);
+    memset(data + size / 64, 0, (new_capacity - size) / 8);
     if (old_data != &local) delete[] old_data;
     size = new_capacity;
 }
@@ -34,7 +66,7 @@ bitset::~bitset() {
 bitset::bitset(const bitset& other): size(other.size) {
     if (size > 64) {
         data = new u64[other.size / 64];
-        for (u32 i = 0; i < size; i += 64) data[i / 64] = other.data[i / 64];
+        memcpy(data, other.data, size / 8);
     }
     else local = other.local, data = &local;
 }
@@ -45,7 +77,7 @@ bitset& bitset::operator=(const bitset& other) {
         size = other.size;
         if (size > 64) {
             data = new u64[other.size / 64];
-            for (u32 i = 0; i < size; i += 64) data[i / 64] = other.data[i / 64];
+            memcpy(data, other.data, size / 8);
         }
         else local = other.local, data = &local;
     }
@@ -55,69 +87,88 @@ bitset& bitset::operator=(const bitset& other) {
 bool bitset::contains(u32 n) const {
     if (n >= size) return false;
     u64 block = data[n / 64];
-    return block & (1ul << n % 64);
+    return block & (1ull << n % 64);
 }
 
 bool bitset::insert(u32 n) {
     if (n >= size) grow(n);
     u64& block = data[n / 64];
-    bool set = block & (1ul << n % 64);
-    block |= (1ul << n % 64);
+    bool set = block & (1ull << n % 64);
+    block |= (1ull << n % 64);
     return !set;
 }
 
 bool bitset::erase(u32 n) {
-    if (n >= size) grow(n);
+    if (n >= size) return false;
     u64& block = data[n / 64];
-    bool set = block & (1ul << n % 64);
-    block &= ~(1ul << n % 64);
+    bool set = block & (1ull << n % 64);
+    block &= ~(1ull << n % 64);
     return set;
 }
 
 void bitset::clear() {
-    for (u32 i = 0; i < size / 64; i ++) data[i] = 0;
+    memset(data, 0, size / 8);
+}
+
+u32 bitset::count() const {
+    u32 n = 0;
+    for (u32 i = 0; i < size / 64; i ++) n += popcount64(data[i]);
+    return n;
 }
 
+bool bitset::empty() const {
+    for (u32 i = 0; i < size / 64; i ++) if (data[i]) return false;
+    return true;
+}
+
+// The loops below accumulate changed bits rather than branching on each
+// word, so the compiler is free to vectorize them.
+
 bool bitset::operator|=(const bitset& other) {
-    bool changed = false;
-    if (size < other.size) grow(other.size), changed = true;
-    for (u32 i = 0; i < other.size / 64; i ++) 
-        changed = (data[i] |= other.data[i]) != data[i] || changed;
+    if (size < other.size) grow(other.size - 1);
+    u64 changed = 0;
+    for (u32 i = 0; i < other.size / 64; i ++) {
+        u64 word = data[i] | other.data[i];
+        changed |= word ^ data[i];
+        data[i] = word;
+    }
     return changed;
 }
 
 bool bitset::operator&=(const bitset& other) {
-    bool changed = false;
-    for (u32 i = 0; i < size / 64; i ++) 
-        if (i * 64 >= other.size) data[i] = 0, changed = true;
-        else changed = (data[i] &= other.data[i]) != data[i] || changed;
+    u32 n = size < other.size ? size / 64 : other.size / 64;
+    u64 changed = 0;
+    for (u32 i = 0; i < n; i ++) {
+        u64 word = data[i] & other.data[i];
+        changed |= word ^ data[i];
+        data[i] = word;
+    }
+    for (u32 i = n; i < size / 64; i ++) changed |= data[i], data[i] = 0;
     return changed;
 }
 
-bool bitset::operator==(const bitset& other) {
-    u32 i = 0, j = 0;
-    for (; i < size / 64; i ++) 
-        if (i * 64 >= size || j * 64 >= other.size) break;
-        else if (data[i] != other.data[i]) return false;
+bool bitset::operator-=(const bitset& other) {
+    u32 n = size < other.size ? size / 64 : other.size / 64;
+    u64 changed = 0;
+    for (u32 i = 0; i < n; i ++) {
+        changed |= data[i] & other.data[i];
+        data[i] &= ~other.data[i];
+    }
+    return changed;
+}
 
-    u64* larger = size > other.size ? data : other.data;
-    u32 larger_size = size > other.size ? size : other.size;
-    for (; i < larger_size / 64; i ++) if (larger[i]) return false;
+bool bitset::operator==(const bitset& other) const {
+    u32 n = size < other.size ? size / 64 : other.size / 64;
+    for (u32 i = 0; i < n; i ++) if (data[i] != other.data[i]) return false;
 
+    // any words past the end of the smaller set must be empty
+    const bitset& larger = size > other.size ? *this : other;
+    for (u32 i = n; i < larger.size / 64; i ++) if (larger.data[i]) return false;
     return true;
 }
 
-bool bitset::operator!=(const bitset& other) {
-    u32 i = 0, j = 0;
-    for (; i < size / 64; i ++) 
-        if (i * 64 >= size || j * 64 >= other.size) break;
-        else if (data[i] != other.data[i]) return true;
-
-    u64* larger = size > other.size ? data : other.data;
-    u32 larger_size = size > other.size ? size : other.size;
-    for (; i < larger_size / 64; i ++) if (larger[i]) return true;
-    
-    return false;
+bool bitset::operator!=(const bitset& other) const {
+    return !(*this == other);
 }
 
 bitset::const_iterator::const_iterator(const bitset& b_in, u32 i_in): b(b_in), i(i_in) {}
@@ -141,13 +192,12 @@ bitset::const_iterator& bitset::const_iterator::operator--() {
 }
 
 bitset::const_iterator& bitset::const_iterator::operator++() {
-    u64 mask = -2ul << i;
-    for (u64 j = (i + 1) / 64; j < b.size / 64; j ++) {
-        u64 block = b.data[j];
-        if (j == i / 64) block &= mask; // clear bits at or below i
+    u32 j = (i + 1) / 64;
+    if (j < b.size / 64) {
+        u64 block = b.data[j] & (~0ull << (i + 1) % 64); // clear bits at or below i
+        while (!block && ++ j < b.size / 64) block = b.data[j];
         if (block) {
-            int r = ffsll(block);
-            i = j * 64 + r - 1;
+            i = j * 64 + ctz64(block);
             return *this;
         }
     }
@@ -161,4 +211,4 @@ bitset::const_iterator bitset::begin() const {
 
 bitset::const_iterator bitset::end() const {
     return const_iterator(*this, size);
-}
\ No newline at end of file
+}
@@ -13,7 +13,8 @@
 #include "util/defs.h"
 #include "util/hash.h"
 
-// Dynamically-sized bitset data structure.
+// Dynamically-sized bitset data structure. Set operations work a whole 64-bit word at a
+// time, and iteration skips directly between set bits.
 struct bitset {
     u64* data;
     u64 local;
@@ -32,11 +33,16 @@ public:
     bool insert(u32 n);
     bool erase(u32 n);
     void clear();
+    u32 count() const;
+    bool empty() const;
 
+    // Union, intersection, and difference in place. Each returns whether
+    // this set changed, for use in fixpoint iterations.
     bool operator|=(const bitset& other);
     bool operator&=(const bitset& other);
-    bool operator==(const bitset& other);
-    bool operator!=(const bitset& other);
+    bool operator-=(const bitset& other);
+    bool operator==(const bitset& other) const;
+    bool operator!=(const bitset& other) const;
 
     struct const_iterator {
         const bitset& b;
@@ -11,6 +11,7 @@
 #include "slice.h"
 #include "io.h"
 #include "panic.h"
+#include "string.h"
 
 void string::free() {
     if (_capacity > 16) delete[] data;
@@ -31,6 +32,13 @@ void string::copy(const u8* s) {
     *dptr = '\0';
 }
 
+void string::steal(string& other) {
+    _size = other._size, _capacity = other._capacity;
+    if (other.data == other.buf) data = buf, memcpy(buf, other.buf, _size + 1);
+    else data = other.data;
+    other.init(16); // leave other empty, and prevent it freeing our data
+}
+
 void string::grow() {
     u8* old = data;
     init(_capacity * 2);
@@ -63,9 +71,8 @@ string::string(const string& other) {
     copy(other.data);
 }
 
-string::string(string&& other): 
-    data(other.data), _size(other._size), _capacity(other._capacity) {
-    other._capacity = 0; // prevent destructor
+string::string(string&& other) {
+    steal(other);
 }
 
 string::string(const char* s): string() {
@@ -92,10 +99,7 @@ string& string::operator=(const string& other) {
 string& string::operator=(string&& other) {
     if (this != &other) {
         free();
-        _size = other._size;
-        _capacity = other._capacity;
-        data = other.data;
-        other._capacity = 0; // prevent destructor
+        steal(other);
     }
     return *this;
 }
@@ -300,9 +304,9 @@ void read(stream& io, string& s) {
 }
 
 void write(stream& io, const const_slice<u8>& str) {
-    for (u8 c : str) io.write(c);
+    io.write(str.begin(), str.size());
 }
 
 void write(stream& io, const slice<u8>& str) {
-    for (u8 c : str) io.write(c);
+    io.write(str.begin(), str.size());
 }
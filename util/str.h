@@ -20,6 +20,7 @@ class string {
     void free();
     void init(u32 size);
     void copy(const u8* s);
+    void steal(string& other);
     void grow();
     i32 cmp(const u8* s) const;
     i32 cmp(const char* s) const;
@@ -12,6 +12,7 @@
 #include "str.h"
 #include "io.h"
 #include "hash.h"
+#include "string.h"
 
 void ustring::free() {
     if (_capacity > 12) delete[] data;
@@ -28,9 +29,10 @@ void ustring::init(u32 size) {
 
 void ustring::copy_raw(const u8* s, u32 n) {
     u8* dptr = data;
-    while (*s && n) {
+    while (n) { // copies exactly n bytes, even past a null byte
         const u8* next = (const u8*)utf8_forward((const char*)s);
         if (unicode_error()) panic("UTF-8 encoding error!");
+        if (next > s + n) next = s + n; // don't run past a truncated character
         while (s != next) *(dptr ++) = *(s ++), ++ _size, -- n;
         _count ++;
     }
@@ -38,10 +40,16 @@ void ustring::copy_raw(const u8* s, u32 n) {
 }
 
 void ustring::copy(const u8* s, u32 count, u32 n) {
-    _count = count;
-    u8* dptr = data;
-    while (*s && n) *(dptr ++) = *(s ++), ++ _size, -- n;
-    *dptr = '\0';
+    _count = count, _size = n; // copies exactly n bytes, even past a null byte
+    memcpy(data, s, n);
+    data[n] = '\0';
+}
+
+void ustring::steal(ustring& other) {
+    _size = other._size, _count = other._count, _capacity = other._capacity;
+    if (other.data == other.buf) data = buf, memcpy(buf, other.buf, _size + 1);
+    else data = other.data;
+    other.init(12); // leave other empty, and prevent it freeing our data
 }
 
 void ustring::grow() {
@@ -53,12 +61,10 @@ void ustring::grow() {
     if (_capacity / 2 > 12) delete[] old;
 }
 
-i32 ustring::cmp(const u8* s) const {
-    u8* dptr = data;
-    while (*s && *s == *dptr) {
-        ++ s, ++ dptr;
-    }
-    return i32(*dptr) - i32(*s);
+i32 ustring::cmp(const u8* s, u32 n) const {
+    i32 diff = memcmp(data, s, _size < n ? _size : n);
+    if (diff) return diff;
+    return _size < n ? -1 : _size > n ? 1 : 0; // a prefix comes first
 }
 
 ustring::ustring() {
@@ -75,7 +81,7 @@ ustring::ustring(const char* cstr): ustring() {
 
 ustring::ustring(const const_slice<u8>& range) {
     init(range.size() + 1);
-    copy_raw(&range.front(), range.size());
+    copy_raw(range.begin(), range.size());
 }
 
 ustring::ustring(const string& str) {
@@ -92,9 +98,8 @@ ustring::ustring(const ustring& other) {
     copy(other.data, other._count, other._size);
 }
 
-ustring::ustring(ustring&& other):
-    data(other.data), _size(other._size), _count(other._count), _capacity(other._capacity) {
-    other._capacity = 0; // prevent destructor
+ustring::ustring(ustring&& other) {
+    steal(other);
 }
 
 ustring& ustring::operator=(const ustring& other) {
@@ -109,11 +114,7 @@ ustring& ustring::operator=(const ustring& other) {
 ustring& ustring::operator=(ustring&& other) {
     if (this != &other) {
         free();
-        _size = other._size;
-        _count = other._count;
-        _capacity = other._capacity;
-        data = other.data;
-        other._capacity = 0; // prevent destructor
+        steal(other);
     }
     return *this;
 }
@@ -156,16 +157,12 @@ ustring& ustring::operator+=(const char* cstr) {
 }
 
 ustring& ustring::operator+=(const ustring& other) {
-    u32 size = 0;
-    const u8* sptr = other.data;
-    while (*sptr) ++ size, ++ sptr;
+    u32 size = other._size;
     while (_size + size + 1 >= _capacity) grow();
-    u8* dptr = data + _size;
-    sptr = other.data;
-    while (*sptr) *(dptr ++) = *(sptr ++);
-    *dptr = '\0';
-    _count += other.size();
+    memmove(data + _size, other.data, size); // other may be this string
+    _count += other._count;
     _size += size;
+    data[_size] = '\0';
     return *this;
 }
 
@@ -254,51 +251,51 @@ const char* ustring::raw() const {
 }
 
 bool ustring::operator==(const char* s) const {
-    return cmp((const u8*)s) == 0;
+    return cmp((const u8*)s, strlen(s)) == 0;
 }
 
 bool ustring::operator==(const ustring& s) const {
-    return cmp((const u8*)s.raw()) == 0;
+    return cmp(s.data, s._size) == 0;
 }
 
 bool ustring::operator<(const char* s) const {
-    return cmp((const u8*)s) < 0;
+    return cmp((const u8*)s, strlen(s)) < 0;
 }
 
 bool ustring::operator<(const ustring& s) const {
-    return cmp((const u8*)s.raw()) < 0;
+    return cmp(s.data, s._size) < 0;
 }
 
 bool ustring::operator>(const char* s) const {
-    return cmp((const u8*)s) > 0;
+    return cmp((const u8*)s, strlen(s)) > 0;
 }
 
 bool ustring::operator>(const ustring& s) const {
-    return cmp((const u8*)s.raw()) > 0;
+    return cmp(s.data, s._size) > 0;
 }
 
 bool ustring::operator!=(const char* s) const {
-    return cmp((const u8*)s) != 0;
+    return cmp((const u8*)s, strlen(s)) != 0;
 }
 
 bool ustring::operator!=(const ustring& s) const {
-    return cmp((const u8*)s.raw()) != 0;
+    return cmp(s.data, s._size) != 0;
 }
 
 bool ustring::operator<=(const char* s) const {
-    return cmp((const u8*)s) <= 0;
+    return cmp((const u8*)s, strlen(s)) <= 0;
 }
 
 bool ustring::operator<=(const ustring& s) const {
-    return cmp((const u8*)s.raw()) <= 0;
+    return cmp(s.data, s._size) <= 0;
 }
 
 bool ustring::operator>=(const char* s) const {
-    return cmp((const u8*)s) >= 0;
+    return cmp((const u8*)s, strlen(s)) >= 0;
 }
 
 bool ustring::operator>=(const ustring& s) const {
-    return cmp((const u8*)s.raw()) >= 0;
+    return cmp(s.data, s._size) >= 0;
 }
 
 ustring operator+(ustring s, char c) {
@@ -25,8 +25,9 @@ class ustring {
     void init(u32 size);
     void copy_raw(const u8* s, u32 n);
     void copy(const u8* s, u32 count, u32 n);
+    void steal(ustring& other);
     void grow();
-    i32 cmp(const u8* s) const;
+    i32 cmp(const u8* s, u32 n) const;
 public:
     ustring();
     ~ustring();
@@ -12,6 +12,7 @@
 
 #include "defs.h"
 #include "slice.h"
+#include "string.h"
 
 template<typename T, u32 N>
 class vector {
@@ -56,12 +57,43 @@ class vector {
         tptr[i].~T();
     }
 
-    void grow() {
+    // Moves n elements from src into uninitialized storage at dst, leaving
+    // src uninitialized. Trivially copyable types are moved as raw bytes.
+    static void relocate(T* dst, T* src, u32 n) {
+        if (__is_trivially_copyable(T)) {
+            if (n) memcpy((void*)dst, (const void*)src, n * sizeof(T));
+        }
+        else for (u32 i = 0; i < n; i ++) {
+            new(dst + i) T(static_cast<T&&>(src[i]));
+            src[i].~T();
+        }
+    }
+
+    // Takes ownership of other's elements, leaving it empty.
+    void steal(vector& other) {
+        _size = other._size, _capacity = other._capacity;
+        if (other.data == other.fixed) {
+            data = fixed;
+            relocate((T*)data, (T*)other.data, _size);
+        }
+        else data = other.data;
+        other.data = other.fixed, other._size = 0, other._capacity = N;
+    }
+
+    // Moves all elements into a new buffer of the given capacity.
+    void reallocate(u32 capacity) {
         u8* old = data;
-        u32 oldsize = _size;
-        init(_capacity * 2);
-        copy((const T*)old, oldsize);
-        if (old != fixed) free(old);
+        u8* array = capacity <= N ? fixed : new u8[capacity * sizeof(T)];
+        if (array == old) return;
+        relocate((T*)array, (T*)old, _size);
+        if (old != fixed) delete[] old;
+        data = array, _capacity = capacity;
+    }
+
+    u32 next_capacity(u32 needed) const {
+        u32 capacity = _capacity ? _capacity : 8;
+        while (capacity < needed) capacity *= 2;
+        return capacity;
     }
 
 public:
@@ -82,12 +114,8 @@ public:
         copy((const T*)other.data, other._size);
     }
 
-    vector(vector&& other): data(other.data), _size(other._size), _capacity(other._capacity) {
-        if (other.data == other.fixed) {
-            data = fixed;
-            copy((const T*)other.data, _size);
-        }
-        other.data = nullptr;
+    vector(vector&& other) {
+        steal(other);
     }
 
     vector& operator=(const vector& other) {
@@ -102,20 +130,44 @@ public:
     vector& operator=(vector&& other) {
         if (this != &other) {
             free(data);
-            data = other.data;
-            _size = other._size;
-            _capacity = other._capacity;
-            if (other.data == other.fixed) data = fixed, copy((const T*)other.data, _size);
-            other.data = nullptr;
+            steal(other);
         }
         return *this;
     }
 
-    void push(const T& t) {
-        while (_size + 1 >= _capacity) grow();
-        T* tptr = (T*)data;
-        new(tptr + _size) T(t);
+    // Ensures room for at least n elements without further allocation.
+    void reserve(u32 n) {
+        if (n > _capacity) reallocate(next_capacity(n));
+    }
+
+    // Constructs a new element in place at the end of the vector. When the
+    // vector is full, the element is built in the new buffer before the old
+    // elements are moved, so arguments may refer to elements of this vector.
+    template<typename ...Args>
+    T& emplace(Args&&... args) {
+        if (_size < _capacity) {
+            T* slot = (T*)data + _size;
+            new(slot) T(static_cast<Args&&>(args)...);
+            ++ _size;
+            return *slot;
+        }
+        u32 capacity = next_capacity(_size + 1);
+        u8* array = capacity <= N ? fixed : new u8[capacity * sizeof(T)];
+        T* slot = (T*)array + _size;
+        new(slot) T(static_cast<Args&&>(args)...);
+        relocate((T*)array, (T*)data, _size);
+        if (data != fixed) delete[] data;
+        data = array, _capacity = capacity;
         ++ _size;
+        return *slot;
+    }
+
+    void push(const T& t) {
+        emplace(t);
+    }
+
+    void push(T&& t) {
+        emplace(static_cast<T&&>(t));
     }
     
     void pop() {